@@ -0,0 +1,85 @@
+// Whole-model operations per parameter tensor against one pass over the
+// flat ParameterArena, on a deep MLP with many small tensors (784 -> DEPTH x
+// WIDTH -> 10). "per tensor" loops over Parameters()/Gradients() as the code
+// had to before the arena; "flat" runs over FlatParameters() and
+// FlatGradients(). The all-reduce sums the gradients of REPLICAS models.
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "Optimizer.hpp"
+#include "Sequential.hpp"
+#include "Threading/Collectives.hpp"
+
+namespace Bench = Logos::Bench;
+namespace NN = Logos::NeuralNet;
+namespace Threading = Logos::Threading;
+
+namespace {
+constexpr std::size_t DEPTH = 32, WIDTH = 64, REPLICAS = 4, REPS = 50;
+
+void report(const char *name, double per_tensor, double flat) {
+  std::printf("  %-12s %12.1f %10.1f %8.2fx\n", name, per_tensor * 1e6,
+              flat * 1e6, per_tensor / flat);
+}
+} // namespace
+
+int main() {
+  std::mt19937 rng(19);
+  NN::Sequential<float> model(784);
+  for (std::size_t i = 0; i < DEPTH; i++)
+    model.AddLinear(WIDTH, rng).AddReLU();
+  model.AddLinear(10, rng).Build();
+
+  std::vector<std::unique_ptr<NN::Sequential<float>>> replicas;
+  for (std::size_t k = 0; k < REPLICAS; k++)
+    replicas.push_back(model.Replica());
+
+  const auto params = model.Parameters(), grads = model.Gradients();
+  std::size_t n = 0;
+  for (const auto p : params)
+    n += p.size();
+  std::printf("%zu tensors, %zu parameters, arena %zu floats\n",
+              params.size(), n, model.FlatParameters().size());
+  std::printf("  %-12s %12s %10s %9s\n", "operation", "per tensor us",
+              "flat us", "speedup");
+
+  const double zero_tensor = Bench::best_of(REPS, [&] {
+    for (const auto g : grads)
+      std::fill(g.begin(), g.end(), 0.0f);
+  });
+  const double zero_flat = Bench::best_of(REPS, [&] { model.ZeroGrads(); });
+  report("zero grads", zero_tensor, zero_flat);
+
+  NN::OptimizerOptions options;
+  options.kind = NN::OptimizerKind::Momentum;
+  NN::Optimizer scattered(params, grads, options);
+  NN::Optimizer flat({model.FlatParameters()}, {model.FlatGradients()},
+                     options);
+  const double step_tensor =
+      Bench::best_of(REPS, [&] { scattered.Step(1e-3); });
+  const double step_flat = Bench::best_of(REPS, [&] { flat.Step(1e-3); });
+  report("momentum", step_tensor, step_flat);
+
+  std::vector<std::vector<std::span<float>>> per_replica;
+  std::vector<float *> flat_ptrs;
+  for (auto &r : replicas) {
+    per_replica.push_back(r->Gradients());
+    flat_ptrs.push_back(r->FlatGradients().data());
+  }
+  const double reduce_tensor = Bench::best_of(REPS, [&] {
+    std::vector<float *> ptrs(REPLICAS);
+    for (std::size_t t = 0; t < params.size(); t++) {
+      for (std::size_t k = 0; k < REPLICAS; k++)
+        ptrs[k] = per_replica[k][t].data();
+      Threading::TreeReduce(ptrs, params[t].size());
+    }
+  });
+  const std::size_t flat_size = model.FlatGradients().size();
+  const double reduce_flat = Bench::best_of(
+      REPS, [&] { Threading::TreeReduce(flat_ptrs, flat_size); });
+  report("all-reduce", reduce_tensor, reduce_flat);
+}
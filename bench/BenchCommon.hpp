@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Matrix.inl"
+
+namespace Logos::Bench {
+
+using Clock = std::chrono::steady_clock;
+
+// Best wall time in seconds over `reps` runs of fn, after one warm-up run.
+template <class Fn> inline double best_of(std::size_t reps, Fn &&fn) {
+  fn();
+  double best = 1e30;
+  for (std::size_t r = 0; r < reps; r++) {
+    const auto t0 = Clock::now();
+    fn();
+    const std::chrono::duration<double> dt = Clock::now() - t0;
+    best = std::min(best, dt.count());
+  }
+  return best;
+}
+
+// Enough repetitions to keep each measurement around a fixed flop budget.
+inline std::size_t reps_for(double flops, double budget = 2e9) {
+  return std::clamp<std::size_t>(static_cast<std::size_t>(budget / flops), 3,
+                                 200);
+}
+
+inline void fill_random(linalg::Matrix<float> &A, std::mt19937 &rng) {
+  std::uniform_real_distribution<float> ud(-1.0f, 1.0f);
+  auto X = A.data();
+  for (std::size_t i = 0; i < A.size(); i++)
+    X[i] = ud(rng);
+}
+
+inline float max_abs_diff(const linalg::Matrix<float> &A,
+                          const linalg::Matrix<float> &B) {
+  float diff = 0.0f;
+  for (std::size_t i = 0; i < A.size(); i++)
+    diff = std::max(diff, std::abs(A.data()[i] - B.data()[i]));
+  return diff;
+}
+// 1, 2, 4, ... up to LOGOS_NUM_THREADS or the hardware thread count.
+inline std::vector<std::size_t> thread_counts() {
+  std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  if (const char *env = std::getenv("LOGOS_NUM_THREADS"))
+    hw = std::max<std::size_t>(1, std::strtoul(env, nullptr, 10));
+
+  std::vector<std::size_t> counts;
+  for (std::size_t t = 1; t < hw; t *= 2)
+    counts.push_back(t);
+  counts.push_back(hw);
+  return counts;
+}
+} // namespace Logos::Bench
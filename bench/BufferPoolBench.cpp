@@ -0,0 +1,129 @@
+// Memory::Buffer allocation cost with the system allocator against the
+// size-class BufferPool: reshaping matrices as batch shapes change, mixed
+// sizes from several threads, and large blocks that must be faulted in when
+// they come fresh from the system. Ends with the pool counters after a run
+// of training steps with a partial last batch.
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "Memory/BufferPool.hpp"
+#include "NeuralNetwork.hpp"
+
+namespace Bench = Logos::Bench;
+namespace Memory = Logos::Memory;
+namespace NN = Logos::NeuralNet;
+using Logos::linalg::Matrix;
+
+namespace {
+
+constexpr std::size_t ROUNDS = 20000;
+
+struct Mode {
+  const char *name;
+  Memory::Allocator *allocator;
+};
+
+void print_stats(const char *label) {
+  const auto s = Memory::BufferPool::Global().GetStats();
+  const double lookups = static_cast<double>(s.hits + s.misses);
+  std::printf("%-22s live %8.1f KiB  peak %8.1f KiB  cached %8.1f KiB  "
+              "hits %llu  misses %llu (%.2f%% hit)\n",
+              label, s.live_bytes / 1024.0, s.peak_bytes / 1024.0,
+              s.cached_bytes / 1024.0, static_cast<unsigned long long>(s.hits),
+              static_cast<unsigned long long>(s.misses),
+              lookups > 0 ? 100.0 * s.hits / lookups : 0.0);
+}
+
+// Activation-sized matrices recreated for a cycle of batch sizes, the way
+// `out = Matrix<T>(N, M)` behaves when the final batch is short.
+double reshape_loop() {
+  static constexpr std::size_t BATCHES[] = {64, 64, 64, 37, 128, 17};
+  static constexpr std::size_t WIDTHS[] = {784, 256, 10};
+  Matrix<float> acts[3];
+  return Bench::best_of(5, [&] {
+    for (std::size_t r = 0; r < ROUNDS; r++) {
+      const std::size_t rows = BATCHES[r % std::size(BATCHES)];
+      for (std::size_t l = 0; l < 3; l++) {
+        acts[l] = Matrix<float>(rows, WIDTHS[l]);
+        acts[l].data()[0] = 1.0f;
+      }
+    }
+  });
+}
+
+// Each thread frees and reallocates a ring of mixed-size buffers.
+double threaded_churn(std::size_t threads) {
+  return Bench::best_of(3, [&] {
+    std::vector<std::thread> pool;
+    for (std::size_t t = 0; t < threads; t++)
+      pool.emplace_back([t] {
+        std::mt19937 rng(static_cast<unsigned>(t + 1));
+        std::uniform_int_distribution<std::size_t> size(64, 256 << 10);
+        std::vector<Memory::Buffer> ring(16);
+        for (std::size_t r = 0; r < ROUNDS; r++) {
+          auto &b = ring[r % ring.size()];
+          b.reset(size(rng));
+          static_cast<char *>(b.data())[0] = 1;
+        }
+      });
+    for (auto &th : pool)
+      th.join();
+  });
+}
+
+// 8 MiB blocks written end to end after every allocation.
+double large_blocks() {
+  constexpr std::size_t BYTES = std::size_t(8) << 20;
+  return Bench::best_of(3, [&] {
+    for (std::size_t r = 0; r < 32; r++) {
+      Memory::Buffer b(BYTES);
+      b.fill_zeroes();
+    }
+  });
+}
+} // namespace
+
+int main() {
+  Mode modes[] = {{"system", &Memory::SystemAllocator()},
+                  {"pool", &Memory::BufferPool::Global()}};
+  const std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+
+  for (const Mode &mode : modes) {
+    Memory::SetDefaultAllocator(*mode.allocator);
+    const double reshape = reshape_loop();
+    const double churn1 = threaded_churn(1);
+    const double churnN = threaded_churn(hw);
+    const double large = large_blocks();
+    std::printf("%-7s reshape %7.1f ns/alloc  churn x1 %7.1f ns  x%zu %7.1f "
+                "ns  8 MiB alloc+fill %7.3f ms\n",
+                mode.name, reshape / (ROUNDS * 3) * 1e9,
+                churn1 / ROUNDS * 1e9, hw, churnN / (ROUNDS * hw) * 1e9,
+                large / 32 * 1e3);
+  }
+  print_stats("after micro benches");
+
+  // Training steps over a 1000-row epoch at batch 64: fifteen full batches
+  // and a 40-row tail.
+  constexpr std::size_t IN = 784, HIDDEN = 256, CLASSES = 10, ROWS = 1000;
+  std::mt19937 rng(5);
+  Matrix<float> X(ROWS, IN);
+  Bench::fill_random(X, rng);
+  std::vector<std::uint8_t> y(ROWS);
+  for (std::size_t i = 0; i < ROWS; i++)
+    y[i] = static_cast<std::uint8_t>(i % CLASSES);
+
+  Memory::BufferPool::Global().ResetPeak();
+  auto model = NN::MakeMLP(IN, HIDDEN, CLASSES, rng);
+  for (std::size_t epoch = 0; epoch < 3; epoch++)
+    for (std::size_t start = 0; start < ROWS; start += 64) {
+      const std::size_t rows = std::min<std::size_t>(64, ROWS - start);
+      model.TrainStep(NN::ConstMatrixView(X).row_range(start, rows),
+                      NN::Labels(y).subspan(start, rows), 0.01);
+      Matrix<float> probs;
+      model.Forward(NN::ConstMatrixView(X).row_range(start, rows), probs);
+    }
+  print_stats("after 3 epochs");
+}
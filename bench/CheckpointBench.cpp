@@ -0,0 +1,126 @@
+// Peak activation memory and step time of a deep MLP trained with and
+// without activation checkpointing. The model is 784 -> DEPTH x WIDTH
+// (LinearReLU) -> 10; checkpointed runs split the hidden layers into
+// segments of SEGMENT layers, each a checkpointed LayerBlock.
+//
+// Memory is the high-water mark of live buffer pool bytes during one
+// forward + backward step, minus what was live before it (parameters,
+// gradients, GEMM packing buffers). It needs the pool, so the bench refuses
+// to run with LOGOS_BUFFER_POOL=0. "dW" is the largest difference of the
+// first layer's weight gradient against the run without checkpointing.
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "Functions.hpp"
+#include "LayerBlock.hpp"
+#include "LinearReLU.hpp"
+#include "Memory/BufferPool.hpp"
+
+namespace Bench = Logos::Bench;
+namespace NN = Logos::NeuralNet;
+namespace Memory = Logos::Memory;
+using Logos::linalg::Matrix;
+
+namespace {
+constexpr std::size_t BATCH = 256, INPUT = 784, WIDTH = 1024, DEPTH = 16,
+                      CLASSES = 10;
+
+struct Model {
+  NN::LayerBlock<float> net;
+  NN::LinearReLU<float> *first = nullptr;
+};
+
+// segment == 0: one plain block holding every layer.
+std::unique_ptr<Model> build(std::size_t segment) {
+  std::mt19937 rng(15);
+  auto model = std::make_unique<Model>();
+  NN::LayerBlock<float> *block = &model->net;
+
+  for (std::size_t l = 0; l < DEPTH; l++) {
+    if (segment && l % segment == 0)
+      block = &model->net.Emplace<NN::LayerBlock<float>>(true);
+    auto &layer = block->Emplace<NN::LinearReLU<float>>(
+        l == 0 ? INPUT : WIDTH, WIDTH, rng);
+    if (l == 0)
+      model->first = &layer;
+  }
+  model->net.Emplace<NN::Linear<float>>(WIDTH, CLASSES, rng);
+  return model;
+}
+
+struct Result {
+  double mib, ms;
+  std::vector<float> dW;
+};
+
+Result run(std::size_t segment, const Matrix<float> &X,
+           const std::vector<std::uint8_t> &labels) {
+  auto &pool = Memory::BufferPool::Global();
+  auto model = build(segment);
+  Matrix<float> logits, dLogits, dX;
+
+  auto step = [&] {
+    model->net.ZeroGrads();
+    model->net.Forward(X, logits);
+    NN::SoftmaxCrossEntropy<float>(logits, labels, dLogits);
+    model->net.Backward(dLogits, dX);
+  };
+
+  // The first step sizes every buffer, including the shared per-thread
+  // scratch, so measure it from a clean slate.
+  const std::size_t before = pool.GetStats().live_bytes;
+  pool.ResetPeak();
+  step();
+  const double mib =
+      static_cast<double>(pool.GetStats().peak_bytes - before) / (1 << 20);
+
+  const auto grad = model->first->GradWeights();
+  Result r{mib, Bench::best_of(3, step) * 1e3, {grad.begin(), grad.end()}};
+  return r;
+}
+} // namespace
+
+int main() {
+  if (&Memory::DefaultAllocator() != &Memory::BufferPool::Global()) {
+    std::printf("CheckpointBench needs the buffer pool for its memory "
+                "counters; unset LOGOS_BUFFER_POOL\n");
+    return 1;
+  }
+
+  std::mt19937 rng(15);
+  Matrix<float> X(BATCH, INPUT);
+  Bench::fill_random(X, rng);
+  std::vector<std::uint8_t> labels(BATCH);
+  for (auto &l : labels)
+    l = static_cast<std::uint8_t>(rng() % CLASSES);
+
+  // Warm the GEMM packing buffers so they count as already live.
+  {
+    Matrix<float> A(64, 64), B(64, 64), C;
+    Logos::linalg::matmul<float>(A, B, C);
+  }
+
+  const double act_mib =
+      static_cast<double>(BATCH * WIDTH * sizeof(float)) / (1 << 20);
+  std::printf("batch %zu, %zu x %zu hidden layers, one activation %.2f MiB, "
+              "ReLU mask %.3f MiB (%.2f MiB as bytes)\n",
+              BATCH, DEPTH, WIDTH, act_mib, act_mib / 32, act_mib / 4);
+  std::printf("  %-14s %12s %10s %10s\n", "checkpoint", "peak MiB", "step ms",
+              "dW");
+
+  const Result off = run(0, X, labels);
+  std::printf("  %-14s %12.2f %10.1f %10.1e\n", "off", off.mib, off.ms, 0.0);
+
+  for (const std::size_t segment : {2, 4, 8}) {
+    const Result on = run(segment, X, labels);
+    float diff = 0.0f;
+    for (std::size_t i = 0; i < on.dW.size(); i++)
+      diff = std::max(diff, std::abs(on.dW[i] - off.dW[i]));
+    char name[32];
+    std::snprintf(name, sizeof(name), "every %zu", segment);
+    std::printf("  %-14s %12.2f %10.1f %10.1e\n", name, on.mib, on.ms, diff);
+  }
+}
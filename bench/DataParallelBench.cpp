@@ -0,0 +1,128 @@
+// Checks that data-parallel training follows the single-threaded loss curve
+// for the same seed and global batch, then times one synthetic epoch with
+// 1..N replicas.
+
+#include <cmath>
+#include <cstdio>
+
+#include "BenchCommon.hpp"
+#include "NeuralNetwork.hpp"
+#include "Threading/ThreadPool.hpp"
+
+using Logos::Threading::ThreadPool;
+namespace Bench = Logos::Bench;
+namespace NN = Logos::NeuralNet;
+
+namespace {
+
+constexpr std::size_t IN = 784, HIDDEN = 256, CLASSES = 10;
+constexpr std::size_t SAMPLES = 8192, GLOBAL_BATCH = 512;
+constexpr double LR = 0.05;
+
+// Labels come from a fixed random projection so the loss actually drops.
+void make_dataset(NN::Matrix &X, std::vector<std::uint8_t> &y,
+                  std::mt19937 &rng) {
+  X = NN::Matrix(SAMPLES, IN);
+  Bench::fill_random(X, rng);
+
+  NN::Matrix P(IN, CLASSES);
+  Bench::fill_random(P, rng);
+  y.resize(SAMPLES);
+  for (std::size_t i = 0; i < SAMPLES; i++) {
+    std::size_t best = 0;
+    float bestv = -1e30f;
+    for (std::size_t c = 0; c < CLASSES; c++) {
+      float v = 0.0f;
+      for (std::size_t j = 0; j < IN; j++)
+        v += X(i, j) * P(j, c);
+      if (v > bestv)
+        bestv = v, best = c;
+    }
+    y[i] = static_cast<std::uint8_t>(best);
+  }
+}
+
+void batch(const NN::Matrix &X, const std::vector<std::uint8_t> &y,
+           std::size_t start, NN::Matrix &Xb, std::vector<std::uint8_t> &yb) {
+  const std::size_t rows = std::min(GLOBAL_BATCH, SAMPLES - start);
+  if (Xb.rows() != rows)
+    Xb = NN::Matrix(rows, IN);
+  std::copy(X.data() + start * IN, X.data() + (start + rows) * IN, Xb.data());
+  yb.assign(y.begin() + start, y.begin() + start + rows);
+}
+
+template <class Step>
+double epoch(const NN::Matrix &X, const std::vector<std::uint8_t> &y,
+             Step &&step, std::vector<double> *losses = nullptr) {
+  NN::Matrix Xb;
+  std::vector<std::uint8_t> yb;
+  double sum = 0.0;
+  std::size_t steps = 0;
+  for (std::size_t start = 0; start < SAMPLES; start += GLOBAL_BATCH) {
+    batch(X, y, start, Xb, yb);
+    const double loss = step(Xb, yb);
+    if (losses)
+      losses->push_back(loss);
+    sum += loss;
+    steps++;
+  }
+  return sum / steps;
+}
+} // namespace
+
+int main() {
+  std::mt19937 data_rng(3);
+  NN::Matrix X;
+  std::vector<std::uint8_t> y;
+  make_dataset(X, y, data_rng);
+
+  const auto counts = Bench::thread_counts();
+  const std::size_t max_threads = counts.back();
+
+  // Equivalence: same seed, same batches, serial versus K replicas.
+  {
+    const std::size_t K = std::max<std::size_t>(4, max_threads);
+    ThreadPool::ResetGlobal(max_threads);
+
+    std::mt19937 rng_a(123), rng_b(123);
+    auto serial = NN::MakeMLP(IN, HIDDEN, CLASSES, rng_a);
+    auto master = NN::MakeMLP(IN, HIDDEN, CLASSES, rng_b);
+    NN::DataParallelTrainer dp(master, K);
+
+    std::vector<double> ls, lp;
+    for (int ep = 0; ep < 2; ep++) {
+      epoch(
+          X, y,
+          [&](auto &Xb, auto &yb) { return serial.TrainStep(Xb, yb, LR); },
+          &ls);
+      epoch(
+          X, y, [&](auto &Xb, auto &yb) { return dp.TrainStep(Xb, yb, LR); },
+          &lp);
+    }
+
+    double worst = 0.0;
+    for (std::size_t i = 0; i < ls.size(); i++)
+      worst = std::max(worst, std::abs(ls[i] - lp[i]) / ls[i]);
+    std::printf("serial vs %zu replicas over %zu steps: first loss %.5f/%.5f, "
+                "last loss %.5f/%.5f, max rel diff %.2e %s\n",
+                K, ls.size(), ls.front(), lp.front(), ls.back(), lp.back(),
+                worst, worst < 1e-3 ? "(ok)" : "(MISMATCH)");
+  }
+
+  // Scaling: one epoch of the synthetic set per replica count.
+  double t1 = 0.0;
+  for (const std::size_t K : counts) {
+    ThreadPool::ResetGlobal(K);
+    std::mt19937 rng(123);
+    auto model = NN::MakeMLP(IN, HIDDEN, CLASSES, rng);
+    NN::DataParallelTrainer dp(model, K);
+
+    const double t = Bench::best_of(2, [&] {
+      epoch(X, y,
+            [&](auto &Xb, auto &yb) { return dp.TrainStep(Xb, yb, LR); });
+    });
+    if (K == 1)
+      t1 = t;
+    std::printf("replicas %3zu: epoch %.3f s  speedup %.2fx\n", K, t, t1 / t);
+  }
+}
@@ -0,0 +1,82 @@
+// Startup cost of the raw float .mat read against opening the same data as a
+// mapped .lgt tensor, plus one pass over the mapped rows (page faults
+// included) and the optional checksum verification.
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "BenchCommon.hpp"
+#include "Data/TensorFile.hpp"
+
+namespace Bench = Logos::Bench;
+namespace Data = Logos::Data;
+using Logos::linalg::Matrix;
+
+namespace {
+
+constexpr std::size_t ROWS = 60000, COLS = 784;
+
+double seconds_since(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+      .count();
+}
+
+float row_sum(const Matrix<float> &X) {
+  float s = 0.0f;
+  for (std::size_t i = 0; i < X.rows(); i++)
+    s += X(i, i % X.cols());
+  return s;
+}
+} // namespace
+
+int main() {
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto raw = (dir / "logos_dataset_bench.mat").string();
+  const auto lgt = (dir / "logos_dataset_bench.lgt").string();
+
+  {
+    std::mt19937 rng(1);
+    Matrix<float> X(ROWS, COLS);
+    Bench::fill_random(X, rng);
+    std::ofstream(raw, std::ios::binary)
+        .write(reinterpret_cast<const char *>(X.data()),
+               static_cast<std::streamsize>(X.size() * sizeof(float)));
+    Data::WriteTensor(lgt, Data::DType::F32, ROWS, COLS, X.data());
+  }
+  std::printf("dataset %zux%zu f32, %.1f MB\n", ROWS, COLS,
+              ROWS * COLS * sizeof(float) / 1e6);
+
+  {
+    const auto t0 = std::chrono::steady_clock::now();
+    Matrix<float> X(ROWS, COLS);
+    std::ifstream in(raw, std::ios::binary);
+    in.read(reinterpret_cast<char *>(X.data()),
+            static_cast<std::streamsize>(X.size() * sizeof(float)));
+    const double load = seconds_since(t0);
+    std::printf("ifstream read        load %8.3f ms  (sum %.3f)\n", load * 1e3,
+                row_sum(X));
+  }
+
+  {
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto file = Data::MappedTensor::Open(lgt);
+    const auto X = file.AsMatrix<float>();
+    const double open = seconds_since(t0);
+    const auto t1 = std::chrono::steady_clock::now();
+    const float sum = row_sum(X);
+    const double touch = seconds_since(t1);
+    std::printf("mmap open            load %8.3f ms  first pass %.3f ms  "
+                "(sum %.3f)\n",
+                open * 1e3, touch * 1e3, sum);
+
+    const auto t2 = std::chrono::steady_clock::now();
+    const bool ok = file.VerifyChecksum();
+    std::printf("checksum verify           %8.3f ms  %s\n",
+                seconds_since(t2) * 1e3, ok ? "(ok)" : "(MISMATCH)");
+  }
+
+  std::filesystem::remove(raw);
+  std::filesystem::remove(lgt);
+}
@@ -0,0 +1,76 @@
+// Linear -> ReLU forward as three passes (matmul, add_rowwise_bias,
+// ReLU::Forward) against the fused LinearReLU, whose GEMM epilogue adds the
+// bias, clamps and writes the mask before the output tile leaves registers.
+//
+// The MB columns are the activation traffic outside the GEMM itself for one
+// training step of the layer, counted from what each pass reads and writes
+// per output element:
+//   unfused  store A (4), bias read+write (8), ReLU read A, write H + mask
+//            (8.125), backward read dH + mask, write dA (8.125)  = 28.25 bytes
+//   fused    store H + mask (4.125), backward (8.125)            = 12.25 bytes
+// (the ReLU mask is one bit per element).
+// The weights and the input are the same for both and are left out.
+
+#include <cstdio>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "Kernels.hpp"
+#include "LinearReLU.hpp"
+
+namespace Bench = Logos::Bench;
+namespace NN = Logos::NeuralNet;
+namespace linalg = Logos::linalg;
+using Logos::linalg::Matrix;
+
+namespace {
+constexpr std::size_t BATCH = 256;
+constexpr double UNFUSED_BYTES = 28.25, FUSED_BYTES = 12.25;
+
+void run(std::size_t in, std::size_t hidden, std::mt19937 &rng) {
+  NN::LinearReLU<float> layer(in, hidden, rng);
+  Matrix<float> X(BATCH, in);
+  Bench::fill_random(X, rng);
+
+  // The same parameters for the unfused passes.
+  const auto W = Matrix<float>::Wrap(layer.Weights().data(), in, hidden);
+  std::vector<float> b(layer.Bias().begin(), layer.Bias().end());
+  std::uniform_real_distribution<float> ud(-0.1f, 0.1f);
+  for (float &v : b)
+    v = ud(rng);
+  std::copy(b.begin(), b.end(), layer.Bias().begin());
+
+  NN::ReLU<float> relu;
+  Matrix<float> A(BATCH, hidden), H_unfused(BATCH, hidden), H(BATCH, hidden);
+
+  const double flops = 2.0 * BATCH * in * hidden;
+  const auto reps = Bench::reps_for(flops);
+  const double unfused = Bench::best_of(reps, [&] {
+    linalg::matmul<float>(X, W, A);
+    linalg::add_rowwise_bias<float>(b, A);
+    relu.Forward(A, H_unfused);
+  });
+  const double fused = Bench::best_of(reps, [&] { layer.Forward(X, H); });
+
+  const double elems = static_cast<double>(BATCH) * hidden;
+  std::printf("  %5zu %6zu %11.3f %9.3f %7.2fx %11.2f %9.2f %9.1e\n", in,
+              hidden, unfused * 1e3, fused * 1e3, unfused / fused,
+              UNFUSED_BYTES * elems / (1 << 20),
+              FUSED_BYTES * elems / (1 << 20),
+              Bench::max_abs_diff(H, H_unfused));
+}
+} // namespace
+
+int main() {
+  std::mt19937 rng(14);
+
+  std::printf("batch %zu, forward of one Linear -> ReLU\n", BATCH);
+  std::printf("  %5s %6s %11s %9s %8s %11s %9s %9s\n", "in", "hidden",
+              "unfused ms", "fused ms", "speedup", "unfused MB", "fused MB",
+              "max diff");
+  // fc1 of the MNIST model at growing widths, then square hidden layers.
+  for (const std::size_t hidden : {256, 1024, 2048, 4096})
+    run(784, hidden, rng);
+  for (const std::size_t hidden : {1024, 2048, 4096})
+    run(hidden, hidden, rng);
+}
@@ -0,0 +1,97 @@
+// Batch assembly throughput: the old per-element float gather against
+// Data::ImageSet over float features and over uint8 pixels with the fused
+// widen + normalise kernel, for every SIMD tier.
+
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+
+#include "BenchCommon.hpp"
+#include "Data/ImageSet.hpp"
+#include "Kernels/Simd.hpp"
+
+namespace Bench = Logos::Bench;
+namespace Data = Logos::Data;
+namespace simd = Logos::linalg::simd;
+using Logos::linalg::Matrix;
+
+namespace {
+
+constexpr std::size_t ROWS = 60000, COLS = 784, BATCH = 64, BATCHES = 256;
+
+void print(const char *name, double seconds) {
+  const double rows = static_cast<double>(BATCH * BATCHES);
+  std::printf("%-26s %8.3f ms  %6.2f GB/s out\n", name, seconds * 1e3,
+              rows * COLS * sizeof(float) / seconds / 1e9);
+}
+} // namespace
+
+int main() {
+  std::mt19937 rng(9);
+  Matrix<std::uint8_t> pixels(ROWS, COLS);
+  Matrix<float> features(ROWS, COLS);
+  for (std::size_t i = 0; i < ROWS * COLS; i++) {
+    pixels.data()[i] = static_cast<std::uint8_t>(rng());
+    features.data()[i] = pixels.data()[i] / 255.0f;
+  }
+
+  std::vector<std::size_t> order(ROWS);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), rng);
+
+  std::uint8_t as_u8_bytes[101];
+  std::copy(pixels.data(), pixels.data() + 101, as_u8_bytes);
+
+  const auto as_f32 = Data::ImageSet::View(features);
+  const Data::ImageSet as_u8(std::move(pixels),
+                             Data::PixelTransform::Normalize(0.1307f, 0.3081f));
+  std::printf("footprint: f32 %.1f MB, u8 %.1f MB\n", as_f32.size_bytes() / 1e6,
+              as_u8.size_bytes() / 1e6);
+
+  Matrix<float> Xb(BATCH, COLS);
+  auto run = [&](auto &&gather) {
+    return Bench::best_of(5, [&] {
+      for (std::size_t b = 0; b < BATCHES; b++)
+        gather(std::span<const std::size_t>(order.data() + b * BATCH, BATCH));
+    });
+  };
+
+  print("f32 per-element loop", run([&](std::span<const std::size_t> idx) {
+          for (std::size_t i = 0; i < idx.size(); i++)
+            for (std::size_t j = 0; j < COLS; j++)
+              Xb(i, j) = features(idx[i], j);
+        }));
+  print("f32 ImageSet::Gather", run([&](std::span<const std::size_t> idx) {
+          as_f32.Gather(idx, Xb);
+        }));
+
+  // Reference for the tier check: the scalar formula on the first batch with
+  // an odd width tail (cols 0..COLS-1 are all covered).
+  const std::span<const std::size_t> first(order.data(), BATCH);
+  Matrix<float> ref(BATCH, COLS), got;
+  simd::ForceTier(simd::Tier::Scalar);
+  as_u8.Gather(first, ref);
+
+  for (auto tier : {simd::Tier::Scalar, simd::Tier::SSE42, simd::Tier::AVX2,
+                    simd::Tier::AVX512}) {
+    if (simd::ForceTier(tier) != tier)
+      continue;
+    char name[64];
+    std::snprintf(name, sizeof(name), "u8 ImageSet::Gather %s",
+                  simd::TierName(tier));
+    print(name, run([&](std::span<const std::size_t> idx) {
+            as_u8.Gather(idx, Xb);
+          }));
+
+    as_u8.Gather(first, got);
+    float err = Bench::max_abs_diff(ref, got);
+
+    // Odd length to exercise the vector tails.
+    float tail[101];
+    simd::Kernels().u8_to_f32(as_u8_bytes, tail, 101, 0.5f, -3.0f);
+    for (std::size_t i = 0; i < 101; i++)
+      err = std::max(err, std::abs(tail[i] - (as_u8_bytes[i] * 0.5f - 3.0f)));
+    if (err > 1e-5f)
+      std::printf("  MISMATCH against scalar: %g\n", err);
+  }
+}
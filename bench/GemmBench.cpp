@@ -0,0 +1,167 @@
+// GFLOP/s of the packed GEMM engine against the previous naive kernels for
+// the three entry points used by Linear::Forward/Backward.
+
+#include <cmath>
+#include <cstdio>
+
+#include "BenchCommon.hpp"
+#include "Kernels.hpp"
+
+using Logos::linalg::Matrix;
+namespace Bench = Logos::Bench;
+
+namespace {
+
+// The triple loops linalg::matmul* used before the GEMM engine.
+void naive_matmul(const Matrix<float> &A, const Matrix<float> &B,
+                  Matrix<float> &out) {
+  const auto N = A.rows(), K = A.cols(), M = B.cols();
+  out.fill_zeroes();
+  const auto X = A.data(), Y = B.data();
+  auto Z = out.data();
+  for (std::size_t i = 0; i < N; i++)
+    for (std::size_t j = 0; j < K; j++) {
+      const float val = X[i * K + j];
+      for (std::size_t k = 0; k < M; k++)
+        Z[i * M + k] += val * Y[j * M + k];
+    }
+}
+
+void naive_matmul_transposeA(const Matrix<float> &A, const Matrix<float> &B,
+                             Matrix<float> &out) {
+  const auto N = A.rows(), M = A.cols(), P = B.cols();
+  out.fill_zeroes();
+  const auto X = A.data(), Y = B.data();
+  auto Z = out.data();
+  for (std::size_t i = 0; i < M; i++)
+    for (std::size_t k = 0; k < N; k++) {
+      const auto val = X[k * M + i];
+      for (std::size_t j = 0; j < P; j++)
+        Z[i * P + j] += val * Y[k * P + j];
+    }
+}
+
+void naive_matmul_transposeB(const Matrix<float> &A, const Matrix<float> &B,
+                             Matrix<float> &out) {
+  const auto N = A.rows(), M = A.cols(), P = B.rows();
+  const auto X = A.data(), Y = B.data();
+  auto Z = out.data();
+  for (std::size_t i = 0; i < N; i++)
+    for (std::size_t j = 0; j < P; j++) {
+      float sum = 0.0f;
+      for (std::size_t k = 0; k < M; k++)
+        sum += X[i * M + k] * Y[j * M + k];
+      Z[i * P + j] = sum;
+    }
+}
+
+enum class Op { NN, TN, NT };
+
+struct Shape {
+  Op op;
+  std::size_t M, K, N; // out is M x N, inner dimension K
+  const char *what;
+};
+
+void run(const Shape &s, std::mt19937 &rng) {
+  // Operand layouts as the kernels expect them:
+  //   NN: A[M x K] * B[K x N]
+  //   TN: A[K x M]^T * B[K x N]
+  //   NT: A[M x K] * B[N x K]^T
+  Matrix<float> A = (s.op == Op::TN) ? Matrix<float>(s.K, s.M)
+                                     : Matrix<float>(s.M, s.K);
+  Matrix<float> B = (s.op == Op::NT) ? Matrix<float>(s.N, s.K)
+                                     : Matrix<float>(s.K, s.N);
+  Matrix<float> ref(s.M, s.N), out(s.M, s.N);
+  Bench::fill_random(A, rng);
+  Bench::fill_random(B, rng);
+
+  const double flops = 2.0 * s.M * s.N * s.K;
+  const auto reps = Bench::reps_for(flops);
+
+  double t_naive = 0.0, t_gemm = 0.0;
+  switch (s.op) {
+  case Op::NN:
+    t_naive = Bench::best_of(reps, [&] { naive_matmul(A, B, ref); });
+    t_gemm = Bench::best_of(
+        reps, [&] { Logos::linalg::matmul<float>(A, B, out); });
+    break;
+  case Op::TN:
+    t_naive = Bench::best_of(reps, [&] { naive_matmul_transposeA(A, B, ref); });
+    t_gemm = Bench::best_of(
+        reps, [&] { Logos::linalg::matmul_transposeA<float>(A, B, out); });
+    break;
+  case Op::NT:
+    t_naive = Bench::best_of(reps, [&] { naive_matmul_transposeB(A, B, ref); });
+    t_gemm = Bench::best_of(
+        reps, [&] { Logos::linalg::matmul_transposeB<float>(A, B, out); });
+    break;
+  }
+
+  const char *name = (s.op == Op::NN)   ? "matmul"
+                     : (s.op == Op::TN) ? "matmul_transposeA"
+                                        : "matmul_transposeB";
+  std::printf("%-18s %5zux%-5zux%-5zu %-22s naive %7.2f  gemm %7.2f GFLOP/s"
+              "  x%-5.2f maxdiff %.2e\n",
+              name, s.M, s.K, s.N, s.what, flops / t_naive * 1e-9,
+              flops / t_gemm * 1e-9, t_naive / t_gemm,
+              Bench::max_abs_diff(ref, out));
+}
+// matmul on sub-blocks of larger matrices (leading dimension != cols) must
+// match the same product on packed copies.
+void check_strided(std::mt19937 &rng) {
+  using Logos::linalg::ConstMatrixView;
+  using Logos::linalg::MatrixView;
+
+  Matrix<float> PA(200, 300), PB(150, 120), PC(100, 90);
+  Bench::fill_random(PA, rng);
+  Bench::fill_random(PB, rng);
+  PC.fill_zeroes();
+
+  const auto A = ConstMatrixView<float>(PA).block(7, 13, 64, 100);
+  const auto B = ConstMatrixView<float>(PB).block(20, 5, 100, 50);
+  const auto C = MatrixView<float>(PC).block(3, 11, 64, 50);
+
+  Matrix<float> a(64, 100), b(100, 50), ref(64, 50), got(64, 50);
+  for (std::size_t i = 0; i < 64; i++)
+    for (std::size_t j = 0; j < 100; j++)
+      a(i, j) = A(i, j);
+  for (std::size_t i = 0; i < 100; i++)
+    for (std::size_t j = 0; j < 50; j++)
+      b(i, j) = B(i, j);
+
+  naive_matmul(a, b, ref);
+  Logos::linalg::matmul<float>(A, B, C);
+  for (std::size_t i = 0; i < 64; i++)
+    for (std::size_t j = 0; j < 50; j++)
+      got(i, j) = C(i, j);
+
+  std::printf("strided 64x100x50 view (lda %zu, ldb %zu, ldc %zu)    maxdiff "
+              "%.2e\n",
+              A.leading_dim(), B.leading_dim(), C.leading_dim(),
+              Bench::max_abs_diff(ref, got));
+}
+} // namespace
+
+int main() {
+  std::mt19937 rng(42);
+
+  const Shape shapes[] = {
+      {Op::NN, 64, 784, 256, "(fc1 forward)"},
+      {Op::NN, 64, 256, 10, "(fc2 forward)"},
+      {Op::TN, 784, 64, 256, "(fc1 grad weights)"},
+      {Op::NT, 64, 10, 256, "(fc2 grad input)"},
+      {Op::NN, 64, 784, 2048, "(wide hidden)"},
+      {Op::TN, 784, 64, 2048, "(wide grad weights)"},
+      {Op::NT, 64, 2048, 784, "(wide grad input)"},
+      {Op::NN, 256, 256, 256, "(square)"},
+      {Op::NN, 512, 512, 512, "(square)"},
+      {Op::NN, 1024, 1024, 1024, "(square)"},
+      {Op::NN, 2048, 2048, 2048, "(square)"},
+  };
+
+  for (const auto &s : shapes)
+    run(s, rng);
+
+  check_strided(rng);
+}
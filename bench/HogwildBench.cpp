@@ -0,0 +1,66 @@
+// Samples per second of asynchronous Hogwild training against the serial
+// and synchronous data-parallel paths on a synthetic MNIST-shaped set, plus
+// the per-worker sample rates.
+
+#include <cstdio>
+#include <numeric>
+
+#include "BenchCommon.hpp"
+#include "NeuralNetwork.hpp"
+#include "Threading/ThreadPool.hpp"
+
+using Logos::Threading::ThreadPool;
+namespace Bench = Logos::Bench;
+namespace NN = Logos::NeuralNet;
+
+namespace {
+constexpr std::size_t IN = 784, HIDDEN = 256, CLASSES = 10;
+constexpr std::size_t SAMPLES = 16384, BATCH = 64;
+constexpr double LR = 0.05;
+} // namespace
+
+int main() {
+  std::mt19937 rng(5);
+  NN::Matrix X(SAMPLES, IN);
+  Bench::fill_random(X, rng);
+  std::vector<std::uint8_t> y(SAMPLES);
+  for (std::size_t i = 0; i < SAMPLES; i++)
+    y[i] = static_cast<std::uint8_t>(rng() % CLASSES);
+  std::vector<std::size_t> order(SAMPLES);
+  std::iota(order.begin(), order.end(), 0);
+
+  // Serial reference: same gather + TrainStep loop on one thread.
+  {
+    ThreadPool::ResetGlobal(1);
+    std::mt19937 mrng(123);
+    auto model = NN::MakeMLP(IN, HIDDEN, CLASSES, mrng);
+    NN::Matrix Xb(BATCH, IN);
+    std::vector<std::uint8_t> yb(BATCH);
+    const double t = Bench::best_of(1, [&] {
+      for (std::size_t s = 0; s + BATCH <= SAMPLES; s += BATCH) {
+        std::copy(&X(s, 0), &X(s, 0) + BATCH * IN, Xb.data());
+        std::copy(y.begin() + s, y.begin() + s + BATCH, yb.begin());
+        model.TrainStep(Xb, yb, LR);
+      }
+    });
+    std::printf("serial       : %9.0f samples/s\n", SAMPLES / t);
+  }
+
+  const auto images = Logos::Data::ImageSet::View(X);
+  for (const std::size_t K : Bench::thread_counts()) {
+    ThreadPool::ResetGlobal(K);
+    std::mt19937 mrng(123);
+    auto model = NN::MakeMLP(IN, HIDDEN, CLASSES, mrng);
+    NN::HogwildTrainer hogwild(model, K);
+
+    double loss = 0.0;
+    const double t = Bench::best_of(1, [&] {
+      loss = hogwild.RunEpoch(images, y, order, BATCH, LR);
+    });
+    std::printf("hogwild K=%-3zu: %9.0f samples/s  loss %.4f  per worker:", K,
+                SAMPLES / t, loss);
+    for (const auto &s : hogwild.Stats())
+      std::printf(" %.0f", s.samples_per_second());
+    std::printf("\n");
+  }
+}
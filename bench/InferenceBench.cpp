@@ -0,0 +1,129 @@
+// Inference-mode Sequential::Infer against the training-mode Forward, which
+// also writes ReLU masks and keeps layer inputs for Backward, on MLPs
+// 784 -> 2 x hidden -> 10.
+//   forward / infer us  time per batch, single caller
+//   threads             callers sharing one model through Infer, each with
+//                       its own InferenceScratch
+//   rows/s              total rows per second over all callers
+// Forward cannot be shared: two callers would overwrite each other's
+// activations and masks.
+//
+// Infer runs the same GEMMs as Forward. It saves only the mask bits, the
+// bf16 input copies and, unfused, the second ReLU buffer: its ReLU runs in
+// place. Where the GEMMs dominate, as at hidden 1024 or batch 1024, expect
+// no speedup. On the 1-core machine these numbers come from, repeated runs
+// at LOGOS_NUM_THREADS=1 put every configuration between 0.9x and 1.1x,
+// none of them below 1x run after run. With more threads than cores the
+// pool's scheduling dominates. Single runs there have measured as low as
+// 0.72x, even for the fused model, where both paths run the same kernels.
+// Treat those rows as noise, not as a regression of Infer. The two paths
+// are timed alternately so that neither profits from a quieter moment.
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "Sequential.hpp"
+
+namespace Bench = Logos::Bench;
+namespace NN = Logos::NeuralNet;
+namespace linalg = Logos::linalg;
+
+namespace {
+constexpr std::size_t INPUT = 784, CLASSES = 10;
+
+// Best times of a() and b() over `reps` runs each, alternated so that
+// neither profits from running while the machine is quieter.
+template <class A, class B>
+std::pair<double, double> best_of_alternating(std::size_t reps, A &&a,
+                                              B &&b) {
+  a();
+  b();
+  double best_a = 1e30, best_b = 1e30;
+  for (std::size_t r = 0; r < reps; r++) {
+    auto t0 = Bench::Clock::now();
+    a();
+    std::chrono::duration<double> dt = Bench::Clock::now() - t0;
+    best_a = std::min(best_a, dt.count());
+    t0 = Bench::Clock::now();
+    b();
+    dt = Bench::Clock::now() - t0;
+    best_b = std::min(best_b, dt.count());
+  }
+  return {best_a, best_b};
+}
+
+NN::Sequential<float> build(std::size_t hidden, std::size_t depth,
+                            bool fuse = true,
+                            linalg::Precision precision =
+                                linalg::Precision::F32) {
+  std::mt19937 rng(24);
+  NN::Sequential<float> model(INPUT);
+  for (std::size_t l = 0; l < depth; l++)
+    model.AddLinear(hidden, rng).AddReLU();
+  model.AddLinear(CLASSES, rng).Build(fuse);
+  model.SetPrecision(precision);
+  return model;
+}
+} // namespace
+
+int main() {
+  std::mt19937 rng(24);
+  linalg::Matrix<float> X(1024, INPUT), out;
+  Bench::fill_random(X, rng);
+  const linalg::ConstMatrixView<float> all(X);
+
+  // Forward's extra work: the fused GEMM writes a mask bit per activation,
+  // an unfused ReLU a separate pass with the mask, and bf16 a 16-bit copy
+  // of every Linear input.
+  struct Config {
+    const char *name;
+    bool fuse;
+    linalg::Precision precision;
+  };
+  const Config configs[] = {{"fused", true, linalg::Precision::F32},
+                            {"unfused", false, linalg::Precision::F32},
+                            {"fused bf16", true, linalg::Precision::BF16}};
+
+  std::printf("  %-11s %6s %6s %11s %9s %8s\n", "model", "hidden", "batch",
+              "forward us", "infer us", "speedup");
+  for (const auto &c : configs)
+    for (const std::size_t hidden : {256, 1024}) {
+      auto model = build(hidden, 2, c.fuse, c.precision);
+      NN::Sequential<float>::InferenceScratch scratch;
+      for (const std::size_t batch : {1, 64, 1024}) {
+        const auto x = all.row_range(0, batch);
+        const double flops = 2.0 * batch * hidden * (INPUT + hidden);
+        const std::size_t reps = Bench::reps_for(flops, 1e10);
+        const auto [fwd, inf] = best_of_alternating(
+            reps, [&] { model.Forward(x, out); },
+            [&] { model.Infer(x, scratch); });
+        std::printf("  %-11s %6zu %6zu %11.1f %9.1f %7.2fx\n", c.name, hidden,
+                    batch, fwd * 1e6, inf * 1e6, fwd / inf);
+      }
+    }
+
+  // One set of weights, several callers evaluating batches of 64.
+  const auto model = build(1024, 2);
+  constexpr std::size_t BATCH = 64, ROUNDS = 200;
+  std::printf("\n  %7s %12s\n", "threads", "rows/s");
+  for (const std::size_t threads : Bench::thread_counts()) {
+    const auto t0 = Bench::Clock::now();
+    std::vector<std::thread> callers;
+    for (std::size_t t = 0; t < threads; t++)
+      callers.emplace_back([&, t] {
+        NN::Sequential<float>::InferenceScratch scratch;
+        for (std::size_t r = 0; r < ROUNDS; r++)
+          model.Infer(all.row_range((t + r) % 16 * BATCH, BATCH), scratch);
+      });
+    for (auto &c : callers)
+      c.join();
+    const std::chrono::duration<double> dt = Bench::Clock::now() - t0;
+    std::printf("  %7zu %12.0f\n", threads,
+                threads * ROUNDS * BATCH / dt.count());
+  }
+}
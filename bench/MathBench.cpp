@@ -0,0 +1,142 @@
+// Error and throughput of the exp/log kernels in each MathMode, on every
+// SIMD tier the CPU supports, plus softmax and fused cross-entropy over
+// 10K-class rows. Errors are measured against double precision libm over
+// the range where results are normal floats; each mode has a stated bound
+// and the program exits non-zero when a tier exceeds it.
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "Kernels/Simd.hpp"
+
+namespace Bench = Logos::Bench;
+namespace simd = Logos::linalg::simd;
+using simd::MathMode;
+
+namespace {
+
+constexpr std::size_t POINTS = std::size_t(1) << 21;
+constexpr std::size_t ROWS = 256, CLASSES = 10000;
+
+constexpr MathMode MODES[] = {MathMode::Exact, MathMode::Accurate,
+                              MathMode::Fast};
+
+struct Bound {
+  double ulps;     // Exact and Accurate
+  double relative; // Fast
+};
+
+Bound BoundFor(MathMode mode) {
+  switch (mode) {
+  case MathMode::Exact:
+    return {1.0, 0.0};
+  case MathMode::Accurate:
+    return {2.0, 0.0};
+  default:
+    return {0.0, 1.5e-4};
+  }
+}
+
+struct Error {
+  double ulps = 0.0, relative = 0.0;
+};
+
+Error measure(const std::vector<float> &x, const std::vector<float> &y,
+              double (*ref)(double)) {
+  Error err;
+  for (std::size_t i = 0; i < x.size(); i++) {
+    const double r = ref(x[i]);
+    const float rf = static_cast<float>(r);
+    const double ulp =
+        std::nextafter(std::abs(rf), std::numeric_limits<float>::infinity()) -
+        std::abs(rf);
+    const double diff = std::abs(static_cast<double>(y[i]) - r);
+    err.ulps = std::max(err.ulps, diff / ulp);
+    if (r != 0.0)
+      err.relative = std::max(err.relative, diff / std::abs(r));
+  }
+  return err;
+}
+
+bool within(MathMode mode, const Error &e) {
+  const Bound b = BoundFor(mode);
+  return mode == MathMode::Fast ? e.relative <= b.relative : e.ulps <= b.ulps;
+}
+} // namespace
+
+int main() {
+  std::mt19937 rng(13);
+
+  // exp over its normal-result range, log over positive normals with extra
+  // density around 1.
+  std::vector<float> exp_x(POINTS), log_x(POINTS), y(POINTS);
+  std::uniform_real_distribution<float> ue(-87.3f, 88.3f),
+      ul(-125.0f * 0.693f, 127.0f * 0.693f), near(0.5f, 2.0f);
+  for (std::size_t i = 0; i < POINTS; i++) {
+    exp_x[i] = ue(rng);
+    log_x[i] = (i % 4 == 0) ? near(rng) : std::exp(ul(rng));
+  }
+
+  std::vector<float> logits(ROWS * CLASSES), probs(ROWS * CLASSES);
+  std::normal_distribution<float> nd(0.0f, 4.0f);
+  for (auto &v : logits)
+    v = nd(rng);
+
+  bool ok = true;
+  for (int t = 0; t <= static_cast<int>(simd::DetectedTier()); t++) {
+    const auto tier = simd::ForceTier(static_cast<simd::Tier>(t));
+    const auto &k = simd::Kernels();
+    std::printf("%s\n  %-9s %10s %10s %9s %10s %10s %9s %9s %9s\n",
+                simd::TierName(tier), "mode", "exp ulps", "exp rel",
+                "exp G/s", "log ulps", "log rel", "log G/s", "softmax",
+                "xent");
+
+    double base_softmax = 0.0, base_xent = 0.0;
+    for (const MathMode mode : MODES) {
+      const double t_exp = Bench::best_of(
+          5, [&] { k.exp(exp_x.data(), y.data(), POINTS, mode); });
+      const Error e_exp = measure(exp_x, y, [](double v) { return std::exp(v); });
+
+      const double t_log = Bench::best_of(
+          5, [&] { k.log(log_x.data(), y.data(), POINTS, mode); });
+      const Error e_log = measure(log_x, y, [](double v) { return std::log(v); });
+
+      const double t_softmax = Bench::best_of(5, [&] {
+        for (std::size_t i = 0; i < ROWS; i++)
+          k.softmax_row(&logits[i * CLASSES], &probs[i * CLASSES], CLASSES,
+                        mode);
+      });
+      const double t_xent = Bench::best_of(5, [&] {
+        for (std::size_t i = 0; i < ROWS; i++)
+          k.softmax_xent_row(&logits[i * CLASSES], &probs[i * CLASSES],
+                             CLASSES, i % CLASSES, 1.0f / ROWS, mode);
+      });
+      if (mode == MathMode::Exact) {
+        base_softmax = t_softmax;
+        base_xent = t_xent;
+      }
+
+      const bool pass = within(mode, e_exp) && within(mode, e_log);
+      ok = ok && pass;
+      std::printf("  %-9s %10.2f %10.2e %9.2f %10.2f %10.2e %9.2f %8.2fx "
+                  "%8.2fx%s\n",
+                  simd::MathModeName(mode), e_exp.ulps, e_exp.relative,
+                  POINTS / t_exp * 1e-9, e_log.ulps, e_log.relative,
+                  POINTS / t_log * 1e-9, base_softmax / t_softmax,
+                  base_xent / t_xent, pass ? "" : "  FAIL");
+    }
+  }
+
+  std::printf("bounds: exact <= %.0f ulp, accurate <= %.0f ulp, fast <= %.1e "
+              "relative; softmax/xent columns are speedups over exact "
+              "(%zu x %zu)\n",
+              BoundFor(MathMode::Exact).ulps,
+              BoundFor(MathMode::Accurate).ulps,
+              BoundFor(MathMode::Fast).relative, ROWS, CLASSES);
+  if (!ok)
+    std::printf("error bound exceeded\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// Mixed-precision training against fp32.
+//
+// First, throughput of the 16-bit conversion kernels on each SIMD tier the
+// CPU supports, in GB/s of float data. Then a deep MLP (784 -> DEPTH x
+// WIDTH -> 10) trained for STEPS steps from the same start at each storage
+// precision: planned workspace peak, bytes of weights the GEMMs read per
+// step (each weight matrix is read by the forward and the dX product),
+// step time, and the final loss.
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "Half.hpp"
+#include "Sequential.hpp"
+
+namespace Bench = Logos::Bench;
+namespace NN = Logos::NeuralNet;
+namespace linalg = Logos::linalg;
+namespace simd = Logos::linalg::simd;
+using linalg::Precision;
+
+namespace {
+constexpr std::size_t N = std::size_t(1) << 22;
+constexpr std::size_t BATCH = 256, INPUT = 784, WIDTH = 1024, DEPTH = 8,
+                      CLASSES = 10, STEPS = 20;
+constexpr double LR = 0.01;
+
+void conversions() {
+  std::mt19937 rng(20);
+  std::normal_distribution<float> nd(0.0f, 1.0f);
+  std::vector<float> x(N), y(N);
+  for (auto &v : x)
+    v = nd(rng);
+  std::vector<std::uint16_t> h(N);
+
+  std::printf("%zu values, GB/s of float data\n  %-8s %10s %10s %10s %10s\n",
+              N, "tier", "f32>bf16", "bf16>f32", "f32>f16", "f16>f32");
+  for (int t = 0; t <= static_cast<int>(simd::DetectedTier()); t++) {
+    const auto tier = simd::ForceTier(static_cast<simd::Tier>(t));
+    const auto &k = simd::Kernels();
+    auto gbs = [](auto fn, auto src, auto dst) {
+      return 4.0 * N / Bench::best_of(5, [&] { fn(src, dst, N); }) / 1e9;
+    };
+    const double a = gbs(k.f32_to_bf16, x.data(), h.data());
+    const double b = gbs(k.bf16_to_f32, h.data(), y.data());
+    const double c = gbs(k.f32_to_f16, x.data(), h.data());
+    const double d = gbs(k.f16_to_f32, h.data(), y.data());
+    std::printf("  %-8s %10.2f %10.2f %10.2f %10.2f\n", simd::TierName(tier),
+                a, b, c, d);
+  }
+  simd::ForceTier(simd::DetectedTier());
+}
+
+NN::Sequential<float> build() {
+  std::mt19937 rng(20);
+  NN::Sequential<float> model(INPUT);
+  for (std::size_t l = 0; l < DEPTH; l++)
+    model.AddLinear(WIDTH, rng).AddReLU();
+  model.AddLinear(CLASSES, rng).Build();
+  return model;
+}
+} // namespace
+
+int main() {
+  conversions();
+
+  std::mt19937 rng(21);
+  linalg::Matrix<float> X(BATCH, INPUT);
+  Bench::fill_random(X, rng);
+  std::vector<std::uint8_t> labels(BATCH);
+  for (auto &l : labels)
+    l = static_cast<std::uint8_t>(rng() % CLASSES);
+
+  std::size_t weights = 0;
+  for (const auto p : build().Parameters())
+    weights += p.size();
+
+  std::printf("\n%zu x %zu hidden, batch %zu, %zu steps\n", DEPTH, WIDTH,
+              BATCH, STEPS);
+  std::printf("  %-6s %13s %15s %9s %10s\n", "store", "workspace MiB",
+              "weight MiB/step", "step ms", "loss");
+  for (const Precision p : {Precision::F32, Precision::BF16, Precision::F16}) {
+    auto model = build();
+    model.SetPrecision(p);
+    model.Reserve(BATCH);
+
+    double loss = 0.0;
+    const double s = Bench::best_of(
+        STEPS - 1, [&] { loss = model.TrainStep(X, labels, LR); });
+    std::printf("  %-6s %13.2f %15.2f %9.2f %10.5f\n",
+                linalg::PrecisionName(p),
+                model.WorkspaceLayout().peak_bytes() / 1048576.0,
+                2.0 * weights * linalg::PrecisionBytes(p) / 1048576.0, s * 1e3,
+                loss);
+  }
+}
@@ -0,0 +1,86 @@
+// Epoch time of serial training with batches gathered inline on the training
+// thread versus assembled ahead by Data::BatchPipeline, plus the time the
+// trainer spent waiting on the loader.
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+
+#include "BenchCommon.hpp"
+#include "Data/BatchPipeline.hpp"
+#include "NeuralNetwork.hpp"
+
+namespace Bench = Logos::Bench;
+namespace Data = Logos::Data;
+namespace NN = Logos::NeuralNet;
+
+namespace {
+
+constexpr std::size_t IN = 784, HIDDEN = 256, CLASSES = 10;
+constexpr std::size_t SAMPLES = 16384, BATCH = 64;
+constexpr double LR = 0.01;
+
+// Row-by-row gather, as the loader does it, but on the calling thread.
+void gather(const NN::Matrix &X, const std::vector<std::uint8_t> &y,
+            const std::vector<std::size_t> &order, std::size_t first,
+            NN::Matrix &Xb, std::vector<std::uint8_t> &yb) {
+  const std::size_t rows = std::min(BATCH, order.size() - first);
+  if (Xb.rows() != rows)
+    Xb = NN::Matrix(rows, IN);
+  yb.resize(rows);
+  for (std::size_t i = 0; i < rows; i++) {
+    const std::size_t idx = order[first + i];
+    std::copy(X.data() + idx * IN, X.data() + (idx + 1) * IN,
+              Xb.data() + i * IN);
+    yb[i] = y[idx];
+  }
+}
+} // namespace
+
+int main() {
+  std::mt19937 rng(5);
+  NN::Matrix X(SAMPLES, IN);
+  Bench::fill_random(X, rng);
+  std::vector<std::uint8_t> y(SAMPLES);
+  for (std::size_t i = 0; i < SAMPLES; i++)
+    y[i] = static_cast<std::uint8_t>(rng() % CLASSES);
+
+  {
+    std::mt19937 init(7);
+    auto model = NN::MakeMLP(IN, HIDDEN, CLASSES, init);
+    std::vector<std::size_t> order(SAMPLES);
+    std::iota(order.begin(), order.end(), 0);
+    NN::Matrix Xb;
+    std::vector<std::uint8_t> yb;
+
+    const double t = Bench::best_of(3, [&] {
+      std::shuffle(order.begin(), order.end(), rng);
+      for (std::size_t first = 0; first < SAMPLES; first += BATCH) {
+        gather(X, y, order, first, Xb, yb);
+        model.TrainStep(Xb, yb, LR);
+      }
+    });
+    std::printf("%-22s epoch %.3f s\n", "inline gather", t);
+  }
+
+  const auto images = Data::ImageSet::View(X);
+  for (const bool augment : {false, true}) {
+    for (const std::size_t depth : {2, 4}) {
+      std::mt19937 init(7);
+      auto model = NN::MakeMLP(IN, HIDDEN, CLASSES, init);
+      Data::BatchPipeline loader(images, y, BATCH, 11, depth,
+                                 augment ? Data::RandomShift(28, 28, 2)
+                                         : Data::BatchPipeline::Augment{});
+
+      double stall = 0.0;
+      const double t = Bench::best_of(3, [&] {
+        loader.BeginEpoch();
+        while (const auto *batch = loader.Next())
+          model.TrainStep(batch->X, batch->y, LR);
+        stall = loader.StallSeconds();
+      });
+      std::printf("pipeline depth %zu%-6s epoch %.3f s  stall %.4f s\n", depth,
+                  augment ? " +aug" : "", t, stall);
+    }
+  }
+}
@@ -0,0 +1,87 @@
+// Int8 inference against fp32 for the 784 -> 256 -> 10 MNIST model. On
+// each SIMD tier the CPU supports, a QuantizedMLP is calibrated on separate
+// rows with the widest activation range that tier's int8 GEMM takes, then
+// both models run the same batches: time per batch, rows/s of the int8
+// model, the speedup, the fraction of rows whose argmax agrees and the RMS
+// error of the int8 logits.
+//
+// Accuracy depends on the activation range only. The scalar tier and the
+// VNNI tiers (AVX2 with AVX-VNNI, AVX-512 with AVX512-VNNI) use 0..255 and
+// compute the same integers. SSE4.2, and AVX2/AVX-512 without VNNI, go
+// through pmaddubsw and keep to 0..127. At 4096 rows of this model:
+//   0..255  agree 0.9905, rms error 0.0105
+//   0..127  agree 0.9851, rms error 0.0139
+
+#include <cmath>
+#include <cstdio>
+
+#include "BenchCommon.hpp"
+#include "Functions.hpp"
+#include "Kernels/Simd.hpp"
+#include "NeuralNetwork.hpp"
+#include "QuantizedMLP.hpp"
+
+namespace Bench = Logos::Bench;
+namespace NN = Logos::NeuralNet;
+namespace simd = Logos::linalg::simd;
+using Logos::linalg::ConstMatrixView;
+using Logos::linalg::Matrix;
+
+namespace {
+constexpr std::size_t IN = 784, HIDDEN = 256, CLASSES = 10,
+                      CALIBRATION = 1000, ROWS = 4096;
+
+double agreement(const Matrix<float> &a, const Matrix<float> &b) {
+  std::size_t same = 0;
+  for (std::size_t i = 0; i < a.rows(); i++)
+    if (NN::ArgmaxRow<float>(a, i) == NN::ArgmaxRow<float>(b, i))
+      same++;
+  return static_cast<double>(same) / a.rows();
+}
+
+double rms_error(const Matrix<float> &a, const Matrix<float> &b) {
+  double sum = 0.0;
+  for (std::size_t i = 0; i < a.size(); i++) {
+    const double d = a.data()[i] - b.data()[i];
+    sum += d * d;
+  }
+  return std::sqrt(sum / a.size());
+}
+} // namespace
+
+int main() {
+  std::mt19937 rng(21);
+  auto model = NN::MakeMLP(IN, HIDDEN, CLASSES, rng);
+
+  Matrix<float> calibration(CALIBRATION, IN), X(ROWS, IN);
+  Bench::fill_random(calibration, rng);
+  Bench::fill_random(X, rng);
+
+  Matrix<float> out_f32, out_i8;
+  for (int t = 0; t <= static_cast<int>(simd::DetectedTier()); t++) {
+    const auto tier = simd::ForceTier(static_cast<simd::Tier>(t));
+    NN::QuantizedMLP quantized(model, calibration);
+    if (t == 0)
+      std::printf("weights: fp32 %.1f KiB, int8 %.1f KiB\n",
+                  (IN * HIDDEN + HIDDEN * CLASSES) * 4 / 1024.0,
+                  quantized.WeightBytes() / 1024.0);
+    std::printf("%s, activations 0..%d\n  %5s %10s %10s %12s %8s %7s %9s\n",
+                simd::TierName(tier), quantized.ActMax(), "batch", "fp32 us",
+                "int8 us", "int8 rows/s", "speedup", "agree", "rms err");
+
+    for (const std::size_t batch : {1, 64, 1024, 4096}) {
+      const auto Xb = ConstMatrixView<float>(X).row_range(0, batch);
+      const double flops = 2.0 * batch * (IN * HIDDEN + HIDDEN * CLASSES);
+      const auto reps = Bench::reps_for(flops, 2e8);
+
+      const double f =
+          Bench::best_of(reps, [&] { model.Forward(Xb, out_f32); });
+      const double q =
+          Bench::best_of(reps, [&] { quantized.Forward(Xb, out_i8); });
+      std::printf("  %5zu %10.2f %10.2f %12.0f %7.2fx %7.4f %9.5f\n", batch,
+                  f * 1e6, q * 1e6, batch / q, f / q,
+                  agreement(out_f32, out_i8), rms_error(out_f32, out_i8));
+    }
+  }
+  simd::ForceTier(simd::DetectedTier());
+}
@@ -0,0 +1,99 @@
+// Model checkpoints (.lgc) at growing width: MLPs 784 -> 4 x WIDTH -> 10
+// trained with Adam, so the file holds two moment buffers besides the
+// weights. Per model:
+//   save ms     SaveCheckpoint on the calling thread
+//   blocked ms  time CheckpointWriter::Save keeps the caller (the snapshot)
+//   read ms     Open + RestoreInto: copies weights and optimizer state
+//   map ms      Open + MapInto: the model's weights point into the mapping
+//   first fwd   batch-1 forward right after mapping, pages faulted in
+// The file is in the page cache after the save, so read and map compare
+// copying against not copying rather than disk speed.
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "Checkpoint.hpp"
+#include "Sequential.hpp"
+
+namespace Bench = Logos::Bench;
+namespace NN = Logos::NeuralNet;
+namespace linalg = Logos::linalg;
+
+namespace {
+constexpr std::size_t INPUT = 784, DEPTH = 4, CLASSES = 10, BATCH = 64;
+const char *PATH = "SaveLoadBench.lgc";
+
+NN::Sequential<float> build(std::size_t width, std::uint32_t seed) {
+  std::mt19937 rng(seed);
+  NN::Sequential<float> model(INPUT);
+  for (std::size_t l = 0; l < DEPTH; l++)
+    model.AddLinear(width, rng).AddReLU();
+  model.AddLinear(CLASSES, rng).Build();
+  NN::OptimizerOptions adam;
+  adam.kind = NN::OptimizerKind::Adam;
+  model.SetOptimizer(adam);
+  return model;
+}
+
+double seconds_since(Bench::Clock::time_point t0) {
+  const std::chrono::duration<double> dt = Bench::Clock::now() - t0;
+  return dt.count();
+}
+} // namespace
+
+int main() {
+  std::mt19937 rng(22);
+  linalg::Matrix<float> X(BATCH, INPUT), out;
+  Bench::fill_random(X, rng);
+  std::vector<std::uint8_t> labels(BATCH);
+  for (auto &l : labels)
+    l = static_cast<std::uint8_t>(rng() % CLASSES);
+
+  std::printf("  %5s %9s %8s %10s %8s %8s %12s\n", "width", "file MiB",
+              "save ms", "blocked ms", "read ms", "map ms", "first fwd ms");
+  for (const std::size_t width : {256, 1024, 2048, 4096}) {
+    auto model = build(width, 1);
+    model.TrainStep(X, labels, 0.001);
+    const NN::TrainingState state{1, 0.001, rng};
+
+    const double save = Bench::best_of(
+        3, [&] { NN::SaveCheckpoint(PATH, model, state); });
+    NN::CheckpointWriter writer;
+    double blocked = 1e30;
+    for (int r = 0; r < 3; r++) {
+      const auto t0 = Bench::Clock::now();
+      writer.Save(PATH, model, state);
+      blocked = std::min(blocked, seconds_since(t0));
+      writer.Wait();
+    }
+    const double mib = std::filesystem::file_size(PATH) / 1048576.0;
+
+    auto target = build(width, 2);
+    const double read = Bench::best_of(3, [&] {
+      NN::MappedCheckpoint::Open(PATH).RestoreInto(target);
+    });
+
+    // A fresh mapping and model each time, so the forward faults its pages.
+    const auto row = linalg::ConstMatrixView<float>(X).row_range(0, 1);
+    double map = 1e30, first = 1e30;
+    for (int r = 0; r < 3; r++) {
+      NN::MappedCheckpoint file; // outlives the model mapped onto it
+      auto mapped = build(width, 3);
+      const auto t0 = Bench::Clock::now();
+      file = NN::MappedCheckpoint::Open(PATH);
+      file.MapInto(mapped);
+      map = std::min(map, seconds_since(t0));
+      const auto t1 = Bench::Clock::now();
+      mapped.Forward(row, out);
+      first = std::min(first, seconds_since(t1));
+    }
+
+    std::printf("  %5zu %9.1f %8.2f %10.3f %8.2f %8.3f %12.2f\n", width, mib,
+                save * 1e3, blocked * 1e3, read * 1e3, map * 1e3,
+                first * 1e3);
+  }
+  std::filesystem::remove(PATH);
+}
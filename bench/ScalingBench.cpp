@@ -0,0 +1,90 @@
+// Speedup of the parallel kernels and of a full MLP training step from one
+// thread up to every hardware thread.
+
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "Functions.hpp"
+#include "Kernels.hpp"
+#include "NeuralNetwork.hpp"
+#include "ReLU.hpp"
+#include "Threading/ThreadPool.hpp"
+
+using Logos::linalg::Matrix;
+using Logos::Threading::ThreadPool;
+namespace Bench = Logos::Bench;
+namespace NN = Logos::NeuralNet;
+
+namespace {
+
+struct Case {
+  const char *name;
+  std::size_t reps;
+  std::function<void()> fn;
+  double t1 = 0.0;
+};
+} // namespace
+
+int main() {
+  std::mt19937 rng(1);
+
+  Matrix<float> A(64, 784), W(784, 256), H(64, 256);
+  Matrix<float> S1(1024, 1024), S2(1024, 1024), S3(1024, 1024);
+  Matrix<float> Wide(512, 4096), WideOut, Probs;
+  Bench::fill_random(A, rng);
+  Bench::fill_random(W, rng);
+  Bench::fill_random(S1, rng);
+  Bench::fill_random(S2, rng);
+  Bench::fill_random(Wide, rng);
+
+  NN::ReLU<float> relu;
+  auto small = NN::MakeMLP(784, 256, 10, rng);
+  auto wide = NN::MakeMLP(784, 2048, 10, rng);
+  Matrix<float> Xs(64, 784), Xw(512, 784);
+  Bench::fill_random(Xs, rng);
+  Bench::fill_random(Xw, rng);
+  std::vector<std::uint8_t> ys(64), yw(512);
+  for (std::size_t i = 0; i < yw.size(); i++)
+    yw[i] = static_cast<std::uint8_t>(i % 10);
+  for (std::size_t i = 0; i < ys.size(); i++)
+    ys[i] = static_cast<std::uint8_t>(i % 10);
+
+  std::vector<Case> cases = {
+      {"matmul 64x784x256", 50,
+       [&] { Logos::linalg::matmul<float>(A, W, H); }},
+      {"matmul 1024^3", 5,
+       [&] { Logos::linalg::matmul<float>(S1, S2, S3); }},
+      {"relu 512x4096", 50, [&] { relu.Forward(Wide, WideOut); }},
+      {"softmax 512x4096", 20, [&] { NN::Softmax<float>(Wide, Probs); }},
+      {"TrainStep 64 x 784-256-10", 20,
+       [&] { small.TrainStep(Xs, ys, 0.0); }},
+      {"TrainStep 512 x 784-2048-10", 5,
+       [&] { wide.TrainStep(Xw, yw, 0.0); }},
+  };
+
+  std::printf("%-30s", "threads");
+  const auto counts = Bench::thread_counts();
+  for (auto t : counts)
+    std::printf("%10zu", t);
+  std::printf("\n");
+
+  std::vector<std::vector<double>> speedup(cases.size());
+  for (auto t : counts) {
+    ThreadPool::ResetGlobal(t);
+    for (std::size_t c = 0; c < cases.size(); c++) {
+      const double dt = Bench::best_of(cases[c].reps, cases[c].fn);
+      if (t == 1)
+        cases[c].t1 = dt;
+      speedup[c].push_back(cases[c].t1 / dt);
+    }
+  }
+
+  for (std::size_t c = 0; c < cases.size(); c++) {
+    std::printf("%-30s", cases[c].name);
+    for (double s : speedup[c])
+      std::printf("%9.2fx", s);
+    std::printf("   (1 thread: %.3f ms)\n", cases[c].t1 * 1e3);
+  }
+}
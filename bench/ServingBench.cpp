@@ -0,0 +1,133 @@
+// Closed-loop load against one frozen MLP (784 -> 1024 -> 1024 -> 10): each
+// client thread sends a single image, waits for its logits and sends the
+// next. Per mode and client count:
+//   p50/p99 us  request latency, submit to logits in hand
+//   req/s       completed requests per second over the run
+//   batch       mean rows per forward
+// Modes:
+//   serial   one batch-1 Sequential::Forward per request under a mutex, the
+//            only safe way to share a training model between threads
+//   batched  InferenceServer::Submit, requests batched up to 64 or 200 us
+//   socket   the same server behind SocketServer, one connection per client
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "Sequential.hpp"
+#include "Serving/InferenceServer.hpp"
+#include "Serving/SocketServer.hpp"
+
+namespace Bench = Logos::Bench;
+namespace NN = Logos::NeuralNet;
+namespace Serving = Logos::Serving;
+namespace linalg = Logos::linalg;
+
+namespace {
+constexpr std::size_t INPUT = 784, HIDDEN = 1024, CLASSES = 10,
+                      REQUESTS = 4096, IMAGES = 256;
+
+struct Result {
+  double p50 = 0.0, p99 = 0.0, throughput = 0.0;
+};
+
+// Runs `clients` threads, each making REQUESTS / clients calls of
+// infer(client, image) and timing every one.
+template <class Infer> Result load(std::size_t clients, Infer &&infer) {
+  const std::size_t per_client = REQUESTS / clients;
+  std::vector<std::vector<double>> latency(clients);
+  const auto t0 = Bench::Clock::now();
+  std::vector<std::thread> threads;
+  for (std::size_t c = 0; c < clients; c++)
+    threads.emplace_back([&, c] {
+      latency[c].reserve(per_client);
+      for (std::size_t i = 0; i < per_client; i++) {
+        const auto r0 = Bench::Clock::now();
+        infer(c, (c * per_client + i) % IMAGES);
+        const std::chrono::duration<double> dt = Bench::Clock::now() - r0;
+        latency[c].push_back(dt.count());
+      }
+    });
+  for (auto &t : threads)
+    t.join();
+  const std::chrono::duration<double> total = Bench::Clock::now() - t0;
+
+  std::vector<double> all;
+  for (const auto &l : latency)
+    all.insert(all.end(), l.begin(), l.end());
+  std::sort(all.begin(), all.end());
+  auto at = [&](double q) {
+    return all[std::min(all.size() - 1,
+                        static_cast<std::size_t>(q * all.size()))];
+  };
+  return {at(0.50), at(0.99), all.size() / total.count()};
+}
+
+void report(const char *mode, std::size_t clients, const Result &r,
+            double batch) {
+  std::printf("  %-8s %7zu %9.1f %9.1f %9.0f %7.1f\n", mode, clients,
+              r.p50 * 1e6, r.p99 * 1e6, r.throughput, batch);
+}
+} // namespace
+
+int main() {
+  std::mt19937 rng(23);
+  NN::Sequential<float> model(INPUT);
+  model.AddLinear(HIDDEN, rng).AddReLU().AddLinear(HIDDEN, rng).AddReLU();
+  model.AddLinear(CLASSES, rng).Build();
+
+  linalg::Matrix<float> images(IMAGES, INPUT);
+  Bench::fill_random(images, rng);
+  const linalg::ConstMatrixView<float> rows(images);
+  auto image = [&](std::size_t i) {
+    return std::span<const float>(rows.row(i), INPUT);
+  };
+
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "ServingBench.sock").string();
+  const std::vector<std::size_t> clients = {1, 4, 16, 64};
+
+  std::printf("  %-8s %7s %9s %9s %9s %7s\n", "mode", "clients", "p50 us",
+              "p99 us", "req/s", "batch");
+  for (const std::size_t c : clients) {
+    std::mutex mutex;
+    std::vector<linalg::Matrix<float>> logits(c);
+    report("serial", c,
+           load(c,
+                [&](std::size_t client, std::size_t i) {
+                  std::lock_guard lock(mutex);
+                  model.Forward(rows.row_range(i, 1), logits[client]);
+                }),
+           1.0);
+  }
+  for (const std::size_t c : clients) {
+    Serving::InferenceServer server(model);
+    const auto r = load(c, [&](std::size_t, std::size_t i) {
+      server.Submit(image(i)).get();
+    });
+    report("batched", c, r, server.stats().mean_batch());
+  }
+#if !defined(_WIN32)
+  for (const std::size_t c : clients) {
+    Serving::InferenceServer server(model);
+    Serving::SocketServer front(server, path);
+    std::vector<std::unique_ptr<Serving::SocketClient>> conns;
+    for (std::size_t k = 0; k < c; k++)
+      conns.push_back(std::make_unique<Serving::SocketClient>(path));
+    std::vector<std::vector<float>> logits(c, std::vector<float>(CLASSES));
+    const auto r = load(c, [&](std::size_t client, std::size_t i) {
+      conns[client]->Infer(image(i), logits[client]);
+    });
+    conns.clear();
+    front.Stop();
+    report("socket", c, r, server.stats().mean_batch());
+  }
+#endif
+}
@@ -0,0 +1,112 @@
+// Throughput of every dispatched float kernel on each tier the CPU supports,
+// checked against the scalar table.
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "Kernels/Simd.hpp"
+
+namespace simd = Logos::linalg::simd;
+namespace Bench = Logos::Bench;
+
+namespace {
+
+constexpr std::size_t ROWS = 256, COLS = 1000, N = ROWS * COLS;
+
+std::vector<float> random_vector(std::size_t n, std::mt19937 &rng) {
+  std::uniform_real_distribution<float> ud(-4.0f, 4.0f);
+  std::vector<float> v(n);
+  for (auto &x : v)
+    x = ud(rng);
+  return v;
+}
+
+float max_diff(const std::vector<float> &a, const std::vector<float> &b) {
+  float d = 0.0f;
+  for (std::size_t i = 0; i < a.size(); i++)
+    d = std::max(d, std::abs(a[i] - b[i]));
+  return d;
+}
+
+struct Outputs {
+  std::vector<float> bias, sums, relu, drelu, softmax, axpy;
+};
+
+// Runs every kernel of `k` once, storing results in `out`, and prints the
+// per-kernel bandwidth in GB/s.
+void run_tier(const simd::KernelTable &k, const std::vector<float> &X,
+              const std::vector<float> &b, Outputs &out) {
+  const double bytes = N * sizeof(float);
+  std::vector<std::uint8_t> mask(N);
+
+  out.bias = X;
+  const double t_bias = Bench::best_of(20, [&] {
+    k.add_bias(b.data(), out.bias.data(), ROWS, COLS, COLS);
+  });
+  out.bias = X;
+  k.add_bias(b.data(), out.bias.data(), ROWS, COLS, COLS);
+
+  out.sums.resize(COLS);
+  const double t_sum = Bench::best_of(
+      20, [&] { k.sum_rows(X.data(), ROWS, COLS, COLS, out.sums.data()); });
+
+  out.relu.resize(N);
+  const double t_relu = Bench::best_of(20, [&] {
+    k.relu_forward(X.data(), out.relu.data(), mask.data(), N);
+  });
+
+  out.drelu.resize(N);
+  const double t_drelu = Bench::best_of(20, [&] {
+    k.relu_backward(X.data(), mask.data(), out.drelu.data(), N);
+  });
+
+  out.softmax.resize(N);
+  const double t_softmax = Bench::best_of(20, [&] {
+    for (std::size_t i = 0; i < ROWS; i++)
+      k.softmax_row(X.data() + i * COLS, out.softmax.data() + i * COLS, COLS,
+                    simd::MathMode::Accurate);
+  });
+
+  out.axpy = X;
+  const double t_axpy = Bench::best_of(
+      20, [&] { k.axpy(-0.05f, X.data(), out.axpy.data(), N); });
+  out.axpy = X;
+  k.axpy(-0.05f, X.data(), out.axpy.data(), N);
+
+  std::printf("%-8s bias %6.1f  sum_rows %6.1f  relu %6.1f  relu_bwd %6.1f  "
+              "softmax %6.1f  axpy %6.1f GB/s\n",
+              k.name, 2 * bytes / t_bias * 1e-9, bytes / t_sum * 1e-9,
+              2 * bytes / t_relu * 1e-9, 2 * bytes / t_drelu * 1e-9,
+              2 * bytes / t_softmax * 1e-9, 3 * bytes / t_axpy * 1e-9);
+}
+} // namespace
+
+int main() {
+  std::mt19937 rng(7);
+  const auto X = random_vector(N, rng);
+  const auto b = random_vector(COLS, rng);
+
+  std::printf("detected tier: %s\n",
+              simd::TierName(simd::DetectedTier()));
+
+  Outputs ref;
+  simd::ForceTier(simd::Tier::Scalar);
+  run_tier(simd::Kernels(), X, b, ref);
+
+  for (auto tier : {simd::Tier::SSE42, simd::Tier::AVX2, simd::Tier::AVX512}) {
+    if (tier > simd::DetectedTier())
+      break;
+    simd::ForceTier(tier);
+
+    Outputs out;
+    run_tier(simd::Kernels(), X, b, out);
+    std::printf("         max |diff| vs scalar: bias %.1e sum_rows %.1e relu "
+                "%.1e relu_bwd %.1e softmax %.1e axpy %.1e\n",
+                max_diff(out.bias, ref.bias), max_diff(out.sums, ref.sums),
+                max_diff(out.relu, ref.relu), max_diff(out.drelu, ref.drelu),
+                max_diff(out.softmax, ref.softmax),
+                max_diff(out.axpy, ref.axpy));
+  }
+}
@@ -0,0 +1,82 @@
+// Loss + logit gradient from 10 to 100K classes: Softmax into a
+// probabilities matrix followed by CrossEntropy, against the fused
+// SoftmaxCrossEntropy, on each SIMD tier the CPU supports. Losses are
+// compared with a double precision log-sum-exp; the unfused path clamps
+// probabilities at 1e-12, so it saturates once the label's share gets that
+// small. dgrad is the largest gradient difference between the two paths.
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "Functions.hpp"
+#include "Kernels/Simd.hpp"
+
+namespace Bench = Logos::Bench;
+namespace NN = Logos::NeuralNet;
+namespace simd = Logos::linalg::simd;
+using Logos::linalg::Matrix;
+
+namespace {
+// Elements per measurement; rows shrink as the class count grows.
+constexpr std::size_t ELEMENTS = std::size_t(1) << 22;
+
+double reference_loss(const Matrix<float> &logits,
+                      const std::vector<std::uint8_t> &labels) {
+  double total = 0.0;
+  for (std::size_t i = 0; i < logits.rows(); i++) {
+    double maxv = logits(i, 0), sum = 0.0;
+    for (std::size_t j = 0; j < logits.cols(); j++)
+      maxv = std::max(maxv, static_cast<double>(logits(i, j)));
+    for (std::size_t j = 0; j < logits.cols(); j++)
+      sum += std::exp(logits(i, j) - maxv);
+    total += maxv + std::log(sum) - logits(i, labels[i]);
+  }
+  return total / logits.rows();
+}
+} // namespace
+
+int main() {
+  std::mt19937 rng(12);
+
+  for (int t = 0; t <= static_cast<int>(simd::DetectedTier()); t++) {
+    const auto tier = simd::ForceTier(static_cast<simd::Tier>(t));
+    std::printf("%s\n", simd::TierName(tier));
+    std::printf("  %7s %6s %11s %9s %8s %13s %11s %9s\n", "classes",
+                "rows", "unfused ms", "fused ms", "speedup", "unfused err",
+                "fused err", "dgrad");
+
+    for (const std::size_t classes : {10, 100, 1000, 10000, 100000}) {
+      const std::size_t rows = std::max<std::size_t>(8, ELEMENTS / classes);
+      Matrix<float> logits(rows, classes);
+      std::normal_distribution<float> nd(0.0f, 4.0f);
+      for (std::size_t i = 0; i < logits.size(); i++)
+        logits.data()[i] = nd(rng);
+      // uint8 labels: spread over the first 256 classes
+      std::vector<std::uint8_t> labels(rows);
+      for (std::size_t i = 0; i < rows; i++)
+        labels[i] = static_cast<std::uint8_t>(rng() % std::min<std::size_t>(
+                                                         classes, 256));
+
+      Matrix<float> probs, grad_unfused, grad;
+      float loss_unfused = 0.0f, loss = 0.0f;
+      const std::size_t reps =
+          Bench::reps_for(static_cast<double>(rows * classes) * 20);
+      const double unfused = Bench::best_of(reps, [&] {
+        NN::Softmax<float>(logits, probs);
+        loss_unfused = NN::CrossEntropy<float>(probs, labels, grad_unfused);
+      });
+      const double fused = Bench::best_of(reps, [&] {
+        loss = NN::SoftmaxCrossEntropy<float>(logits, labels, grad);
+      });
+
+      const double exact = reference_loss(logits, labels);
+      std::printf("  %7zu %6zu %11.3f %9.3f %7.2fx %13.2e %11.2e %9.2e\n",
+                  classes, rows, unfused * 1e3, fused * 1e3, unfused / fused,
+                  std::abs(loss_unfused - exact) / exact,
+                  std::abs(loss - exact) / exact,
+                  Bench::max_abs_diff(grad, grad_unfused));
+    }
+  }
+}
@@ -0,0 +1,51 @@
+// Inference latency of the 784 -> 256 -> 10 MNIST model at small batches:
+// the dynamic Sequential (general GEMM with packing, fused LinearReLU)
+// against StaticMLP, whose layer shapes are template parameters. Both hold
+// the same weights; "max diff" is the largest logit difference. Runs on
+// each SIMD tier the CPU supports.
+
+#include <cstdio>
+
+#include "BenchCommon.hpp"
+#include "Kernels/Simd.hpp"
+#include "NeuralNetwork.hpp"
+#include "StaticMLP.hpp"
+
+namespace Bench = Logos::Bench;
+namespace NN = Logos::NeuralNet;
+namespace simd = Logos::linalg::simd;
+using Logos::linalg::Matrix;
+
+namespace {
+constexpr std::size_t IN = 784, HIDDEN = 256, CLASSES = 10;
+} // namespace
+
+int main() {
+  std::mt19937 rng(17);
+  auto dynamic = NN::MakeMLP(IN, HIDDEN, CLASSES, rng);
+  NN::StaticMLP<IN, HIDDEN, CLASSES> fixed;
+  fixed.CopyParametersFrom(dynamic);
+
+  Matrix<float> X(256, IN), out_dynamic, out_fixed;
+  Bench::fill_random(X, rng);
+
+  for (int t = 0; t <= static_cast<int>(simd::DetectedTier()); t++) {
+    const auto tier = simd::ForceTier(static_cast<simd::Tier>(t));
+    std::printf("%s\n  %5s %12s %12s %8s %9s\n", simd::TierName(tier),
+                "batch", "dynamic us", "static us", "speedup", "max diff");
+
+    for (const std::size_t batch : {1, 2, 4, 8, 16, 32, 64, 256}) {
+      const auto Xb = Logos::linalg::ConstMatrixView<float>(X).row_range(
+          0, batch);
+      const double flops = 2.0 * batch * (IN * HIDDEN + HIDDEN * CLASSES);
+      const auto reps = Bench::reps_for(flops, 2e8);
+
+      const double d = Bench::best_of(
+          reps, [&] { dynamic.Forward(Xb, out_dynamic); });
+      const double s =
+          Bench::best_of(reps, [&] { fixed.Forward(Xb, out_fixed); });
+      std::printf("  %5zu %12.2f %12.2f %7.2fx %9.1e\n", batch, d * 1e6,
+                  s * 1e6, d / s, Bench::max_abs_diff(out_dynamic, out_fixed));
+    }
+  }
+}
@@ -0,0 +1,84 @@
+// Heap allocations per MLP training step once the workspace is planned, and
+// the planned workspace size against one buffer per activation/gradient.
+// Allocations are counted through the global operator new plus the aligned
+// allocations made by Memory::Buffer.
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "BenchCommon.hpp"
+#include "NeuralNetwork.hpp"
+#include "Threading/ThreadPool.hpp"
+
+namespace Bench = Logos::Bench;
+namespace NN = Logos::NeuralNet;
+using Logos::Memory::Buffer;
+
+namespace {
+std::atomic<std::uint64_t> s_NewCalls{0};
+
+std::uint64_t allocations() {
+  return s_NewCalls.load(std::memory_order_relaxed) + Buffer::AllocationCount();
+}
+} // namespace
+
+// Kept out of line: once inlined, GCC sees malloc() paired with operator
+// delete, or a new-expression paired with free(), and warns
+// (-Wmismatched-new-delete).
+[[gnu::noinline]] void *operator new(std::size_t size) {
+  s_NewCalls.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+[[gnu::noinline]] void operator delete(void *p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void *p, std::size_t) noexcept {
+  std::free(p);
+}
+
+int main() {
+  constexpr std::size_t IN = 784, HIDDEN = 256, CLASSES = 10, STEPS = 200;
+
+  // Build the pool up front so its threads are not counted.
+  Logos::Threading::ThreadPool::Global();
+
+  std::mt19937 rng(3);
+  auto model = NN::MakeMLP(IN, HIDDEN, CLASSES, rng);
+
+  for (const std::size_t batch : {64, 256}) {
+    NN::Matrix X(batch, IN);
+    Bench::fill_random(X, rng);
+    std::vector<std::uint8_t> y(batch);
+    for (std::size_t i = 0; i < batch; i++)
+      y[i] = static_cast<std::uint8_t>(i % CLASSES);
+
+    const auto before_warmup = allocations();
+    model.TrainStep(X, y, 0.01);
+    const auto warmup = allocations() - before_warmup;
+
+    const auto before = allocations();
+    for (std::size_t s = 0; s < STEPS; s++)
+      model.TrainStep(X, y, 0.01);
+    const auto steady = allocations() - before;
+
+    // A smaller tail batch reuses a prefix of the planned slots.
+    const auto before_tail = allocations();
+    model.TrainStep(NN::ConstMatrixView(X).row_range(0, batch / 2),
+                    NN::Labels(y).first(batch / 2), 0.01);
+    const auto tail = allocations() - before_tail;
+
+    const auto &plan = model.WorkspaceLayout();
+    std::printf("batch %4zu: first step %3llu allocs, next %zu steps %llu "
+                "allocs, half batch %llu allocs\n",
+                batch, static_cast<unsigned long long>(warmup), STEPS,
+                static_cast<unsigned long long>(steady),
+                static_cast<unsigned long long>(tail));
+    std::printf("  workspace peak %.1f KiB, without reuse %.1f KiB\n",
+                plan.peak_bytes() / 1024.0, plan.total_bytes() / 1024.0);
+    for (std::size_t id = 0; id < plan.size(); id++)
+      std::printf("    %-18s %8.1f KiB @ %8zu\n", plan.name(id),
+                  plan.bytes(id) / 1024.0, plan.offset(id));
+  }
+}
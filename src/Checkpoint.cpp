@@ -0,0 +1,291 @@
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "Checkpoint.hpp"
+#include "Data/TensorFile.hpp"
+#include "Memory/MemoryUtility.hpp"
+
+namespace Logos::NeuralNet {
+
+namespace {
+
+// Page size: the parameters of a mapped file can back the model directly.
+constexpr std::size_t ALIGNMENT = 4096;
+
+void Validate(const CheckpointHeader &h, std::size_t file_bytes,
+              const std::string &path) {
+  auto fail = [&](const char *what) {
+    throw std::runtime_error("Invalid checkpoint " + path + ": " + what);
+  };
+
+  if (std::memcmp(h.magic, CheckpointHeader::MAGIC, sizeof(h.magic)) != 0)
+    fail("bad magic");
+  if (h.version != CheckpointHeader::VERSION)
+    fail("unsupported version");
+  if (!Memory::IsPow2(h.alignment) || h.alignment > ALIGNMENT ||
+      h.alignment < Memory::DEFAULT_ALIGNMENT)
+    fail("bad alignment");
+  for (const auto *s : {&h.table, &h.params, &h.state, &h.rng}) {
+    if (s->offset < sizeof(CheckpointHeader) || s->offset % h.alignment)
+      fail("bad section offset");
+    // Not offset + bytes, which a crafted header can wrap around.
+    if (s->offset > file_bytes || s->bytes > file_bytes - s->offset)
+      fail("truncated");
+  }
+  if (h.table.bytes != h.tensors * sizeof(std::uint64_t))
+    fail("tensor table does not match tensor count");
+  if (h.params.bytes % sizeof(float) || h.state.bytes % sizeof(float))
+    fail("section size is not a whole number of floats");
+}
+
+// Flushes a file or directory to the device. Without it a power loss after
+// the rename can leave the new name pointing at unwritten blocks, or undo
+// the rename itself.
+void SyncToDisk(const std::string &path) {
+#if !defined(_WIN32)
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Cannot open: " + path);
+  const int rc = ::fsync(fd);
+  ::close(fd);
+  if (rc != 0)
+    throw std::runtime_error("fsync failed: " + path);
+#else
+  (void)path;
+#endif
+}
+
+// Streams sections to a file at their offsets, zero-filling the gaps, and
+// keeps the CRC of everything after the header.
+class SectionWriter {
+public:
+  explicit SectionWriter(const std::string &path)
+      : m_Out(path, std::ios::binary), m_Path(path) {
+    if (!m_Out)
+      throw std::runtime_error("Cannot open: " + path);
+    m_Out.seekp(sizeof(CheckpointHeader));
+    m_Pos = sizeof(CheckpointHeader);
+  }
+
+  void Write(const CheckpointHeader::Section &s, const void *data) {
+    const std::string pad(s.offset - m_Pos, '\0');
+    Put(pad.data(), pad.size());
+    Put(data, s.bytes);
+  }
+
+  void Finish(CheckpointHeader &h) {
+    h.checksum = m_Crc;
+    m_Out.seekp(0);
+    m_Out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    m_Out.close();
+    if (!m_Out)
+      throw std::runtime_error("Failed writing: " + m_Path);
+  }
+
+private:
+  void Put(const void *data, std::size_t bytes) {
+    if (bytes == 0)
+      return;
+    m_Crc = Data::Crc32(data, bytes, m_Crc);
+    m_Out.write(static_cast<const char *>(data),
+                static_cast<std::streamsize>(bytes));
+    m_Pos += bytes;
+  }
+
+  std::ofstream m_Out;
+  std::string m_Path;
+  std::size_t m_Pos = 0;
+  std::uint32_t m_Crc = 0;
+};
+} // namespace
+
+void CheckpointSnapshot::Capture(Sequential<float> &model,
+                                 const TrainingState &progress) {
+  input_dim = model.InputDim();
+  sizes.clear();
+  for (const auto p : model.Parameters())
+    sizes.push_back(p.size());
+
+  const auto flat = model.FlatParameters();
+  params.assign(flat.begin(), flat.end());
+
+  Optimizer &opt = model.optimizer();
+  state.assign(opt.state().begin(), opt.state().end());
+  optimizer = opt.options().kind;
+  optimizer_steps = opt.steps();
+  training = progress;
+}
+
+void WriteCheckpoint(const std::string &path, const CheckpointSnapshot &s) {
+  std::ostringstream rng;
+  rng << s.training.rng;
+  const std::string rng_text = rng.str();
+
+  CheckpointHeader h{};
+  std::memcpy(h.magic, CheckpointHeader::MAGIC, sizeof(h.magic));
+  h.version = CheckpointHeader::VERSION;
+  h.alignment = static_cast<std::uint32_t>(ALIGNMENT);
+  h.tensors = static_cast<std::uint32_t>(s.sizes.size());
+  h.optimizer = s.optimizer;
+  h.input_dim = s.input_dim;
+  h.epoch = s.training.epoch;
+  h.learning_rate = s.training.learning_rate;
+  h.optimizer_steps = s.optimizer_steps;
+
+  std::size_t end = sizeof(CheckpointHeader);
+  auto place = [&](CheckpointHeader::Section &section, std::size_t bytes) {
+    section.offset = Memory::AlignUp(end, ALIGNMENT);
+    section.bytes = bytes;
+    end = section.offset + bytes;
+  };
+  place(h.table, s.sizes.size() * sizeof(std::uint64_t));
+  place(h.params, s.params.size() * sizeof(float));
+  place(h.state, s.state.size() * sizeof(float));
+  place(h.rng, rng_text.size());
+
+  const std::string tmp = path + ".tmp";
+  SectionWriter out(tmp);
+  out.Write(h.table, s.sizes.data());
+  out.Write(h.params, s.params.data());
+  out.Write(h.state, s.state.data());
+  out.Write(h.rng, rng_text.data());
+  out.Finish(h);
+  SyncToDisk(tmp);
+  std::filesystem::rename(tmp, path);
+  const auto dir = std::filesystem::path(path).parent_path();
+  SyncToDisk(dir.empty() ? std::string(".") : dir.string());
+}
+
+void SaveCheckpoint(const std::string &path, Sequential<float> &model,
+                    const TrainingState &training) {
+  CheckpointSnapshot s;
+  s.Capture(model, training);
+  WriteCheckpoint(path, s);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+  if (m_Thread.joinable())
+    m_Thread.join();
+}
+
+void CheckpointWriter::Save(const std::string &path, Sequential<float> &model,
+                            const TrainingState &training) {
+  const auto t0 = std::chrono::steady_clock::now();
+  Wait();
+  m_Snapshot.Capture(model, training);
+  m_Thread = std::thread([this, path] {
+    try {
+      WriteCheckpoint(path, m_Snapshot);
+    } catch (...) {
+      m_Error = std::current_exception();
+    }
+  });
+  const std::chrono::duration<double> dt =
+      std::chrono::steady_clock::now() - t0;
+  m_BlockedSeconds += dt.count();
+  m_Saves++;
+}
+
+void CheckpointWriter::Wait() {
+  if (m_Thread.joinable())
+    m_Thread.join();
+  if (m_Error)
+    std::rethrow_exception(std::exchange(m_Error, nullptr));
+}
+
+MappedCheckpoint MappedCheckpoint::Open(const std::string &path,
+                                        bool verify_checksum) {
+  MappedCheckpoint c;
+  c.m_Path = path;
+  c.m_File = Memory::MappedFile::Open(path);
+  if (c.m_File.size() < sizeof(CheckpointHeader))
+    throw std::runtime_error("Invalid checkpoint " + path + ": too small");
+
+  std::memcpy(&c.m_Header, c.m_File.data(), sizeof(CheckpointHeader));
+  Validate(c.m_Header, c.m_File.size(), path);
+
+  if (verify_checksum && !c.VerifyChecksum())
+    throw std::runtime_error("Checksum mismatch: " + path);
+  return c;
+}
+
+std::span<float> MappedCheckpoint::params() noexcept {
+  return {reinterpret_cast<float *>(Section(m_Header.params)),
+          m_Header.params.bytes / sizeof(float)};
+}
+
+std::span<const float> MappedCheckpoint::params() const noexcept {
+  return {reinterpret_cast<const float *>(Section(m_Header.params)),
+          m_Header.params.bytes / sizeof(float)};
+}
+
+std::span<const float> MappedCheckpoint::state() const noexcept {
+  return {reinterpret_cast<const float *>(Section(m_Header.state)),
+          m_Header.state.bytes / sizeof(float)};
+}
+
+TrainingState MappedCheckpoint::training() const {
+  TrainingState t;
+  t.epoch = m_Header.epoch;
+  t.learning_rate = m_Header.learning_rate;
+  std::istringstream rng(
+      std::string(Section(m_Header.rng), m_Header.rng.bytes));
+  rng >> t.rng;
+  if (!rng)
+    throw std::runtime_error("Invalid checkpoint " + m_Path +
+                             ": bad RNG state");
+  return t;
+}
+
+void MappedCheckpoint::CheckShape(Sequential<float> &model) const {
+  const auto *sizes =
+      reinterpret_cast<const std::uint64_t *>(Section(m_Header.table));
+  const auto params = model.Parameters();
+  bool same = model.InputDim() == m_Header.input_dim &&
+              params.size() == m_Header.tensors &&
+              model.FlatParameters().size() ==
+                  m_Header.params.bytes / sizeof(float);
+  for (std::size_t t = 0; same && t < params.size(); t++)
+    same = params[t].size() == sizes[t];
+  if (!same)
+    throw std::runtime_error("Checkpoint " + m_Path +
+                             " is for a different model");
+}
+
+void MappedCheckpoint::MapInto(Sequential<float> &model) {
+  CheckShape(model);
+  model.MapParameters(params());
+}
+
+bool MappedCheckpoint::RestoreInto(Sequential<float> &model) const {
+  CheckShape(model);
+  const auto src = params();
+  std::copy(src.begin(), src.end(), model.FlatParameters().begin());
+  model.RefreshWeights();
+
+  Optimizer &opt = model.optimizer();
+  if (opt.options().kind != m_Header.optimizer) {
+    opt.Reset();
+    return false;
+  }
+  opt.Restore(state(), m_Header.optimizer_steps);
+  return true;
+}
+
+bool MappedCheckpoint::VerifyChecksum() const {
+  const auto *body =
+      static_cast<const char *>(m_File.data()) + sizeof(CheckpointHeader);
+  return Data::Crc32(body, m_File.size() - sizeof(CheckpointHeader)) ==
+         m_Header.checksum;
+}
+} // namespace Logos::NeuralNet
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Memory/MappedFile.hpp"
+#include "Optimizer.hpp"
+#include "Sequential.hpp"
+
+namespace Logos::NeuralNet {
+
+// Logos checkpoint file (.lgc): a 128-byte little-endian header followed by
+// four sections, each at a multiple of `alignment`:
+//   table   uint64 element count of every parameter tensor, in order
+//   params  the model's FlatParameters(): every tensor at its arena offset,
+//           zero padding between them
+//   state   the optimizer's state(), empty for SGD
+//   rng     the trainer's std::mt19937 in its text form
+// The parameters are page aligned so that a mapping of the file can serve
+// as the model's weights as is (MappedCheckpoint::MapInto).
+struct CheckpointHeader {
+  static constexpr char MAGIC[8] = {'L', 'O', 'G', 'O', 'S', 'C', 'K', 'P'};
+  static constexpr std::uint32_t VERSION = 1;
+
+  struct Section {
+    std::uint64_t offset, bytes;
+  };
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t alignment;
+  std::uint32_t tensors;
+  OptimizerKind optimizer;
+  std::uint8_t reserved0[3];
+  std::uint64_t input_dim;
+  std::uint64_t epoch;  // epochs completed
+  double learning_rate; // of the next epoch
+  std::uint64_t optimizer_steps;
+  Section table, params, state, rng;
+  std::uint64_t checksum; // CRC-32 of every byte after the header
+};
+static_assert(sizeof(CheckpointHeader) == 128);
+
+// Where training stands apart from the weights and the optimizer.
+struct TrainingState {
+  std::uint64_t epoch = 0;
+  double learning_rate = 0.0;
+  std::mt19937 rng;
+};
+
+// Everything a checkpoint holds, copied out of a model so that it can be
+// written while training goes on.
+struct CheckpointSnapshot {
+  std::size_t input_dim = 0;
+  std::vector<std::uint64_t> sizes;
+  std::vector<float> params, state;
+  OptimizerKind optimizer = OptimizerKind::SGD;
+  std::uint64_t optimizer_steps = 0;
+  TrainingState training;
+
+  // Copies from `model`, reusing the vectors' storage.
+  void Capture(Sequential<float> &model, const TrainingState &progress);
+};
+
+// Writes `path` through a temporary file renamed over it at the end, so a
+// crash mid-write leaves the previous checkpoint intact. The file is synced
+// before the rename and its directory after, so a checkpoint that has been
+// written survives a power loss too.
+void WriteCheckpoint(const std::string &path, const CheckpointSnapshot &s);
+
+// Capture + WriteCheckpoint on the calling thread.
+void SaveCheckpoint(const std::string &path, Sequential<float> &model,
+                    const TrainingState &training);
+
+// Checkpoints written on a background thread. Save() blocks only while it
+// copies the model into a snapshot; the file is written after it returns.
+// One save is in flight at a time, so Save() first waits for the previous.
+class CheckpointWriter {
+public:
+  CheckpointWriter() = default;
+  // Waits for the save in flight; its error, if any, is lost.
+  ~CheckpointWriter();
+
+  CheckpointWriter(const CheckpointWriter &) = delete;
+  CheckpointWriter &operator=(const CheckpointWriter &) = delete;
+
+  void Save(const std::string &path, Sequential<float> &model,
+            const TrainingState &training);
+
+  // Waits for the save in flight and rethrows its error.
+  void Wait();
+
+  // Time the caller spent in Save() over all saves, and their number.
+  double BlockedSeconds() const noexcept { return m_BlockedSeconds; }
+  std::size_t saves() const noexcept { return m_Saves; }
+
+private:
+  CheckpointSnapshot m_Snapshot;
+  std::thread m_Thread;
+  std::exception_ptr m_Error;
+  double m_BlockedSeconds = 0.0;
+  std::size_t m_Saves = 0;
+};
+
+// A checkpoint file opened through a Memory::MappedFile. Opening reads the
+// header only; the checksum is verified on request since it touches every
+// page.
+class MappedCheckpoint {
+public:
+  MappedCheckpoint() = default;
+
+  static MappedCheckpoint Open(const std::string &path,
+                               bool verify_checksum = false);
+
+  const CheckpointHeader &header() const noexcept { return m_Header; }
+  bool is_mapped() const noexcept { return m_File.is_mapped(); }
+
+  // The flat parameters. The mapping is private: writes never reach the
+  // file.
+  std::span<float> params() noexcept;
+  std::span<const float> params() const noexcept;
+  std::span<const float> state() const noexcept;
+  TrainingState training() const;
+
+  // Makes the mapped parameters `model`'s weights without a copy
+  // (Sequential::MapParameters); *this must outlive the model. Load time
+  // does not depend on the model's size: pages are read as the first
+  // forward touches them.
+  void MapInto(Sequential<float> &model);
+
+  // Copies the parameters into `model` to resume training, together with
+  // the optimizer state when `model`'s optimizer is of the saved kind.
+  // Returns whether the state was restored.
+  bool RestoreInto(Sequential<float> &model) const;
+
+  bool VerifyChecksum() const;
+
+private:
+  // Throws unless `model` has the saved architecture.
+  void CheckShape(Sequential<float> &model) const;
+  const char *Section(const CheckpointHeader::Section &s) const noexcept {
+    return static_cast<const char *>(m_File.data()) + s.offset;
+  }
+  char *Section(const CheckpointHeader::Section &s) noexcept {
+    return static_cast<char *>(m_File.data()) + s.offset;
+  }
+
+  CheckpointHeader m_Header{};
+  Memory::MappedFile m_File;
+  std::string m_Path;
+};
+} // namespace Logos::NeuralNet
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+
+#include "Data/BatchPipeline.hpp"
+
+namespace Logos::Data {
+
+BatchPipeline::BatchPipeline(const ImageSet &imgs,
+                             const std::vector<std::uint8_t> &labels,
+                             std::size_t batch_size, std::uint64_t seed,
+                             std::size_t depth, Augment augment)
+    : m_Imgs(imgs), m_Labels(labels), m_BatchSize(batch_size),
+      m_Augment(std::move(augment)), m_RNG(static_cast<std::uint32_t>(seed)) {
+  if (batch_size == 0)
+    throw std::invalid_argument("BatchPipeline: batch_size must be > 0");
+  if (labels.size() != imgs.rows())
+    throw std::invalid_argument("BatchPipeline: labels size mismatch");
+
+  m_Order.resize(imgs.rows());
+  std::iota(m_Order.begin(), m_Order.end(), 0);
+
+  const std::size_t rows = std::min(batch_size, imgs.rows());
+  m_Ring.resize(std::max<std::size_t>(depth, 2));
+  for (auto &batch : m_Ring) {
+    batch.X = Matrix(rows, imgs.cols());
+    batch.y.resize(rows);
+    batch.indices.resize(rows);
+  }
+
+  m_Producer = std::thread([this] { ProducerMain(); });
+}
+
+BatchPipeline::~BatchPipeline() {
+  {
+    std::lock_guard lock(m_Mutex);
+    m_Stop = true;
+  }
+  m_Consumed.notify_all();
+  m_Producer.join();
+}
+
+void BatchPipeline::BeginEpoch() { Begin(std::nullopt); }
+
+void BatchPipeline::BeginEpoch(std::uint64_t seed) { Begin(seed); }
+
+void BatchPipeline::Begin(std::optional<std::uint64_t> seed) {
+  {
+    std::lock_guard lock(m_Mutex);
+    if (!m_EpochDone || m_Ready != 0)
+      throw std::logic_error("BatchPipeline: previous epoch not drained");
+    m_EpochDone = false;
+    m_Epoch++;
+    m_Seed = seed;
+  }
+  m_StallSeconds = 0.0;
+  m_Served = 0;
+  m_Consumed.notify_all();
+}
+
+const BatchPipeline::Batch *BatchPipeline::Next() {
+  std::unique_lock lock(m_Mutex);
+  if (m_Holding) {
+    m_Holding = false;
+    m_Consumed.notify_all();
+  }
+
+  if (m_Ready == 0 && !m_EpochDone) {
+    const auto t0 = std::chrono::steady_clock::now();
+    m_Produced.wait(lock, [this] { return m_Ready != 0 || m_EpochDone; });
+    const std::chrono::duration<double> waited =
+        std::chrono::steady_clock::now() - t0;
+    m_StallSeconds += waited.count();
+  }
+  if (m_Ready == 0)
+    return nullptr;
+
+  const Batch *batch = &m_Ring[m_Tail];
+  m_Tail = (m_Tail + 1) % m_Ring.size();
+  m_Ready--;
+  m_Holding = true;
+  m_Served++;
+  return batch;
+}
+
+void BatchPipeline::ProducerMain() {
+  std::uint64_t epoch = 0;
+  for (;;) {
+    std::optional<std::uint64_t> seed;
+    {
+      std::unique_lock lock(m_Mutex);
+      m_Consumed.wait(lock, [&] { return m_Stop || m_Epoch != epoch; });
+      if (m_Stop)
+        return;
+      epoch = m_Epoch;
+      seed = m_Seed;
+    }
+
+    if (seed) {
+      m_RNG.seed(static_cast<std::uint32_t>(*seed));
+      std::iota(m_Order.begin(), m_Order.end(), 0);
+    }
+    std::shuffle(m_Order.begin(), m_Order.end(), m_RNG);
+
+    const std::size_t N = m_Order.size();
+    for (std::size_t first = 0; first < N; first += m_BatchSize) {
+      std::size_t slot;
+      {
+        std::unique_lock lock(m_Mutex);
+        m_Consumed.wait(lock, [this] {
+          return m_Stop || m_Ready + (m_Holding ? 1 : 0) < m_Ring.size();
+        });
+        if (m_Stop)
+          return;
+        slot = m_Head;
+      }
+
+      Batch &batch = m_Ring[slot];
+      Gather(batch, first, std::min(m_BatchSize, N - first));
+      if (m_Augment)
+        m_Augment(batch.X, m_RNG);
+
+      {
+        std::lock_guard lock(m_Mutex);
+        m_Head = (m_Head + 1) % m_Ring.size();
+        m_Ready++;
+      }
+      m_Produced.notify_one();
+    }
+
+    {
+      std::lock_guard lock(m_Mutex);
+      m_EpochDone = true;
+    }
+    m_Produced.notify_one();
+  }
+}
+
+void BatchPipeline::Gather(Batch &batch, std::size_t first, std::size_t rows) {
+  // Only the last batch of an epoch can be short; it gets its own shape.
+  batch.indices.assign(m_Order.begin() + first, m_Order.begin() + first + rows);
+  m_Imgs.Gather(batch.indices, batch.X);
+
+  batch.y.resize(rows);
+  for (std::size_t i = 0; i < rows; i++)
+    batch.y[i] = m_Labels[batch.indices[i]];
+}
+
+BatchPipeline::Augment RandomShift(std::size_t height, std::size_t width,
+                                   int max_shift) {
+  return [height, width, max_shift,
+          tmp = std::vector<float>(height * width)](
+             BatchPipeline::Matrix &X, std::mt19937 &rng) mutable {
+    assert(X.cols() == height * width);
+
+    std::uniform_int_distribution<int> shift(-max_shift, max_shift);
+    const auto H = static_cast<std::ptrdiff_t>(height),
+               W = static_cast<std::ptrdiff_t>(width);
+
+    for (std::size_t r = 0; r < X.rows(); r++) {
+      const std::ptrdiff_t dy = shift(rng), dx = shift(rng);
+      float *img = X.data() + r * X.leading_dim();
+      std::copy(img, img + height * width, tmp.begin());
+
+      for (std::ptrdiff_t y = 0; y < H; y++) {
+        const std::ptrdiff_t sy = y - dy;
+        for (std::ptrdiff_t x = 0; x < W; x++) {
+          const std::ptrdiff_t sx = x - dx;
+          img[y * W + x] = (sy >= 0 && sy < H && sx >= 0 && sx < W)
+                               ? tmp[static_cast<std::size_t>(sy * W + sx)]
+                               : 0.0f;
+        }
+      }
+    }
+  };
+}
+} // namespace Logos::Data
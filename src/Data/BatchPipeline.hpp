@@ -0,0 +1,98 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Data/ImageSet.hpp"
+#include "Matrix.inl"
+
+namespace Logos::Data {
+
+// Producer/consumer batch assembly. A background thread shuffles the epoch
+// order, gathers rows into a ring of preallocated batches and optionally
+// augments them, so batch N + 1 is ready by the time training on batch N
+// finishes.
+class BatchPipeline {
+public:
+  using Matrix = linalg::Matrix<float>;
+
+  struct Batch {
+    Matrix X;
+    std::vector<std::uint8_t> y;
+    std::vector<std::size_t> indices; // dataset rows, in batch order
+  };
+
+  // Runs on the producer thread after a batch is gathered; must not throw.
+  using Augment = std::function<void(Matrix &X, std::mt19937 &rng)>;
+
+  // `imgs` and `labels` must outlive the pipeline. depth is the number of
+  // batches in flight, at least 2.
+  BatchPipeline(const ImageSet &imgs, const std::vector<std::uint8_t> &labels,
+                std::size_t batch_size, std::uint64_t seed,
+                std::size_t depth = 2, Augment augment = {});
+  ~BatchPipeline();
+
+  BatchPipeline(const BatchPipeline &) = delete;
+  BatchPipeline &operator=(const BatchPipeline &) = delete;
+
+  // Reshuffles and starts producing the next epoch. The previous epoch must
+  // have been drained (Next() returned nullptr).
+  void BeginEpoch();
+
+  // Same, but the epoch first reseeds the shuffle and augmentation RNG with
+  // `seed` and shuffles from the dataset order, so what it produces depends
+  // on `seed` alone. A run resumed from a checkpoint replays the epochs of
+  // an uninterrupted one if it passes the same seeds.
+  void BeginEpoch(std::uint64_t seed);
+
+  // Next batch of the epoch, nullptr once it is exhausted. The batch stays
+  // valid until the following call. Time spent waiting on the producer is
+  // added to StallSeconds().
+  const Batch *Next();
+
+  // Consumer wait time and batch count since the last BeginEpoch().
+  double StallSeconds() const noexcept { return m_StallSeconds; }
+  std::size_t BatchesServed() const noexcept { return m_Served; }
+
+private:
+  void Begin(std::optional<std::uint64_t> seed);
+  void ProducerMain();
+  void Gather(Batch &batch, std::size_t first, std::size_t rows);
+
+  const ImageSet &m_Imgs;
+  const std::vector<std::uint8_t> &m_Labels;
+  const std::size_t m_BatchSize;
+  Augment m_Augment;
+
+  std::mt19937 m_RNG;
+  std::vector<std::size_t> m_Order;
+  std::vector<Batch> m_Ring;
+
+  // Ring state, guarded by m_Mutex. Slots [m_Tail, m_Tail + m_Ready) are
+  // filled and waiting for the consumer; the one at m_Tail - 1 may be held
+  // by it.
+  std::mutex m_Mutex;
+  std::condition_variable m_Produced, m_Consumed;
+  std::size_t m_Head = 0, m_Tail = 0, m_Ready = 0;
+  std::uint64_t m_Epoch = 0;
+  std::optional<std::uint64_t> m_Seed; // of epoch m_Epoch, if reseeded
+  bool m_EpochDone = true, m_Holding = false, m_Stop = false;
+
+  double m_StallSeconds = 0.0;
+  std::size_t m_Served = 0;
+
+  std::thread m_Producer;
+};
+
+// Random translation by up to max_shift pixels in each direction for rows
+// holding height x width images; vacated pixels become 0.
+BatchPipeline::Augment RandomShift(std::size_t height, std::size_t width,
+                                   int max_shift);
+} // namespace Logos::Data
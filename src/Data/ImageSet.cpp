@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <cassert>
+
+#include "Data/ImageSet.hpp"
+#include "Kernels/Simd.hpp"
+
+namespace Logos::Data {
+
+ImageSet::ImageSet(FloatMatrix features)
+    : m_DType(DType::F32), m_Rows(features.rows()), m_Cols(features.cols()),
+      m_Features(std::move(features)) {}
+
+ImageSet::ImageSet(ByteMatrix pixels, PixelTransform transform)
+    : m_DType(DType::U8), m_Rows(pixels.rows()), m_Cols(pixels.cols()),
+      m_Pixels(std::move(pixels)), m_Transform(transform) {}
+
+ImageSet ImageSet::View(const FloatMatrix &features) {
+  return ImageSet(FloatMatrix::Wrap(const_cast<float *>(features.data()),
+                                    features.rows(), features.cols(),
+                                    features.leading_dim()));
+}
+
+void ImageSet::Row(std::size_t index, float *out) const {
+  assert(index < m_Rows);
+  if (m_DType == DType::U8) {
+    linalg::simd::Kernels().u8_to_f32(
+        m_Pixels.data() + index * m_Pixels.leading_dim(), out, m_Cols,
+        m_Transform.scale, m_Transform.shift);
+    return;
+  }
+
+  const float *src = m_Features.data() + index * m_Features.leading_dim();
+  std::copy(src, src + m_Cols, out);
+}
+
+void ImageSet::Gather(std::span<const std::size_t> indices, float *out,
+                      std::size_t ld) const {
+  if (m_DType == DType::U8) {
+    const auto convert = linalg::simd::Kernels().u8_to_f32;
+    const std::size_t src_ld = m_Pixels.leading_dim();
+    for (std::size_t i = 0; i < indices.size(); i++) {
+      assert(indices[i] < m_Rows);
+      convert(m_Pixels.data() + indices[i] * src_ld, out + i * ld, m_Cols,
+              m_Transform.scale, m_Transform.shift);
+    }
+    return;
+  }
+
+  for (std::size_t i = 0; i < indices.size(); i++)
+    Row(indices[i], out + i * ld);
+}
+
+linalg::ConstMatrixView<float>
+ImageSet::Slice(std::size_t first, std::size_t count,
+                FloatMatrix &scratch) const {
+  assert(first + count <= m_Rows);
+  if (m_DType == DType::F32)
+    return linalg::ConstMatrixView<float>(m_Features).row_range(first, count);
+
+  if (scratch.rows() != count || scratch.cols() != m_Cols)
+    scratch = FloatMatrix(count, m_Cols);
+  const auto convert = linalg::simd::Kernels().u8_to_f32;
+  for (std::size_t i = 0; i < count; i++)
+    convert(m_Pixels.data() + (first + i) * m_Pixels.leading_dim(),
+            scratch.data() + i * scratch.leading_dim(), m_Cols,
+            m_Transform.scale, m_Transform.shift);
+  return scratch;
+}
+
+void ImageSet::Gather(std::span<const std::size_t> indices,
+                      FloatMatrix &out) const {
+  if (out.rows() != indices.size() || out.cols() != m_Cols)
+    out = FloatMatrix(indices.size(), m_Cols);
+  Gather(indices, out.data(), out.leading_dim());
+}
+} // namespace Logos::Data
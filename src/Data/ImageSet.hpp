@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "Data/TensorFile.hpp"
+#include "Matrix.inl"
+#include "MatrixView.hpp"
+
+namespace Logos::Data {
+
+// Affine map applied to uint8 pixels on gather: x * scale + shift.
+struct PixelTransform {
+  float scale = 1.0f / 255.0f, shift = 0.0f;
+
+  // (x / 255 - mean) / stddev, with mean and stddev in [0, 1] units.
+  static PixelTransform Normalize(float mean, float stddev) {
+    return {1.0f / (255.0f * stddev), -mean / stddev};
+  }
+};
+
+// Dataset images, one per row. Stored either as float features or as raw
+// uint8 pixels (a quarter of the memory) that are widened and transformed
+// while gathering a batch.
+class ImageSet {
+public:
+  using FloatMatrix = linalg::Matrix<float>;
+  using ByteMatrix = linalg::Matrix<std::uint8_t>;
+
+  ImageSet() = default;
+  explicit ImageSet(FloatMatrix features);
+  explicit ImageSet(ByteMatrix pixels, PixelTransform transform = {});
+
+  // Non-owning set over `features`, which must outlive it.
+  static ImageSet View(const FloatMatrix &features);
+
+  std::size_t rows() const noexcept { return m_Rows; }
+  std::size_t cols() const noexcept { return m_Cols; }
+  DType dtype() const noexcept { return m_DType; }
+  std::size_t size_bytes() const noexcept {
+    return m_Rows * m_Cols * DTypeSize(m_DType);
+  }
+
+  const PixelTransform &transform() const noexcept { return m_Transform; }
+  void set_transform(PixelTransform transform) { m_Transform = transform; }
+
+  // out[i, :] = row indices[i] as float, for a caller-sized out with at least
+  // indices.size() rows and cols() columns.
+  void Gather(std::span<const std::size_t> indices, float *out,
+              std::size_t ld) const;
+  // Same, resizing out to indices.size() x cols() when needed.
+  void Gather(std::span<const std::size_t> indices, FloatMatrix &out) const;
+
+  // Rows [first, first + count) as float. Float storage is returned in
+  // place; uint8 storage is widened into `scratch` and a view of it returned.
+  linalg::ConstMatrixView<float> Slice(std::size_t first, std::size_t count,
+                                       FloatMatrix &scratch) const;
+
+  // Single row as float.
+  void Row(std::size_t index, float *out) const;
+
+private:
+  DType m_DType = DType::F32;
+  std::size_t m_Rows = 0, m_Cols = 0;
+  FloatMatrix m_Features;
+  ByteMatrix m_Pixels;
+  PixelTransform m_Transform;
+};
+} // namespace Logos::Data
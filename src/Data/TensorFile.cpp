@@ -0,0 +1,144 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "Data/TensorFile.hpp"
+
+namespace Logos::Data {
+
+namespace {
+
+constexpr std::size_t MAX_ALIGNMENT = 4096; // mappings are page aligned
+
+constexpr std::array<std::uint32_t, 256> MakeCrcTable() {
+  std::array<std::uint32_t, 256> table{};
+  for (std::uint32_t i = 0; i < 256; i++) {
+    std::uint32_t c = i;
+    for (int k = 0; k < 8; k++)
+      c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    table[i] = c;
+  }
+  return table;
+}
+constexpr auto CRC_TABLE = MakeCrcTable();
+
+void Validate(const TensorHeader &h, std::size_t file_bytes,
+              const std::string &path) {
+  auto fail = [&](const char *what) {
+    throw std::runtime_error("Invalid tensor file " + path + ": " + what);
+  };
+
+  if (std::memcmp(h.magic, TensorHeader::MAGIC, sizeof(h.magic)) != 0)
+    fail("bad magic");
+  if (h.version != TensorHeader::VERSION)
+    fail("unsupported version");
+  if (h.dtype != DType::F32 && h.dtype != DType::U8)
+    fail("unknown dtype");
+  if (h.rank != 1 && h.rank != 2)
+    fail("unsupported rank");
+  if (!Memory::IsPow2(h.alignment) || h.alignment > MAX_ALIGNMENT)
+    fail("bad alignment");
+  if (h.data_offset < sizeof(TensorHeader) || h.data_offset % h.alignment)
+    fail("bad data offset");
+  // Neither the shape's size nor the data's end may wrap around 64 bits,
+  // or a crafted header would describe more data than the file holds.
+  const std::uint64_t elem = DTypeSize(h.dtype);
+  if (h.cols != 0 && h.rows > SIZE_MAX / h.cols / elem)
+    fail("shape too large");
+  if (h.data_bytes != h.rows * h.cols * elem)
+    fail("size does not match shape");
+  if (h.data_offset > file_bytes || h.data_bytes > file_bytes - h.data_offset)
+    fail("truncated");
+}
+} // namespace
+
+std::size_t DTypeSize(DType dtype) {
+  switch (dtype) {
+  case DType::F32:
+    return sizeof(float);
+  case DType::U8:
+    return sizeof(std::uint8_t);
+  }
+  return 0;
+}
+
+const char *DTypeName(DType dtype) {
+  switch (dtype) {
+  case DType::F32:
+    return "f32";
+  case DType::U8:
+    return "u8";
+  }
+  return "?";
+}
+
+std::uint32_t Crc32(const void *data, std::size_t bytes, std::uint32_t crc) {
+  const auto *p = static_cast<const unsigned char *>(data);
+  crc = ~crc;
+  for (std::size_t i = 0; i < bytes; i++)
+    crc = CRC_TABLE[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+void WriteTensor(const std::string &path, DType dtype, std::size_t rows,
+                 std::size_t cols, const void *data, std::uint8_t rank,
+                 std::size_t alignment) {
+  if (!Memory::IsPow2(alignment) || alignment > MAX_ALIGNMENT)
+    throw std::logic_error("WriteTensor: bad alignment");
+
+  TensorHeader h{};
+  std::memcpy(h.magic, TensorHeader::MAGIC, sizeof(h.magic));
+  h.version = TensorHeader::VERSION;
+  h.alignment = static_cast<std::uint32_t>(alignment);
+  h.data_offset =
+      static_cast<std::uint32_t>(Memory::AlignUp(sizeof(h), alignment));
+  h.dtype = dtype;
+  h.rank = rank;
+  h.rows = rows;
+  h.cols = cols;
+  h.data_bytes = rows * cols * DTypeSize(dtype);
+  h.checksum = Crc32(data, h.data_bytes);
+
+  std::ofstream out(path, std::ios::binary);
+  if (!out)
+    throw std::runtime_error("Cannot open: " + path);
+
+  const std::string pad(h.data_offset - sizeof(h), '\0');
+  out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+  out.write(pad.data(), static_cast<std::streamsize>(pad.size()));
+  out.write(static_cast<const char *>(data),
+            static_cast<std::streamsize>(h.data_bytes));
+  if (!out)
+    throw std::runtime_error("Failed writing: " + path);
+}
+
+MappedTensor MappedTensor::Open(const std::string &path,
+                                bool verify_checksum) {
+  MappedTensor t;
+  t.m_Path = path;
+  t.m_File = Memory::MappedFile::Open(path);
+  if (t.m_File.size() < sizeof(TensorHeader))
+    throw std::runtime_error("Invalid tensor file " + path + ": too small");
+
+  std::memcpy(&t.m_Header, t.m_File.data(), sizeof(TensorHeader));
+  Validate(t.m_Header, t.m_File.size(), path);
+  t.m_Data = static_cast<char *>(t.m_File.data()) + t.m_Header.data_offset;
+
+  if (verify_checksum && !t.VerifyChecksum())
+    throw std::runtime_error("Checksum mismatch: " + path);
+  return t;
+}
+
+bool MappedTensor::VerifyChecksum() const {
+  return Crc32(m_Data, m_Header.data_bytes) == m_Header.checksum;
+}
+
+void MappedTensor::check_dtype(DType expected) const {
+  if (m_Header.dtype != expected)
+    throw std::logic_error(m_Path + ": tensor holds " +
+                           DTypeName(m_Header.dtype) + ", requested " +
+                           DTypeName(expected));
+}
+} // namespace Logos::Data
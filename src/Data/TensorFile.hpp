@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Matrix.inl"
+#include "Memory/MappedFile.hpp"
+
+namespace Logos::Data {
+
+// Logos tensor file (.lgt): a 64-byte little-endian header followed, at
+// `data_offset`, by a dense row-major rows x cols array. help2.py writes the
+// same layout.
+enum class DType : std::uint8_t { F32 = 0, U8 = 1 };
+
+std::size_t DTypeSize(DType dtype);
+const char *DTypeName(DType dtype);
+
+template <class T> constexpr DType DTypeOf();
+template <> constexpr DType DTypeOf<float>() { return DType::F32; }
+template <> constexpr DType DTypeOf<std::uint8_t>() { return DType::U8; }
+
+struct TensorHeader {
+  static constexpr char MAGIC[8] = {'L', 'O', 'G', 'O', 'S', 'T', 'N', 'S'};
+  static constexpr std::uint32_t VERSION = 1;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t data_offset; // multiple of alignment
+  std::uint32_t alignment;
+  DType dtype;
+  std::uint8_t rank; // 1 or 2; a vector is stored as rows x 1
+  std::uint16_t reserved0;
+  std::uint64_t rows, cols;
+  std::uint64_t data_bytes;
+  std::uint64_t checksum; // zlib-compatible CRC-32 of the data bytes
+  std::uint64_t reserved1;
+};
+static_assert(sizeof(TensorHeader) == 64);
+
+// CRC-32 (IEEE 802.3, as zlib.crc32), continuing from `crc`.
+std::uint32_t Crc32(const void *data, std::size_t bytes,
+                    std::uint32_t crc = 0);
+
+// Writes a tensor file; `data` holds rows * cols elements of dtype.
+void WriteTensor(const std::string &path, DType dtype, std::size_t rows,
+                 std::size_t cols, const void *data, std::uint8_t rank = 2,
+                 std::size_t alignment = Memory::DEFAULT_ALIGNMENT);
+
+// Read-only view of a tensor file through a Memory::MappedFile: on POSIX
+// processes opening the same file share its pages and opening costs no
+// read. The header is always validated, the checksum only on request since
+// it touches every page.
+class MappedTensor {
+public:
+  MappedTensor() = default;
+
+  static MappedTensor Open(const std::string &path,
+                           bool verify_checksum = false);
+
+  const TensorHeader &header() const noexcept { return m_Header; }
+  DType dtype() const noexcept { return m_Header.dtype; }
+  std::size_t rows() const noexcept { return m_Header.rows; }
+  std::size_t cols() const noexcept { return m_Header.cols; }
+  bool is_mapped() const noexcept { return m_File.is_mapped(); }
+
+  template <class T> const T *data() const {
+    check_dtype(DTypeOf<T>());
+    return static_cast<const T *>(m_Data);
+  }
+
+  // Non-owning Matrix over the tensor data; valid while *this is alive. The
+  // mapping is private, so writes through it never reach the file.
+  template <class T> linalg::Matrix<T> AsMatrix() const {
+    check_dtype(DTypeOf<T>());
+    return linalg::Matrix<T>::Wrap(static_cast<T *>(m_Data), rows(), cols(),
+                                   cols(), m_Header.alignment);
+  }
+
+  // Recomputes the data CRC and compares it with the header.
+  bool VerifyChecksum() const;
+
+private:
+  void check_dtype(DType expected) const;
+
+  TensorHeader m_Header{};
+  Memory::MappedFile m_File;
+  void *m_Data = nullptr; // inside m_File
+  std::string m_Path;
+};
+} // namespace Logos::Data
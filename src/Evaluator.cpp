@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+#include "Evaluator.hpp"
+#include "Functions.hpp"
+#include "Threading/ThreadPool.hpp"
+
+namespace Logos::NeuralNet {
+
+Evaluator::Evaluator(Sequential<float> &model, const Data::ImageSet &images,
+                     std::span<const std::uint8_t> labels, Callback on_report,
+                     std::size_t shard_rows)
+    : m_Model(model), m_Snapshot(model.Replica()), m_Images(images),
+      m_Labels(labels), m_OnReport(std::move(on_report)),
+      m_ShardRows(shard_rows) {
+  if (images.rows() != labels.size() || images.rows() == 0)
+    throw std::logic_error("Evaluator: images and labels differ in size");
+  if (images.cols() != model.InputDim() || shard_rows == 0)
+    throw std::logic_error("Evaluator: wrong input width or shard size");
+  // Checked here since pool tasks must not throw.
+  for (const auto label : labels)
+    if (label >= model.OutputDim())
+      throw std::logic_error("Evaluator: label out of range");
+}
+
+Evaluator::~Evaluator() {
+  if (m_Thread.joinable())
+    m_Thread.join();
+}
+
+void Evaluator::Submit(std::uint32_t epoch) {
+  const auto t0 = std::chrono::steady_clock::now();
+  Wait();
+  m_Snapshot->CopyParametersFrom(m_Model);
+  m_Thread = std::thread([this, epoch] {
+    try {
+      m_Last = Score(epoch);
+      if (m_OnReport)
+        m_OnReport(m_Last);
+    } catch (...) {
+      m_Error = std::current_exception();
+    }
+  });
+  const std::chrono::duration<double> dt =
+      std::chrono::steady_clock::now() - t0;
+  m_BlockedSeconds += dt.count();
+  m_Evaluations++;
+}
+
+void Evaluator::Wait() {
+  if (m_Thread.joinable())
+    m_Thread.join();
+  if (m_Error)
+    std::rethrow_exception(std::exchange(m_Error, nullptr));
+}
+
+EvalReport Evaluator::Score(std::uint32_t epoch) const {
+  const auto t0 = std::chrono::steady_clock::now();
+  const Sequential<float> &model = *m_Snapshot;
+  const std::size_t N = m_Images.rows(), C = model.OutputDim();
+  const std::size_t shards = (N + m_ShardRows - 1) / m_ShardRows;
+
+  struct Partial {
+    double loss = 0.0;
+    std::size_t correct = 0;
+    std::vector<std::uint32_t> confusion;
+  };
+  std::vector<Partial> parts(shards);
+
+  // One shard per task; the kernels inside run inline on its thread.
+  Threading::parallel_for(0, shards, 1, [&](std::size_t s0, std::size_t s1) {
+    linalg::Matrix<float> pixels, dlogits;
+    Sequential<float>::InferenceScratch scratch;
+    for (std::size_t s = s0; s < s1; s++) {
+      const std::size_t first = s * m_ShardRows;
+      const std::size_t rows = std::min(m_ShardRows, N - first);
+      const auto labels = m_Labels.subspan(first, rows);
+      const auto logits =
+          model.Infer(m_Images.Slice(first, rows, pixels), scratch);
+
+      Partial &p = parts[s];
+      p.loss = SoftmaxCrossEntropy<float>(logits, labels, dlogits,
+                                          model.math_mode()) *
+               static_cast<double>(rows);
+      p.confusion.assign(C * C, 0);
+      for (std::size_t i = 0; i < rows; i++) {
+        const std::size_t pred = ArgmaxRow<float>(logits, i);
+        p.confusion[labels[i] * C + pred]++;
+        p.correct += pred == labels[i];
+      }
+    }
+  });
+
+  EvalReport report;
+  report.epoch = epoch;
+  report.samples = N;
+  report.classes = C;
+  report.confusion.assign(C * C, 0);
+  for (const Partial &p : parts) {
+    report.loss += p.loss;
+    report.correct += p.correct;
+    for (std::size_t k = 0; k < C * C; k++)
+      report.confusion[k] += p.confusion[k];
+  }
+  report.loss /= static_cast<double>(N);
+  const std::chrono::duration<double> dt =
+      std::chrono::steady_clock::now() - t0;
+  report.seconds = dt.count();
+  return report;
+}
+} // namespace Logos::NeuralNet
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "Data/ImageSet.hpp"
+#include "Sequential.hpp"
+
+namespace Logos::NeuralNet {
+
+// Scores of a model on a labelled set.
+struct EvalReport {
+  std::uint32_t epoch = 0;
+  std::size_t samples = 0, correct = 0, classes = 0;
+  double loss = 0.0;    // mean softmax cross-entropy
+  double seconds = 0.0; // wall time of the scoring
+  // Row-major classes x classes counts: confusion[label * classes + pred].
+  std::vector<std::uint32_t> confusion;
+
+  double accuracy() const {
+    return samples ? static_cast<double>(correct) / samples : 0.0;
+  }
+  std::uint32_t count(std::size_t label, std::size_t predicted) const {
+    return confusion[label * classes + predicted];
+  }
+};
+
+// Scores a model on a fixed test set in the background, so training does
+// not wait for it. Submit() copies the model's weights into a private
+// replica, the only part the caller waits for, and returns. A background
+// thread then cuts the set into shards of `shard_rows` rows, runs them
+// through Sequential::Infer across the thread pool and hands the report to
+// the callback, on that thread. Shards are reduced in order, so the report
+// does not depend on the thread count.
+//
+// One evaluation is in flight at a time: Submit waits for the previous
+// one. The images, labels and model must outlive the evaluator.
+class Evaluator {
+public:
+  using Callback = std::function<void(const EvalReport &)>;
+
+  Evaluator(Sequential<float> &model, const Data::ImageSet &images,
+            std::span<const std::uint8_t> labels, Callback on_report = {},
+            std::size_t shard_rows = 1024);
+  // Waits for the evaluation in flight; its error, if any, is lost.
+  ~Evaluator();
+
+  Evaluator(const Evaluator &) = delete;
+  Evaluator &operator=(const Evaluator &) = delete;
+
+  // Snapshots the model's current weights and scores them as `epoch`.
+  void Submit(std::uint32_t epoch);
+
+  // Waits for the evaluation in flight and rethrows its error.
+  void Wait();
+
+  // The last finished evaluation; read it after Wait().
+  const EvalReport &last() const noexcept { return m_Last; }
+
+  // Time the caller spent in Submit() over all evaluations, and their
+  // number.
+  double BlockedSeconds() const noexcept { return m_BlockedSeconds; }
+  std::size_t evaluations() const noexcept { return m_Evaluations; }
+
+private:
+  EvalReport Score(std::uint32_t epoch) const;
+
+  Sequential<float> &m_Model;
+  std::unique_ptr<Sequential<float>> m_Snapshot;
+  const Data::ImageSet &m_Images;
+  std::span<const std::uint8_t> m_Labels;
+  Callback m_OnReport;
+  std::size_t m_ShardRows;
+
+  std::thread m_Thread;
+  std::exception_ptr m_Error;
+  EvalReport m_Last;
+  double m_BlockedSeconds = 0.0;
+  std::size_t m_Evaluations = 0;
+};
+} // namespace Logos::NeuralNet
@@ -4,14 +4,27 @@
 #include <cmath>
 #include <cstdint>
 #include <limits>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <vector>
 
+#include "Kernels/Simd.hpp"
 #include "Matrix.inl"
+#include "MatrixView.hpp"
+#include "Threading/ThreadPool.hpp"
 
 namespace Logos::NeuralNet {
+
+// How exp/log are evaluated by Softmax and SoftmaxCrossEntropy; see
+// linalg::simd::MathMode. Only float honours it, double always uses libm.
+using MathMode = linalg::simd::MathMode;
+
 template <class T>
-inline void Softmax(const linalg::Matrix<T> &logits, linalg::Matrix<T> &probs) {
+inline void Softmax(linalg::ConstMatrixView<T> logits,
+                    linalg::Matrix<T> &probs,
+                    MathMode mode = MathMode::Accurate) {
 
   const auto N = logits.rows(), M = logits.cols();
   if (N == 0 || M == 0)
@@ -20,27 +33,80 @@ inline void Softmax(const linalg::Matrix<T> &logits, linalg::Matrix<T> &probs) {
   if (probs.rows() != N || probs.cols() != M)
     probs = linalg::Matrix<T>(N, M);
 
-  for (std::size_t i = 0; i < N; i++) {
-    T maxv = std::numeric_limits<T>::lowest();
-    for (std::size_t j = 0; j < M; j++)
-      maxv = std::max(maxv, logits(i, j));
-
-    T sum{0};
-    for (std::size_t j = 0; j < M; j++) {
-      const T val = std::exp(logits(i, j) - maxv);
-      probs(i, j) = val;
-      sum += val;
-    }
+  // exp dominates, count it as a handful of flops per element
+  Threading::parallel_for(
+      0, N, Threading::GrainFor(8 * M), [&](std::size_t r0, std::size_t r1) {
+        if constexpr (std::is_same_v<T, float>) {
+          const auto &k = linalg::simd::Kernels();
+          for (std::size_t i = r0; i < r1; i++)
+            k.softmax_row(&logits(i, 0), &probs(i, 0), M, mode);
+        } else {
+          for (std::size_t i = r0; i < r1; i++) {
+            T maxv = std::numeric_limits<T>::lowest();
+            for (std::size_t j = 0; j < M; j++)
+              maxv = std::max(maxv, logits(i, j));
+
+            T sum{0};
+            for (std::size_t j = 0; j < M; j++) {
+              const T val = std::exp(logits(i, j) - maxv);
+              probs(i, j) = val;
+              sum += val;
+            }
+
+            const T invSum = T{1} / sum;
+            for (std::size_t j = 0; j < M; j++)
+              probs(i, j) *= invSum;
+          }
+        }
+      });
+}
 
-    const T invSum = T{1} / sum;
-    for (std::size_t j = 0; j < M; j++)
-      probs(i, j) *= invSum;
+namespace detail {
+// Mean over N rows of row_loss(first, last), which scores rows [first, last)
+// and writes their part of the gradient. Rows are scored in fixed blocks and
+// the block losses summed in order, so the result does not depend on the
+// thread count.
+template <class T, class RowLoss>
+inline T MeanRowLoss(std::size_t N, std::size_t M, RowLoss &&row_loss) {
+  const std::size_t grain = Threading::GrainFor(M),
+                    blocks = (N + grain - 1) / grain;
+  // Per call, since pool threads write it and the caller may run another
+  // loss while it waits. A step has a handful of blocks, which fit on the
+  // stack, so it does not allocate.
+  constexpr std::size_t INLINE_BLOCKS = 64;
+  T inline_partial[INLINE_BLOCKS];
+  std::vector<T> heap_partial;
+  T *partial = inline_partial;
+  if (blocks > INLINE_BLOCKS) {
+    heap_partial.resize(blocks);
+    partial = heap_partial.data();
   }
+
+  Threading::parallel_for(0, blocks, 1, [&](std::size_t b0, std::size_t b1) {
+    for (std::size_t b = b0; b < b1; b++)
+      partial[b] = row_loss(b * grain, std::min(N, (b + 1) * grain));
+  });
+
+  T loss_sum{0};
+  for (std::size_t b = 0; b < blocks; b++)
+    loss_sum += partial[b];
+
+  return loss_sum / N;
+}
+
+inline void CheckLabels(std::span<const std::uint8_t> labels, std::size_t M,
+                        const char *what) {
+  for (const auto y : labels)
+    if (static_cast<std::size_t>(y) >= M)
+      throw std::logic_error(std::string(what) + ": label out of range");
 }
+} // namespace detail
 
+// Cross-entropy of already normalised probabilities; see
+// SoftmaxCrossEntropy for the training path.
 template <class T>
-inline T CrossEntropy(const linalg::Matrix<T> &probs,
-                      const std::vector<std::uint8_t> &labels,
+inline T CrossEntropy(linalg::ConstMatrixView<T> probs,
+                      std::span<const std::uint8_t> labels,
                       linalg::Matrix<T> &dLogits) {
 
   const auto N = probs.rows(), M = probs.cols();
@@ -50,33 +116,88 @@ inline T CrossEntropy(const linalg::Matrix<T> &probs,
   if (dLogits.rows() != N || dLogits.cols() != M)
     dLogits = linalg::Matrix<T>(N, M);
 
+  detail::CheckLabels(labels, M, "CrossEntropy");
+
   const T invN = T{1} / N;
   const T eps = T{1e-12};
 
-  T loss_sum{0};
-  for (std::size_t i = 0; i < N; i++) {
-    const std::size_t y = static_cast<std::size_t>(labels[i]);
-    if (y >= M)
-      throw std::logic_error("CrossEntropy: label out of range");
-
-    T p_y = probs(i, y);
-    if (p_y < eps)
-      p_y = eps;
-    loss_sum += -std::log(p_y);
-
-    for (std::size_t j = 0; j < M; j++) {
-      T g = probs(i, j) * invN;
-      if (j == y)
-        g -= invN;
-      dLogits(i, j) = g;
+  return detail::MeanRowLoss<T>(N, M, [&](std::size_t r0, std::size_t r1) {
+    T loss{0};
+    for (std::size_t i = r0; i < r1; i++) {
+      const std::size_t y = static_cast<std::size_t>(labels[i]);
+
+      T p_y = probs(i, y);
+      if (p_y < eps)
+        p_y = eps;
+      loss += -std::log(p_y);
+
+      for (std::size_t j = 0; j < M; j++) {
+        T g = probs(i, j) * invN;
+        if (j == y)
+          g -= invN;
+        dLogits(i, j) = g;
+      }
     }
-  }
+    return loss;
+  });
+}
+
+// Softmax followed by CrossEntropy in one sweep over each row of logits:
+// returns the mean of log-sum-exp(logits[i, :]) - logits[i, labels[i]] and
+// writes dLogits = (softmax(logits) - onehot(labels)) / N without forming
+// the probabilities.
+template <class T>
+inline T SoftmaxCrossEntropy(linalg::ConstMatrixView<T> logits,
+                             std::span<const std::uint8_t> labels,
+                             linalg::Matrix<T> &dLogits,
+                             MathMode mode = MathMode::Accurate) {
 
-  return loss_sum * invN;
+  const auto N = logits.rows(), M = logits.cols();
+  if (N == 0 || M == 0 || labels.size() != N)
+    throw std::logic_error("SoftmaxCrossEntropy: wrong input");
+
+  if (dLogits.rows() != N || dLogits.cols() != M)
+    dLogits = linalg::Matrix<T>(N, M);
+
+  detail::CheckLabels(labels, M, "SoftmaxCrossEntropy");
+
+  const T invN = T{1} / N;
+
+  return detail::MeanRowLoss<T>(N, M, [&](std::size_t r0, std::size_t r1) {
+    T loss{0};
+    if constexpr (std::is_same_v<T, float>) {
+      const auto &k = linalg::simd::Kernels();
+      for (std::size_t i = r0; i < r1; i++)
+        loss += k.softmax_xent_row(&logits(i, 0), &dLogits(i, 0), M,
+                                   labels[i], invN, mode);
+    } else {
+      for (std::size_t i = r0; i < r1; i++) {
+        const std::size_t y = static_cast<std::size_t>(labels[i]);
+
+        T maxv = std::numeric_limits<T>::lowest();
+        for (std::size_t j = 0; j < M; j++)
+          maxv = std::max(maxv, logits(i, j));
+
+        T sum{0};
+        for (std::size_t j = 0; j < M; j++) {
+          const T e = std::exp(logits(i, j) - maxv);
+          dLogits(i, j) = e;
+          sum += e;
+        }
+
+        const T inv = invN / sum;
+        for (std::size_t j = 0; j < M; j++)
+          dLogits(i, j) *= inv;
+        dLogits(i, y) -= invN;
+        loss += (maxv - logits(i, y)) + std::log(sum);
+      }
+    }
+    return loss;
+  });
 }
 
 template <class T>
-inline std::size_t ArgmaxRow(const linalg::Matrix<T> &A, std::size_t row) {
+inline std::size_t ArgmaxRow(linalg::ConstMatrixView<T> A, std::size_t row) {
   const auto N = A.rows(), M = A.cols();
   if (row >= N || M == 0)
     throw std::logic_error("ArgmaxRow: out of bounds");
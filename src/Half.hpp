@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "Kernels/Simd.hpp"
+
+namespace Logos::linalg {
+// 16-bit storage formats. They only hold bits: values are converted to and
+// from float in bulk with ToHalf/FromHalf, or widened while the GEMM packs
+// its panels, and all arithmetic happens in float.
+//
+// bf16 is the upper half of a float (8 exponent bits, 7 mantissa bits): the
+// float range at 2-3 significant digits. f16 is IEEE binary16 (5 exponent
+// bits, 10 mantissa bits): a little over 3 digits, but nothing above 65504
+// and only subnormals below 6.1e-5.
+struct bf16 {
+  std::uint16_t bits;
+};
+struct f16 {
+  std::uint16_t bits;
+};
+
+enum class Precision : std::uint8_t { F32 = 0, BF16, F16 };
+
+inline const char *PrecisionName(Precision p) {
+  switch (p) {
+  case Precision::F32:
+    return "f32";
+  case Precision::BF16:
+    return "bf16";
+  case Precision::F16:
+    return "f16";
+  }
+  return "unknown";
+}
+
+inline std::size_t PrecisionBytes(Precision p) {
+  return p == Precision::F32 ? sizeof(float) : sizeof(std::uint16_t);
+}
+
+// dst = src rounded to nearest even in a 16-bit format, on the active SIMD
+// tier (F16C or AVX-512 conversions where the CPU has them).
+inline void ToHalf(Precision p, const float *src, std::uint16_t *dst,
+                   std::size_t n) {
+  const auto &k = simd::Kernels();
+  if (p == Precision::BF16)
+    k.f32_to_bf16(src, dst, n);
+  else if (p == Precision::F16)
+    k.f32_to_f16(src, dst, n);
+  else
+    throw std::logic_error("ToHalf: not a 16-bit precision");
+}
+
+// dst = src widened to float; exact for both formats.
+inline void FromHalf(Precision p, const std::uint16_t *src, float *dst,
+                     std::size_t n) {
+  const auto &k = simd::Kernels();
+  if (p == Precision::BF16)
+    k.bf16_to_f32(src, dst, n);
+  else if (p == Precision::F16)
+    k.f16_to_f32(src, dst, n);
+  else
+    throw std::logic_error("FromHalf: not a 16-bit precision");
+}
+} // namespace Logos::linalg
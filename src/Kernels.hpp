@@ -1,15 +1,37 @@
 #pragma once
 
-#include "Matrix.hpp"
+#include "Kernels/Gemm.hpp"
+#include "Matrix.inl"
+#include "MatrixView.hpp"
+#include "Threading/ThreadPool.hpp"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 namespace Logos::linalg {
 
+// Every kernel reads through views, so strided sub-matrices work without a
+// copy. Outputs are either a view of the exact shape or a Matrix that is
+// resized to fit.
+//
+// The kernels a Linear layer runs also take one operand in a 16-bit
+// storage format (Half.hpp): the weights as TB of matmul_bias* and
+// matmul_transposeB, the saved input as TA of matmul_transposeA. It is
+// widened while the GEMM packs it and the products accumulate in float.
+// Pass the storage type explicitly, e.g. matmul_bias<float, bf16>.
+
+// The operand views whose element type may differ from T; the type is
+// never deduced, so plain calls keep working on Matrix<T> arguments.
+template <class S> using OperandView = std::type_identity_t<ConstMatrixView<S>>;
+
 template <class T>
-inline void matmul(const Matrix<T> &A, const Matrix<T> &B, Matrix<T> &out) {
+inline void matmul(ConstMatrixView<T> A, ConstMatrixView<T> B,
+                   MatrixView<T> out) {
   if (A.cols() != B.rows())
     throw std::logic_error("matmul shape mismatch");
 
@@ -18,47 +40,131 @@ inline void matmul(const Matrix<T> &A, const Matrix<T> &B, Matrix<T> &out) {
   // out is (N x M)
   const auto N = A.rows(), K = A.cols(), M = B.cols();
   if (out.rows() != N || out.cols() != M)
-    out = Matrix<T>(N, M);
-  else
-    out.fill_zeroes();
-
-  const auto X = A.data(), Y = B.data();
-  auto Z = out.data();
-
-  for (std::size_t i = 0; i < N; i++)
-    for (std::size_t j = 0; j < K; j++) {
-      const T val = X[i * K + j];
-      for (std::size_t k = 0; k < M; k++)
-        Z[i * M + k] += val * Y[j * M + k];
-    }
+    throw std::logic_error("matmul: output shape mismatch");
+
+  gemm<T>(Trans::No, Trans::No, N, M, K, T{1}, A.data(), A.leading_dim(),
+          B.data(), B.leading_dim(), T{0}, out.data(), out.leading_dim());
+}
+
+template <class T>
+inline void matmul(ConstMatrixView<T> A, ConstMatrixView<T> B, Matrix<T> &out) {
+  if (out.rows() != A.rows() || out.cols() != B.cols())
+    out = Matrix<T>(A.rows(), B.cols());
+  matmul<T>(A, B, MatrixView<T>(out));
+}
+
+// out = A B + b with the bias added in the GEMM epilogue, one pass over out
+// instead of matmul followed by add_rowwise_bias.
+template <class T, class TB = T>
+inline void matmul_bias(ConstMatrixView<T> A, OperandView<TB> B,
+                        std::span<const T> b, MatrixView<T> out) {
+  if (A.cols() != B.rows())
+    throw std::logic_error("matmul_bias shape mismatch");
+  const auto N = A.rows(), K = A.cols(), M = B.cols();
+  if (out.rows() != N || out.cols() != M || b.size() != M)
+    throw std::logic_error("matmul_bias: output shape mismatch");
+
+  simd::GemmEpilogue<T> ep;
+  ep.bias = b.data();
+  gemm<T>(Trans::No, Trans::No, N, M, K, T{1}, A.data(), A.leading_dim(),
+          B.data(), B.leading_dim(), T{0}, out.data(), out.leading_dim(),
+          &ep);
+}
+
+template <class T, class TB = T>
+inline void matmul_bias(ConstMatrixView<T> A, OperandView<TB> B,
+                        std::span<const T> b, Matrix<T> &out) {
+  if (out.rows() != A.rows() || out.cols() != B.cols())
+    out = Matrix<T>(A.rows(), B.cols());
+  matmul_bias<T, TB>(A, B, b, MatrixView<T>(out));
+}
+
+// out = max(A B + b, 0) and mask = (A B + b > 0), all in the GEMM epilogue:
+// the pre-activation never reaches memory. mask is bit-packed, one row of
+// simd::MaskBytes(out.cols()) bytes per row of out.
+template <class T, class TB = T>
+inline void matmul_bias_relu(ConstMatrixView<T> A, OperandView<TB> B,
+                             std::span<const T> b, MatrixView<T> out,
+                             MatrixView<std::uint8_t> mask) {
+  if (A.cols() != B.rows())
+    throw std::logic_error("matmul_bias_relu shape mismatch");
+  const auto N = A.rows(), K = A.cols(), M = B.cols();
+  if (out.rows() != N || out.cols() != M || b.size() != M ||
+      mask.rows() != N || mask.cols() != simd::MaskBytes(M))
+    throw std::logic_error("matmul_bias_relu: output shape mismatch");
+
+  simd::GemmEpilogue<T> ep;
+  ep.bias = b.data();
+  ep.relu = true;
+  ep.mask = mask.data();
+  ep.ldm = mask.leading_dim();
+  gemm<T>(Trans::No, Trans::No, N, M, K, T{1}, A.data(), A.leading_dim(),
+          B.data(), B.leading_dim(), T{0}, out.data(), out.leading_dim(),
+          &ep);
+}
+
+// out = max(A B + b, 0) without a mask, for inference.
+template <class T, class TB = T>
+inline void matmul_bias_relu(ConstMatrixView<T> A, OperandView<TB> B,
+                             std::span<const T> b, MatrixView<T> out) {
+  if (A.cols() != B.rows())
+    throw std::logic_error("matmul_bias_relu shape mismatch");
+  const auto N = A.rows(), K = A.cols(), M = B.cols();
+  if (out.rows() != N || out.cols() != M || b.size() != M)
+    throw std::logic_error("matmul_bias_relu: output shape mismatch");
+
+  simd::GemmEpilogue<T> ep;
+  ep.bias = b.data();
+  ep.relu = true;
+  gemm<T>(Trans::No, Trans::No, N, M, K, T{1}, A.data(), A.leading_dim(),
+          B.data(), B.leading_dim(), T{0}, out.data(), out.leading_dim(),
+          &ep);
 }
 
 template <class T>
-inline void add_rowwise_bias(const std::vector<T> &b, Matrix<T> &out) {
+inline void add_rowwise_bias(std::span<const T> b, MatrixView<T> out) {
   if (b.size() != out.cols())
     throw std::logic_error("add_rowwise_bias: size mismatch");
 
-  const auto N = out.rows(), M = out.cols();
+  const auto N = out.rows(), M = out.cols(), ld = out.leading_dim();
   auto X = out.data();
-  for (std::size_t i = 0; i < N; i++)
-    for (std::size_t j = 0; j < M; j++)
-      X[i * M + j] += b[j];
+  Threading::parallel_for(
+      0, N, Threading::GrainFor(M), [&](std::size_t r0, std::size_t r1) {
+        if constexpr (std::is_same_v<T, float>) {
+          simd::Kernels().add_bias(b.data(), X + r0 * ld, r1 - r0, M, ld);
+        } else {
+          for (std::size_t i = r0; i < r1; i++)
+            for (std::size_t j = 0; j < M; j++)
+              X[i * ld + j] += b[j];
+        }
+      });
 }
 
+// Column sums. Parallel over column slices, so no cross-thread reduction is
+// needed; slices stay at least 64 columns wide.
 template <class T>
-inline void sum_rows(const Matrix<T> &A, std::vector<T> &out) {
-  out.assign(A.cols(), 0.0f);
+inline void sum_rows(ConstMatrixView<T> A, std::span<T> out) {
+  if (out.size() != A.cols())
+    throw std::logic_error("sum_rows: size mismatch");
+  std::fill(out.begin(), out.end(), T{0});
 
-  const auto N = A.rows(), M = A.cols();
+  const auto N = A.rows(), M = A.cols(), ld = A.leading_dim();
   const auto X = A.data();
-  for (std::size_t i = 0; i < N; i++)
-    for (std::size_t j = 0; j < M; j++)
-      out[j] += X[i * M + j];
+  const std::size_t grain = std::max<std::size_t>(64, Threading::GrainFor(N));
+  Threading::parallel_for(0, M, grain, [&](std::size_t c0, std::size_t c1) {
+    if constexpr (std::is_same_v<T, float>) {
+      simd::Kernels().sum_rows(X + c0, N, c1 - c0, ld, out.data() + c0);
+    } else {
+      for (std::size_t i = 0; i < N; i++)
+        for (std::size_t j = c0; j < c1; j++)
+          out[j] += X[i * ld + j];
+    }
+  });
 }
 
-template <class T>
-inline void matmul_transposeA(const Matrix<T> &A, const Matrix<T> &B,
-                              Matrix<T> &out) {
+template <class T, class TA = T>
+inline void matmul_transposeA(OperandView<TA> A, ConstMatrixView<T> B,
+                              MatrixView<T> out) {
   if (A.rows() != B.rows())
     throw std::logic_error("matmul_transposeA: mismatch");
 
@@ -68,24 +174,23 @@ inline void matmul_transposeA(const Matrix<T> &A, const Matrix<T> &B,
 
   const auto N = A.rows(), M = A.cols(), P = B.cols();
   if (out.rows() != M || out.cols() != P)
-    out = Matrix<T>(M, P);
-  else
-    out.fill_zeroes();
-
-  const auto X = A.data(), Y = B.data();
-  auto Z = out.data();
-
-  for (std::size_t i = 0; i < M; i++)
-    for (std::size_t k = 0; k < N; k++) {
-      const auto val = X[k * M + i];
-      for (std::size_t j = 0; j < P; j++)
-        Z[i * P + j] += val * Y[k * P + j];
-    }
+    throw std::logic_error("matmul_transposeA: output shape mismatch");
+
+  gemm<T>(Trans::Yes, Trans::No, M, P, N, T{1}, A.data(), A.leading_dim(),
+          B.data(), B.leading_dim(), T{0}, out.data(), out.leading_dim());
 }
 
-template <class T>
-inline void matmul_transposeB(const Matrix<T> &A, const Matrix<T> &B,
+template <class T, class TA = T>
+inline void matmul_transposeA(OperandView<TA> A, ConstMatrixView<T> B,
                               Matrix<T> &out) {
+  if (out.rows() != A.cols() || out.cols() != B.cols())
+    out = Matrix<T>(A.cols(), B.cols());
+  matmul_transposeA<T, TA>(A, B, MatrixView<T>(out));
+}
+
+template <class T, class TB = T>
+inline void matmul_transposeB(ConstMatrixView<T> A, OperandView<TB> B,
+                              MatrixView<T> out) {
   if (A.cols() != B.cols())
     throw std::logic_error("matmul_transposeB: mismatch");
 
@@ -95,17 +200,17 @@ inline void matmul_transposeB(const Matrix<T> &A, const Matrix<T> &B,
 
   const auto N = A.rows(), M = A.cols(), P = B.rows();
   if (out.rows() != N || out.cols() != P)
-    out = Matrix<T>(N, P);
+    throw std::logic_error("matmul_transposeB: output shape mismatch");
 
-  const auto X = A.data(), Y = B.data();
-  auto Z = out.data();
+  gemm<T>(Trans::No, Trans::Yes, N, P, M, T{1}, A.data(), A.leading_dim(),
+          B.data(), B.leading_dim(), T{0}, out.data(), out.leading_dim());
+}
 
-  for (std::size_t i = 0; i < N; i++)
-    for (std::size_t j = 0; j < P; j++) {
-      T sum{0};
-      for (std::size_t k = 0; k < M; k++)
-        sum += X[i * M + k] * Y[j * M + k];
-      Z[i * P + j] = sum;
-    }
+template <class T, class TB = T>
+inline void matmul_transposeB(ConstMatrixView<T> A, OperandView<TB> B,
+                              Matrix<T> &out) {
+  if (out.rows() != A.rows() || out.cols() != B.rows())
+    out = Matrix<T>(A.rows(), B.rows());
+  matmul_transposeB<T, TB>(A, B, MatrixView<T>(out));
 }
 } // namespace Logos::linalg
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Kernels/Simd.hpp"
+#include "Kernels/Simd/Tables.hpp"
+
+namespace Logos::linalg {
+
+// Y = X W + b, optionally followed by max(., 0), for a layer whose shape is
+// known at compile time: X is rows x K, W is K x N, b has N entries, all
+// row-major. K, N, the register tile and its unroll are constants, so every
+// loop but the one over row tiles has a fixed trip count and there are no
+// runtime shape checks, packing or edge dispatch. Nothing is threaded.
+//
+// That is the right trade for small batches, where the general GEMM spends
+// much of its time packing W. Without cache blocking over K, large batches
+// are better served by linalg::gemm.
+//
+// The kernels in Kernels/Simd are compiled once per tier in their own
+// translation units, which needs the shapes to be known when the library is
+// built. Here they are only known to the caller, so each tier's variant is a
+// function template compiled with that tier's target attribute and picked
+// with the active KernelTable tier (LOGOS_SIMD included).
+
+namespace fixed_detail {
+
+// MR rows against NR columns, accumulated in MR x NR / VW vectors of VW
+// floats that stay in registers for the whole k-loop. VW is the tier's
+// vector width; columns that do not fill a vector (NR < VW, the last tile
+// of an odd N) use single-lane accumulators.
+template <std::size_t K, std::size_t N, bool Relu, std::size_t VW,
+          std::size_t MR, std::size_t NR>
+[[gnu::always_inline]] inline void tile(const float *X, std::size_t ldx,
+                                        const float *W, const float *b,
+                                        float *Y, std::size_t ldy) {
+  constexpr std::size_t LW = NR >= VW ? VW : 1, NV = NR / LW;
+  static_assert(NR % LW == 0, "fixed_linear: ragged column tile");
+  typedef float V __attribute__((vector_size(LW * sizeof(float))));
+
+  V acc[MR][NV] = {};
+  for (std::size_t k = 0; k < K; k++) {
+    V w[NV];
+    for (std::size_t v = 0; v < NV; v++)
+      __builtin_memcpy(&w[v], W + k * N + v * LW, sizeof(V));
+    for (std::size_t r = 0; r < MR; r++) {
+      const V x = V{} + X[r * ldx + k];
+      for (std::size_t v = 0; v < NV; v++)
+        acc[r][v] += x * w[v];
+    }
+  }
+
+  // The bias goes in last, as in the GEMM epilogue.
+  for (std::size_t v = 0; v < NV; v++) {
+    V bias;
+    __builtin_memcpy(&bias, b + v * LW, sizeof(V));
+    for (std::size_t r = 0; r < MR; r++) {
+      V y = acc[r][v] + bias;
+      if constexpr (Relu)
+        y = y > 0.0f ? y : 0.0f;
+      __builtin_memcpy(Y + r * ldy + v * LW, &y, sizeof(V));
+    }
+  }
+}
+
+// Every column tile of MR rows. The N % NR leftover columns take one tile
+// of whole vectors and one of single lanes.
+template <std::size_t K, std::size_t N, bool Relu, std::size_t VW,
+          std::size_t MR, std::size_t NR>
+[[gnu::always_inline]] inline void row_tile(const float *X, std::size_t ldx,
+                                            const float *W, const float *b,
+                                            float *Y, std::size_t ldy) {
+  constexpr std::size_t full = N / NR * NR;
+  for (std::size_t j = 0; j < full; j += NR)
+    tile<K, N, Relu, VW, MR, NR>(X, ldx, W + j, b + j, Y + j, ldy);
+  constexpr std::size_t vec = full + (N - full) / VW * VW;
+  if constexpr (vec != full)
+    tile<K, N, Relu, VW, MR, vec - full>(X, ldx, W + full, b + full,
+                                         Y + full, ldy);
+  if constexpr (N != vec)
+    tile<K, N, Relu, VW, MR, N - vec>(X, ldx, W + vec, b + vec, Y + vec, ldy);
+}
+
+// The rows % MR rows left after the full row tiles, one tile height each.
+template <std::size_t K, std::size_t N, bool Relu, std::size_t VW,
+          std::size_t MR, std::size_t NR>
+[[gnu::always_inline]] inline void
+row_tail(std::size_t left, const float *X, std::size_t ldx, const float *W,
+         const float *b, float *Y, std::size_t ldy) {
+  if constexpr (MR > 1) {
+    if (left == MR - 1)
+      row_tile<K, N, Relu, VW, MR - 1, NR>(X, ldx, W, b, Y, ldy);
+    else
+      row_tail<K, N, Relu, VW, MR - 1, NR>(left, X, ldx, W, b, Y, ldy);
+  }
+}
+
+template <std::size_t K, std::size_t N, bool Relu, std::size_t VW,
+          std::size_t MR, std::size_t NR>
+[[gnu::always_inline]] inline void run(const float *X, std::size_t ldx,
+                                       std::size_t rows, const float *W,
+                                       const float *b, float *Y,
+                                       std::size_t ldy) {
+  std::size_t i = 0;
+  for (; i + MR <= rows; i += MR)
+    row_tile<K, N, Relu, VW, MR, NR>(X + i * ldx, ldx, W, b, Y + i * ldy,
+                                     ldy);
+  if (i < rows)
+    row_tail<K, N, Relu, VW, MR, NR>(rows - i, X + i * ldx, ldx, W, b,
+                                     Y + i * ldy, ldy);
+}
+
+// Register tiles as in the Kernels/Simd GEMM microkernels, two vectors of
+// columns by 6 or 8 rows; the baseline build only has SSE2.
+template <std::size_t K, std::size_t N, bool Relu>
+void run_baseline(const float *X, std::size_t ldx, std::size_t rows,
+                  const float *W, const float *b, float *Y, std::size_t ldy) {
+  run<K, N, Relu, 4, 4, 8>(X, ldx, rows, W, b, Y, ldy);
+}
+
+#if LOGOS_SIMD_X86
+template <std::size_t K, std::size_t N, bool Relu>
+[[gnu::target("sse4.2")]] void run_sse42(const float *X, std::size_t ldx,
+                                         std::size_t rows, const float *W,
+                                         const float *b, float *Y,
+                                         std::size_t ldy) {
+  run<K, N, Relu, 4, 6, 8>(X, ldx, rows, W, b, Y, ldy);
+}
+
+template <std::size_t K, std::size_t N, bool Relu>
+[[gnu::target("avx2,fma")]] void run_avx2(const float *X, std::size_t ldx,
+                                          std::size_t rows, const float *W,
+                                          const float *b, float *Y,
+                                          std::size_t ldy) {
+  run<K, N, Relu, 8, 6, 16>(X, ldx, rows, W, b, Y, ldy);
+}
+
+template <std::size_t K, std::size_t N, bool Relu>
+[[gnu::target("avx512f,avx512bw,avx512vl,avx512dq,fma")]] void
+run_avx512(const float *X, std::size_t ldx, std::size_t rows, const float *W,
+           const float *b, float *Y, std::size_t ldy) {
+  run<K, N, Relu, 16, 8, 32>(X, ldx, rows, W, b, Y, ldy);
+}
+#endif
+
+} // namespace fixed_detail
+
+template <std::size_t K, std::size_t N, bool Relu = false>
+void fixed_linear(const float *X, std::size_t ldx, std::size_t rows,
+                  const float *W, const float *b, float *Y, std::size_t ldy) {
+  static_assert(K > 0 && N > 0, "fixed_linear: empty layer");
+#if LOGOS_SIMD_X86
+  switch (simd::Kernels().tier) {
+  case simd::Tier::AVX512:
+    return fixed_detail::run_avx512<K, N, Relu>(X, ldx, rows, W, b, Y, ldy);
+  case simd::Tier::AVX2:
+    return fixed_detail::run_avx2<K, N, Relu>(X, ldx, rows, W, b, Y, ldy);
+  case simd::Tier::SSE42:
+    return fixed_detail::run_sse42<K, N, Relu>(X, ldx, rows, W, b, Y, ldy);
+  default:
+    break;
+  }
+#endif
+  fixed_detail::run_baseline<K, N, Relu>(X, ldx, rows, W, b, Y, ldy);
+}
+} // namespace Logos::linalg
@@ -0,0 +1,425 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "Half.hpp"
+#include "Kernels/Simd.hpp"
+#include "Memory/Buffer.hpp"
+#include "Threading/ThreadPool.hpp"
+
+namespace Logos::linalg {
+
+enum class Trans : std::uint8_t { No = 0, Yes };
+
+namespace gemm_detail {
+
+// Register tile computed by one microkernel call: MR rows of op(A) against NR
+// columns of op(B). MR x NR accumulators stay in vector registers for the
+// whole k-loop. These are the sizes of the portable kernel below; the SIMD
+// tiers in Kernels/Simd pick their own, up to MAX_MR x MAX_NR.
+constexpr std::size_t MR = 6, NR = 16;
+constexpr std::size_t MAX_MR = 16, MAX_NR = 32;
+
+// Cache blocking:
+//   KC - depth of a packed panel; one MR x KC sliver of A and one KC x NR
+//        sliver of B stay resident in L1 while the microkernel runs.
+//   MC - rows of the packed A block (MC x KC), sized for L2.
+//   NC - columns of the packed B panel (KC x NC), sized for L3.
+// MC and NC are rounded down to multiples of the active register tile.
+constexpr std::size_t KC = 256, MC = 144, NC = 4080;
+
+using simd::GemmEpilogue;
+
+template <class T> struct MicroKernel {
+  std::size_t mr, nr;
+  void (*fn)(std::size_t kc, const T *a, const T *b, T *C, std::size_t ldc,
+             T alpha, T beta, const GemmEpilogue<T> *ep);
+};
+
+// The epilogue for the tile whose top-left corner is (i, j) of C; j is a
+// multiple of 8, i.e. a byte boundary of the mask.
+template <class T>
+inline GemmEpilogue<T> tile_epilogue(const GemmEpilogue<T> &ep, std::size_t i,
+                                     std::size_t j) {
+  GemmEpilogue<T> t = ep;
+  if (t.bias)
+    t.bias += j;
+  if (t.mask)
+    t.mask += i * t.ldm + j / 8;
+  return t;
+}
+
+// Bias and activation of one output value; the scalar twin of the vector
+// epilogues in the SIMD tiers.
+template <class T>
+inline T apply_epilogue(const GemmEpilogue<T> &ep, T v, std::size_t r,
+                        std::size_t c) {
+  if (ep.bias)
+    v += ep.bias[c];
+  if (ep.relu) {
+    const bool keep = v > T{0};
+    if (ep.mask) {
+      std::uint8_t &byte = ep.mask[r * ep.ldm + c / 8];
+      const auto bit = static_cast<std::uint8_t>(1u << (c % 8));
+      byte = static_cast<std::uint8_t>(keep ? byte | bit : byte & ~bit);
+    }
+    v = keep ? v : T{0};
+  }
+  return v;
+}
+
+// n contiguous values of a 16-bit storage type (Half.hpp) widened to T
+// with the SIMD conversion kernel.
+template <class T, class S>
+inline void widen(const S *src, T *dst, std::size_t n) {
+  static_assert(std::is_same_v<T, float>, "16-bit operands need float math");
+  const auto *bits = reinterpret_cast<const std::uint16_t *>(src);
+  if constexpr (std::is_same_v<S, bf16>)
+    simd::Kernels().bf16_to_f32(bits, dst, n);
+  else
+    simd::Kernels().f16_to_f32(bits, dst, n);
+}
+
+// Longest contiguous run the packing routines widen at once.
+constexpr std::size_t MAX_RUN = KC > MC ? KC : MC;
+
+// Pack an mc x kc block of op(A) into MR-row slivers stored k-major, so the
+// microkernel reads MR contiguous values per k. Rows past mc are zero padded.
+template <class T>
+inline void pack_A(Trans trans, const T *A, std::size_t lda, std::size_t mc,
+                   std::size_t kc, std::size_t mr, T *dst) {
+  for (std::size_t i = 0; i < mc; i += mr) {
+    const auto rows = std::min(mr, mc - i);
+    for (std::size_t p = 0; p < kc; p++) {
+      for (std::size_t r = 0; r < rows; r++)
+        dst[r] = (trans == Trans::No) ? A[(i + r) * lda + p]
+                                      : A[p * lda + (i + r)];
+      for (std::size_t r = rows; r < mr; r++)
+        dst[r] = T{0};
+      dst += mr;
+    }
+  }
+}
+
+// The same layout from a 16-bit A, widened on the way so the microkernel
+// only ever sees T. Contiguous runs of A are converted whole, then
+// scattered into the slivers.
+template <class T, class S>
+  requires(!std::is_same_v<S, T>)
+inline void pack_A(Trans trans, const S *A, std::size_t lda, std::size_t mc,
+                   std::size_t kc, std::size_t mr, T *dst) {
+  alignas(64) T run[MAX_RUN];
+  const std::size_t slivers = (mc + mr - 1) / mr;
+  if (trans == Trans::Yes) {
+    // Row p of A holds step p of every sliver.
+    for (std::size_t p = 0; p < kc; p++) {
+      widen<T, S>(A + p * lda, run, mc);
+      for (std::size_t s = 0; s < slivers; s++) {
+        T *d = dst + s * kc * mr + p * mr;
+        for (std::size_t r = 0; r < mr; r++)
+          d[r] = (s * mr + r < mc) ? run[s * mr + r] : T{0};
+      }
+    }
+    return;
+  }
+  for (std::size_t s = 0; s < slivers; s++) {
+    T *d = dst + s * kc * mr;
+    for (std::size_t r = 0; r < mr; r++) {
+      const bool live = s * mr + r < mc;
+      if (live)
+        widen<T, S>(A + (s * mr + r) * lda, run, kc);
+      for (std::size_t p = 0; p < kc; p++)
+        d[p * mr + r] = live ? run[p] : T{0};
+    }
+  }
+}
+
+// Pack a kc x nc panel of op(B) into NR-column slivers stored k-major.
+// Columns past nc are zero padded.
+template <class T>
+inline void pack_B(Trans trans, const T *B, std::size_t ldb, std::size_t kc,
+                   std::size_t nc, std::size_t nr, T *dst) {
+  for (std::size_t j = 0; j < nc; j += nr) {
+    const auto cols = std::min(nr, nc - j);
+    for (std::size_t p = 0; p < kc; p++) {
+      if (trans == Trans::No && cols == nr) {
+        const T *src = B + p * ldb + j;
+        for (std::size_t c = 0; c < nr; c++)
+          dst[c] = src[c];
+      } else {
+        for (std::size_t c = 0; c < cols; c++)
+          dst[c] = (trans == Trans::No) ? B[p * ldb + (j + c)]
+                                        : B[(j + c) * ldb + p];
+        for (std::size_t c = cols; c < nr; c++)
+          dst[c] = T{0};
+      }
+      dst += nr;
+    }
+  }
+}
+
+// The same layout from a 16-bit B, widened as in pack_A.
+template <class T, class S>
+  requires(!std::is_same_v<S, T>)
+inline void pack_B(Trans trans, const S *B, std::size_t ldb, std::size_t kc,
+                   std::size_t nc, std::size_t nr, T *dst) {
+  alignas(64) T run[MAX_RUN];
+  for (std::size_t j = 0; j < nc; j += nr, dst += kc * nr) {
+    const auto cols = std::min(nr, nc - j);
+    if (trans == Trans::No) {
+      for (std::size_t p = 0; p < kc; p++) {
+        widen<T, S>(B + p * ldb + j, dst + p * nr, cols);
+        std::fill(dst + p * nr + cols, dst + (p + 1) * nr, T{0});
+      }
+      continue;
+    }
+    // Column j + c of op(B) is row j + c of B.
+    for (std::size_t c = 0; c < nr; c++) {
+      if (c < cols)
+        widen<T, S>(B + (j + c) * ldb, run, kc);
+      for (std::size_t p = 0; p < kc; p++)
+        dst[p * nr + c] = (c < cols) ? run[p] : T{0};
+    }
+  }
+}
+
+// C[MR x NR] = alpha * Apack * Bpack + beta * C, then the epilogue. With
+// beta == 0 C is only written, never read, so it may hold garbage.
+template <class T>
+inline void micro_kernel(std::size_t kc, const T *__restrict a,
+                         const T *__restrict b, T *__restrict C,
+                         std::size_t ldc, T alpha, T beta,
+                         const GemmEpilogue<T> *ep) {
+  T acc[MR][NR] = {};
+
+  for (std::size_t p = 0; p < kc; p++) {
+#pragma GCC unroll 6
+    for (std::size_t r = 0; r < MR; r++) {
+      const T av = a[r];
+#pragma GCC unroll 16
+      for (std::size_t c = 0; c < NR; c++)
+        acc[r][c] += av * b[c];
+    }
+    a += MR;
+    b += NR;
+  }
+
+  for (std::size_t r = 0; r < MR; r++) {
+    T *row = C + r * ldc;
+    if (beta == T{0})
+      for (std::size_t c = 0; c < NR; c++)
+        row[c] = alpha * acc[r][c];
+    else
+      for (std::size_t c = 0; c < NR; c++)
+        row[c] = alpha * acc[r][c] + beta * row[c];
+    if (ep)
+      for (std::size_t c = 0; c < NR; c++)
+        row[c] = apply_epilogue<T>(*ep, row[c], r, c);
+  }
+}
+
+// Partial tiles on the bottom/right edges go through a full-size scratch
+// tile so the microkernel itself never needs bounds checks. The epilogue is
+// applied here, on the mr x nr part that is kept.
+template <class T>
+inline void micro_kernel_edge(const MicroKernel<T> &uk, std::size_t kc,
+                              const T *a, const T *b, T *C, std::size_t ldc,
+                              std::size_t mr, std::size_t nr, T alpha, T beta,
+                              const GemmEpilogue<T> *ep) {
+  alignas(64) T tile[MAX_MR * MAX_NR];
+  uk.fn(kc, a, b, tile, uk.nr, alpha, T{0}, nullptr);
+
+  for (std::size_t r = 0; r < mr; r++) {
+    T *row = C + r * ldc;
+    if (beta == T{0})
+      for (std::size_t c = 0; c < nr; c++)
+        row[c] = tile[r * uk.nr + c];
+    else
+      for (std::size_t c = 0; c < nr; c++)
+        row[c] = tile[r * uk.nr + c] + beta * row[c];
+    if (ep)
+      for (std::size_t c = 0; c < nr; c++)
+        row[c] = apply_epilogue<T>(*ep, row[c], r, c);
+  }
+}
+
+// float runs on the SIMD tier picked at startup, everything else on the
+// portable kernel.
+template <class T> inline MicroKernel<T> select_micro_kernel() {
+  if constexpr (std::is_same_v<T, float>) {
+    const auto &k = simd::Kernels();
+    return {k.gemm_mr, k.gemm_nr, k.gemm_micro};
+  } else {
+    return {MR, NR, &micro_kernel<T>};
+  }
+}
+
+// Packing buffers are reused across calls on the same thread.
+template <class T> inline T *pack_buffer(Memory::Buffer &buf, std::size_t n) {
+  if (buf.size_bytes() < n * sizeof(T))
+    buf.reset(n * sizeof(T));
+  return reinterpret_cast<T *>(buf.data());
+}
+
+template <class T>
+inline void scale_C(std::size_t M, std::size_t N, T beta, T *C,
+                    std::size_t ldc) {
+  for (std::size_t i = 0; i < M; i++)
+    for (std::size_t j = 0; j < N; j++)
+      C[i * ldc + j] = (beta == T{0}) ? T{0} : beta * C[i * ldc + j];
+}
+
+// Single-threaded blocked GEMM over the whole of C, see gemm() below.
+template <class T, class TA, class TB>
+inline void gemm_serial(const MicroKernel<T> &uk, Trans transA, Trans transB,
+                        std::size_t M, std::size_t N, std::size_t K, T alpha,
+                        const TA *A, std::size_t lda, const TB *B,
+                        std::size_t ldb, T beta, T *C, std::size_t ldc,
+                        const GemmEpilogue<T> *ep) {
+  const auto MCb = MC / uk.mr * uk.mr, NCb = NC / uk.nr * uk.nr;
+
+  thread_local Memory::Buffer a_buf, b_buf;
+  T *Apack = pack_buffer<T>(a_buf, MCb * KC);
+  T *Bpack = pack_buffer<T>(b_buf, KC * NCb);
+
+  for (std::size_t jc = 0; jc < N; jc += NCb) {
+    const auto nc = std::min(NCb, N - jc);
+
+    for (std::size_t pc = 0; pc < K; pc += KC) {
+      const auto kc = std::min(KC, K - pc);
+      // beta only applies to the first rank-kc update, later ones accumulate
+      const T beta_pc = (pc == 0) ? beta : T{1};
+      // the epilogue runs once, on the finished sums of the last update
+      const bool last = pc + kc == K;
+
+      const TB *Bsrc = (transB == Trans::No) ? B + pc * ldb + jc
+                                             : B + jc * ldb + pc;
+      pack_B<T>(transB, Bsrc, ldb, kc, nc, uk.nr, Bpack);
+
+      for (std::size_t ic = 0; ic < M; ic += MCb) {
+        const auto mc = std::min(MCb, M - ic);
+
+        const TA *Asrc = (transA == Trans::No) ? A + ic * lda + pc
+                                               : A + pc * lda + ic;
+        pack_A<T>(transA, Asrc, lda, mc, kc, uk.mr, Apack);
+
+        for (std::size_t jr = 0; jr < nc; jr += uk.nr) {
+          const auto nr = std::min(uk.nr, nc - jr);
+          const T *b = Bpack + jr * kc;
+
+          for (std::size_t ir = 0; ir < mc; ir += uk.mr) {
+            const auto mr = std::min(uk.mr, mc - ir);
+            const T *a = Apack + ir * kc;
+            T *c = C + (ic + ir) * ldc + (jc + jr);
+
+            GemmEpilogue<T> tile_ep;
+            const GemmEpilogue<T> *pep = nullptr;
+            if (ep && last) {
+              tile_ep = tile_epilogue<T>(*ep, ic + ir, jc + jr);
+              pep = &tile_ep;
+            }
+
+            if (mr == uk.mr && nr == uk.nr)
+              uk.fn(kc, a, b, c, ldc, alpha, beta_pc, pep);
+            else
+              micro_kernel_edge<T>(uk, kc, a, b, c, ldc, mr, nr, alpha,
+                                   beta_pc, pep);
+          }
+        }
+      }
+    }
+  }
+}
+
+// Below this many flops per block a task costs more than it saves.
+constexpr std::size_t MIN_TASK_FLOPS = std::size_t{1} << 20;
+} // namespace gemm_detail
+
+// BLAS-style row-major GEMM:
+//   C[M x N] = alpha * op(A)[M x K] * op(B)[K x N] + beta * C
+// op(X) is X or X^T depending on the transpose flag; lda/ldb/ldc are the
+// leading dimensions (row strides) of the matrices as stored in memory.
+//
+// C is cut into a grid of independent blocks, split along M and N in
+// proportion to their sizes, and the blocks are spread over the global
+// thread pool. Each block runs the serial blocked kernel with its own
+// packing buffers.
+//
+// An epilogue (see Kernels/Simd.hpp) covers the whole of C: bias has N
+// entries and mask is M x N. It is applied by the microkernel to each tile
+// while the finished sums are still in registers.
+//
+// A and B may also be bf16 or f16 (Half.hpp) with T = float: they are
+// widened while packing and the products accumulate in float, so the
+// 16-bit formats halve the operand traffic without reaching the
+// microkernel.
+template <class T, class TA = T, class TB = T>
+inline void gemm(Trans transA, Trans transB, std::size_t M, std::size_t N,
+                 std::size_t K, T alpha, const TA *A, std::size_t lda,
+                 const TB *B, std::size_t ldb, T beta, T *C, std::size_t ldc,
+                 const simd::GemmEpilogue<T> *ep = nullptr) {
+  using namespace gemm_detail;
+
+  if (M == 0 || N == 0)
+    return;
+  if (K == 0 || alpha == T{0}) {
+    scale_C<T>(M, N, beta, C, ldc);
+    if (ep)
+      for (std::size_t i = 0; i < M; i++)
+        for (std::size_t j = 0; j < N; j++)
+          C[i * ldc + j] = apply_epilogue<T>(*ep, C[i * ldc + j], i, j);
+    return;
+  }
+
+  const auto uk = select_micro_kernel<T>();
+
+  const std::size_t threads = Threading::ThreadPool::InParallelRegion()
+                                  ? 1
+                                  : Threading::ThreadPool::Global().size();
+  const std::size_t flops = 2 * M * N * K;
+  const std::size_t tiles =
+      std::min(threads * 4, std::max<std::size_t>(1, flops / MIN_TASK_FLOPS));
+
+  if (threads == 1 || tiles == 1) {
+    gemm_serial<T, TA, TB>(uk, transA, transB, M, N, K, alpha, A, lda, B, ldb,
+                           beta, C, ldc, ep);
+    return;
+  }
+
+  const std::size_t row_units = (M + uk.mr - 1) / uk.mr,
+                    col_units = (N + uk.nr - 1) / uk.nr;
+  std::size_t rb = static_cast<std::size_t>(
+      std::sqrt(static_cast<double>(tiles) * M / N) + 0.5);
+  rb = std::clamp<std::size_t>(rb, 1, row_units);
+  const std::size_t cb =
+      std::clamp<std::size_t>((tiles + rb - 1) / rb, 1, col_units);
+
+  const std::size_t tm = (row_units + rb - 1) / rb * uk.mr,
+                    tn = (col_units + cb - 1) / cb * uk.nr;
+  const std::size_t row_blocks = (M + tm - 1) / tm,
+                    col_blocks = (N + tn - 1) / tn;
+
+  Threading::parallel_for(
+      0, row_blocks * col_blocks, 1, [&](std::size_t t0, std::size_t t1) {
+        for (std::size_t t = t0; t < t1; t++) {
+          const std::size_t i0 = (t / col_blocks) * tm,
+                            j0 = (t % col_blocks) * tn;
+          const std::size_t mb = std::min(tm, M - i0),
+                            nb = std::min(tn, N - j0);
+
+          const TA *Ab = (transA == Trans::No) ? A + i0 * lda : A + i0;
+          const TB *Bb = (transB == Trans::No) ? B + j0 : B + j0 * ldb;
+          GemmEpilogue<T> block_ep;
+          if (ep)
+            block_ep = tile_epilogue<T>(*ep, i0, j0);
+          gemm_serial<T, TA, TB>(uk, transA, transB, mb, nb, K, alpha, Ab,
+                                 lda, Bb, ldb, beta, C + i0 * ldc + j0, ldc,
+                                 ep ? &block_ep : nullptr);
+        }
+      });
+}
+} // namespace Logos::linalg
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "Kernels/Simd.hpp"
+#include "Matrix.inl"
+#include "MatrixView.hpp"
+#include "Memory/Buffer.hpp"
+#include "Threading/ThreadPool.hpp"
+
+namespace Logos::linalg {
+
+// Int8 inference for dense layers (post-training quantisation).
+//
+// Weights are symmetric int8 per output channel: column j of W is stored as
+// round(W[:, j] / s_j) with s_j = max |W[:, j]| / 127. Activations are
+// affine uint8 per tensor, x = (q - zero) * scale with q in [0, act_max];
+// scale and zero come from the range of a calibration set. act_max is 255
+// where the kernel table's qgemm allows it and 127 on the pmaddubsw paths
+// (simd::KernelTable::qgemm_act_max).
+// The product runs on uint8 x int8 with int32 accumulation, and
+//   sum_k x_k W_kj = scale s_j (sum_k q_k Wq_kj - zero colsum_j)
+// so the zero point folds into a per-column bias together with the layer's
+// own. The epilogue then scales, adds that bias and either requantises for
+// the next layer (ReLU included) or writes float.
+
+// Affine uint8 quantisation of one activation tensor.
+struct QuantParams {
+  float scale = 1.0f;
+  std::int32_t zero = 0, act_max = simd::QGEMM_ACT_MAX_MADD;
+
+  // Covers [lo, hi] with codes 0..act_max, widened to include 0 so that
+  // zero padding and ReLU outputs are exact.
+  static QuantParams FromRange(float lo, float hi, std::int32_t act_max) {
+    lo = std::min(lo, 0.0f);
+    hi = std::max(hi, 0.0f);
+    QuantParams p;
+    p.act_max = act_max;
+    if (hi > lo)
+      p.scale = (hi - lo) / static_cast<float>(act_max);
+    p.zero = static_cast<std::int32_t>(std::lrint(-lo / p.scale));
+    return p;
+  }
+};
+
+// K x N float weights quantised and packed for simd::KernelTable::qgemm:
+// rows padded to a multiple of QGEMM_KU, columns to panels of QGEMM_NR,
+// the padding zero.
+class QuantizedWeights {
+public:
+  QuantizedWeights() = default;
+  explicit QuantizedWeights(ConstMatrixView<float> W)
+      : m_Rows(W.rows()), m_Cols(W.cols()), m_Scale(W.cols()),
+        m_ColSums(W.cols()) {
+    using simd::QGEMM_KU, simd::QGEMM_NR;
+    m_Depth = (m_Rows + QGEMM_KU - 1) / QGEMM_KU * QGEMM_KU;
+    const std::size_t panels = (m_Cols + QGEMM_NR - 1) / QGEMM_NR;
+    m_Packed = Memory::Buffer(panels * m_Depth * QGEMM_NR);
+    m_Packed.fill_zeroes();
+    auto *packed = static_cast<std::int8_t *>(m_Packed.data());
+
+    for (std::size_t j = 0; j < m_Cols; j++) {
+      float amax = 0.0f;
+      for (std::size_t k = 0; k < m_Rows; k++)
+        amax = std::max(amax, std::abs(W(k, j)));
+      m_Scale[j] = amax > 0.0f ? amax / 127.0f : 1.0f;
+
+      std::int8_t *panel = packed + j / QGEMM_NR * m_Depth * QGEMM_NR;
+      const std::size_t c = j % QGEMM_NR;
+      std::int32_t sum = 0;
+      for (std::size_t k = 0; k < m_Rows; k++) {
+        const auto q = static_cast<std::int8_t>(std::clamp<long>(
+            std::lrint(W(k, j) / m_Scale[j]), -127, 127));
+        panel[k / QGEMM_KU * QGEMM_KU * QGEMM_NR + c * QGEMM_KU +
+              k % QGEMM_KU] = q;
+        sum += q;
+      }
+      m_ColSums[j] = sum;
+    }
+  }
+
+  std::size_t rows() const noexcept { return m_Rows; }
+  std::size_t cols() const noexcept { return m_Cols; }
+  // Rows after padding: the width the uint8 input rows must have.
+  std::size_t depth() const noexcept { return m_Depth; }
+  const std::int8_t *data() const noexcept {
+    return static_cast<const std::int8_t *>(m_Packed.data());
+  }
+  std::span<const float> scale() const noexcept { return m_Scale; }
+  std::span<const std::int32_t> col_sums() const noexcept {
+    return m_ColSums;
+  }
+  std::size_t size_bytes() const noexcept { return m_Packed.size_bytes(); }
+
+private:
+  std::size_t m_Rows = 0, m_Cols = 0, m_Depth = 0;
+  Memory::Buffer m_Packed;
+  std::vector<float> m_Scale;
+  std::vector<std::int32_t> m_ColSums;
+};
+
+// Q = clamp(round(X / p.scale) + p.zero, 0, p.act_max). Q may be wider
+// than X; the extra columns are set to p.zero.
+inline void quantize(ConstMatrixView<float> X, QuantParams p,
+                     MatrixView<std::uint8_t> Q) {
+  if (Q.rows() != X.rows() || Q.cols() < X.cols())
+    throw std::logic_error("quantize: output shape mismatch");
+
+  const auto &k = simd::Kernels();
+  const auto N = X.rows(), M = X.cols();
+  const float inv = 1.0f / p.scale;
+  const auto pad = static_cast<std::uint8_t>(p.zero);
+  const std::size_t grain = Threading::GrainFor(Q.cols());
+  Threading::parallel_for(0, N, grain, [&](std::size_t r0, std::size_t r1) {
+    for (std::size_t i = r0; i < r1; i++) {
+      std::uint8_t *q = Q.row(i);
+      k.quantize_u8(X.row(i), q, M, inv, p.zero, p.act_max);
+      std::fill(q + M, q + Q.cols(), pad);
+    }
+  });
+}
+
+// The int8 GEMM over A (rows x W.depth() uint8) and W, ending in `ep`,
+// whose out/q pointers address row 0 of the output. Parallel over rows.
+inline void qgemm(ConstMatrixView<std::uint8_t> A, const QuantizedWeights &W,
+                  const simd::QGemmEpilogue &ep) {
+  if (A.cols() != W.depth())
+    throw std::logic_error("qgemm shape mismatch");
+
+  const auto &k = simd::Kernels();
+  const auto N = A.rows(), K = W.depth(), M = W.cols();
+  const std::size_t grain = Threading::GrainFor(K * M);
+  Threading::parallel_for(0, N, grain, [&](std::size_t r0, std::size_t r1) {
+    simd::QGemmEpilogue part = ep;
+    if (part.q)
+      part.q += r0 * part.ldo;
+    else
+      part.out += r0 * part.ldo;
+    k.qgemm(A.row(r0), A.leading_dim(), r1 - r0, K, W.data(), M, part);
+  });
+}
+} // namespace Logos::linalg
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Logos::linalg::simd {
+
+// Instruction set tiers, ordered so that a higher tier implies every lower
+// one is available.
+enum class Tier : std::uint8_t { Scalar = 0, SSE42, AVX2, AVX512 };
+
+// Precision of exp/log in the kernels that use them:
+//   Exact     libm, one element at a time
+//   Accurate  vectorised Cephes polynomials, within ~1-2 ulp
+//   Fast      short polynomials, ~1e-4 relative error
+// The approximate modes flush results below the smallest normal float to
+// zero and treat denormal inputs as the smallest normal.
+enum class MathMode : std::uint8_t { Exact = 0, Accurate, Fast };
+
+// ReLU masks are bit-packed: element j of a row is bit j % 8 of byte j / 8,
+// and every row starts on a fresh byte, so a row of n elements takes
+// MaskBytes(n) bytes. Unused high bits of the last byte are zero.
+constexpr std::size_t MaskBytes(std::size_t n) { return (n + 7) / 8; }
+
+// Elementwise work folded into the store of a finished GEMM tile, so the
+// result is written once instead of being re-read by later passes:
+//   C = alpha * A B + beta * C + bias      (bias broadcast over rows)
+//   C = max(C, 0), mask = (C > 0)          (relu)
+// bias and mask may be null. The driver hands each microkernel call a copy
+// offset to the tile's first row and column; tiles start on columns that
+// are multiples of 8, so that is a whole byte of the mask.
+template <class T> struct GemmEpilogue {
+  const T *bias = nullptr;
+  bool relu = false;
+  std::uint8_t *mask = nullptr; // bit-packed (MaskBytes), row stride ldm
+  std::size_t ldm = 0;
+};
+
+// Constants of one optimizer update (NeuralNet/Optimizer.hpp) for the
+// fused kernels below. Per element, with g the gradient:
+//   SGD   g' = g + weight_decay w
+//         v = momentum v + g'                        (only with a v buffer)
+//         w -= lr * (nesterov ? g' + momentum v : v), or lr * g' without v
+//   Adam  g' = g + l2 w
+//         m = beta1 m + (1 - beta1) g',  v = beta2 v + (1 - beta2) g'^2
+//         w = shrink w - step m / (sqrt(v) rsqrt_bias2 + eps)
+// and g = 0 afterwards, so the gradients are cleared in the same pass.
+// step and rsqrt_bias2 carry Adam's bias correction; AdamW decays through
+// shrink = 1 - lr weight_decay instead of l2. adam_step runs with denormals
+// flushed to zero.
+struct SgdStep {
+  float lr = 0.0f, weight_decay = 0.0f, momentum = 0.0f;
+  bool nesterov = false;
+};
+struct AdamStep {
+  float l2 = 0.0f, beta1 = 0.9f, beta2 = 0.999f, shrink = 1.0f, step = 0.0f,
+        rsqrt_bias2 = 1.0f, eps = 1e-8f;
+};
+
+// Int8 inference GEMM (Kernels/QGemm.hpp): uint8 activations against int8
+// weights, with int32 dot products. The weights come packed in panels of
+// QGEMM_NR columns: row group g of a panel holds B[4g + r][c] at byte
+// 4 (QGEMM_NR g + c) + r, the operand order of vpdpbusd and of pmaddubsw
+// followed by pmaddwd. Activations may use all of uint8, QGEMM_ACT_MAX,
+// where the dot products go straight to int32 (scalar, vpdpbusd). Through
+// pmaddubsw they keep to QGEMM_ACT_MAX_MADD, 7 bits, so its int16 pair
+// sums (2 x 127 x 127) cannot saturate. Within its range every tier
+// computes the same integers.
+constexpr std::size_t QGEMM_NR = 32, QGEMM_KU = 4;
+constexpr std::int32_t QGEMM_ACT_MAX = 255, QGEMM_ACT_MAX_MADD = 127;
+
+// What the int8 GEMM does with the dot product acc of output column j:
+//   y = acc * scale[j] + bias[j]
+// then, with q set, requantises it as the next layer's input
+//   q = clamp(round(y * inv_scale) + zero, relu ? zero : 0, act_max)
+// and otherwise writes y, or max(y, 0) with relu, to out. Row i of the
+// output starts at i * ldo.
+struct QGemmEpilogue {
+  const float *scale = nullptr, *bias = nullptr;
+  float *out = nullptr;
+  std::uint8_t *q = nullptr;
+  std::size_t ldo = 0;
+  float inv_scale = 1.0f;
+  std::int32_t zero = 0, act_max = QGEMM_ACT_MAX_MADD;
+  bool relu = false;
+};
+
+// C[mr x nr] = alpha * Apack * Bpack + beta * C over one packed kc-deep
+// sliver pair (see Kernels/Gemm.hpp for the packing layout), then the
+// epilogue if `ep` is non-null. With beta == 0 C is write-only.
+using GemmMicroKernelFn = void (*)(std::size_t kc, const float *a,
+                                   const float *b, float *C, std::size_t ldc,
+                                   float alpha, float beta,
+                                   const GemmEpilogue<float> *ep);
+
+// Float kernels for one instruction set. Every matrix argument is row-major
+// with an explicit leading dimension; flat kernels take element counts.
+struct KernelTable {
+  Tier tier;
+  const char *name;
+
+  std::size_t gemm_mr, gemm_nr;
+  GemmMicroKernelFn gemm_micro;
+
+  // X[i, :] += b for every row
+  void (*add_bias)(const float *b, float *X, std::size_t rows,
+                   std::size_t cols, std::size_t ld);
+  // out[j] = sum_i X[i, j]
+  void (*sum_rows)(const float *X, std::size_t rows, std::size_t cols,
+                   std::size_t ld, float *out);
+
+  // H = max(X, 0), mask = (X > 0), the mask bit-packed from bit 0 of
+  // mask[0] (see MaskBytes)
+  void (*relu_forward)(const float *X, float *H, std::uint8_t *mask,
+                       std::size_t n);
+  // dX = mask ? dH : 0, same mask layout
+  void (*relu_backward)(const float *dH, const std::uint8_t *mask, float *dX,
+                        std::size_t n);
+
+  // y = exp(x), y = log(x)
+  void (*exp)(const float *x, float *y, std::size_t n, MathMode mode);
+  void (*log)(const float *x, float *y, std::size_t n, MathMode mode);
+
+  // Numerically stable softmax of a single row.
+  void (*softmax_row)(const float *x, float *p, std::size_t n, MathMode mode);
+  // Cross-entropy of one row of logits against `label`, returned as
+  // log-sum-exp(x) - x[label], with g = scale * (softmax(x) - onehot(label))
+  // written alongside. No probabilities are materialised.
+  float (*softmax_xent_row)(const float *x, float *g, std::size_t n,
+                            std::size_t label, float scale, MathMode mode);
+
+  // y += alpha * x, the SGD update with alpha = -learning_rate.
+  void (*axpy)(float alpha, const float *x, float *y, std::size_t n);
+
+  // One optimizer update of n parameters w from their gradients g, which
+  // are zeroed (see SgdStep/AdamStep). v may be null for plain SGD.
+  void (*sgd_step)(float *w, float *g, float *v, std::size_t n,
+                   const SgdStep &s);
+  void (*adam_step)(float *w, float *g, float *m, float *v, std::size_t n,
+                    const AdamStep &s);
+
+  // dst = float(src) * scale + shift, the uint8 dataset gather.
+  void (*u8_to_f32)(const std::uint8_t *src, float *dst, std::size_t n,
+                    float scale, float shift);
+
+  // Float to and from the 16-bit storage formats of Half.hpp. Narrowing
+  // rounds to nearest even; NaNs stay NaN.
+  void (*f32_to_bf16)(const float *src, std::uint16_t *dst, std::size_t n);
+  void (*bf16_to_f32)(const std::uint16_t *src, float *dst, std::size_t n);
+  void (*f32_to_f16)(const float *src, std::uint16_t *dst, std::size_t n);
+  void (*f16_to_f32)(const std::uint16_t *src, float *dst, std::size_t n);
+
+  // dst = clamp(round(src * inv_scale) + zero, 0, act_max), the uint8
+  // input of the int8 GEMM.
+  void (*quantize_u8)(const float *src, std::uint8_t *dst, std::size_t n,
+                      float inv_scale, std::int32_t zero,
+                      std::int32_t act_max);
+  // rows x n int8 GEMM and its epilogue: A is uint8 rows x k with row
+  // stride lda, k a multiple of QGEMM_KU; B the packed panels covering n
+  // columns. Uses VNNI (vpdpbusd) where the CPU has it. A's values must
+  // not exceed qgemm_act_max().
+  void (*qgemm)(const std::uint8_t *A, std::size_t lda, std::size_t rows,
+                std::size_t k, const std::int8_t *B, std::size_t n,
+                const QGemmEpilogue &ep);
+  // QGEMM_ACT_MAX, or QGEMM_ACT_MAX_MADD where qgemm goes through
+  // pmaddubsw on this CPU.
+  std::int32_t (*qgemm_act_max)();
+};
+
+// Kernel table picked on first use: the best tier the CPU supports, capped
+// by the LOGOS_SIMD environment variable (scalar, sse4.2, avx2, avx512).
+const KernelTable &Kernels();
+
+// Highest tier supported by the CPU and OS, ignoring LOGOS_SIMD.
+Tier DetectedTier();
+
+// Switch the active table, e.g. to compare tiers in a benchmark. Requests
+// above DetectedTier() are clamped. Returns the tier actually selected.
+Tier ForceTier(Tier tier);
+
+const char *TierName(Tier tier);
+const char *MathModeName(MathMode mode);
+} // namespace Logos::linalg::simd
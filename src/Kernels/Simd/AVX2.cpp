@@ -0,0 +1,664 @@
+#include "Kernels/Simd/MathCommon.hpp"
+#include "Kernels/Simd/Tables.hpp"
+
+#if LOGOS_SIMD_X86
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <immintrin.h>
+
+namespace Logos::linalg::simd {
+namespace {
+
+constexpr std::size_t MR = 6, NR = 16;
+
+inline float hsum(__m256 v) {
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+  return _mm_cvtss_f32(s);
+}
+
+inline float hmax(__m256 v) {
+  __m128 s = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  s = _mm_max_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_max_ss(s, _mm_shuffle_ps(s, s, 1));
+  return _mm_cvtss_f32(s);
+}
+
+// Cephes-style expf, ~1 ulp over the clamped range.
+inline __m256 exp_ps(__m256 x) {
+  x = _mm256_min_ps(x, _mm256_set1_ps(EXP_MAX));
+  x = _mm256_max_ps(x, _mm256_set1_ps(-EXP_MAX));
+
+  __m256 fx = _mm256_fmadd_ps(x, _mm256_set1_ps(LOG2E), _mm256_set1_ps(0.5f));
+  fx = _mm256_floor_ps(fx);
+
+  x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(LN2_HI), x);
+  x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(LN2_LO), x);
+
+  const __m256 z = _mm256_mul_ps(x, x);
+  __m256 y = _mm256_set1_ps(EXP_P0);
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(EXP_P1));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(EXP_P2));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(EXP_P3));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(EXP_P4));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(EXP_P5));
+  y = _mm256_add_ps(_mm256_fmadd_ps(y, z, x), _mm256_set1_ps(1.0f));
+
+  __m256i e = _mm256_cvttps_epi32(fx);
+  e = _mm256_slli_epi32(_mm256_add_epi32(e, _mm256_set1_epi32(127)), 23);
+  return _mm256_mul_ps(y, _mm256_castsi256_ps(e));
+}
+
+// 2^n * p(f) with the cubic from MathCommon.hpp, ~1e-4 relative.
+inline __m256 fast_exp_ps(__m256 x) {
+  x = _mm256_min_ps(x, _mm256_set1_ps(EXP_MAX));
+  x = _mm256_max_ps(x, _mm256_set1_ps(FAST_EXP_MIN));
+
+  const __m256 t = _mm256_mul_ps(x, _mm256_set1_ps(LOG2E));
+  const __m256 n = _mm256_floor_ps(t);
+  const __m256 f = _mm256_sub_ps(t, n);
+
+  __m256 p = _mm256_fmadd_ps(_mm256_set1_ps(EXP2_C3), f,
+                             _mm256_set1_ps(EXP2_C2));
+  p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(EXP2_C1));
+  p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(EXP2_C0));
+
+  __m256i e = _mm256_cvttps_epi32(n);
+  e = _mm256_slli_epi32(_mm256_add_epi32(e, _mm256_set1_epi32(127)), 23);
+  return _mm256_mul_ps(p, _mm256_castsi256_ps(e));
+}
+
+// Accurate or fast log of positive normal lanes; anything else is redone
+// with std::log.
+template <MathMode M> inline __m256 log_ps(__m256 x) {
+  const __m256i bits = _mm256_castps_si256(x);
+  __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(
+      _mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+  __m256 m = _mm256_castsi256_ps(
+      _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                      _mm256_set1_epi32(0x3F000000)));
+  const __m256 lo = _mm256_cmp_ps(m, _mm256_set1_ps(SQRT_HALF), _CMP_LT_OQ);
+  m = _mm256_add_ps(m, _mm256_and_ps(m, lo));
+  e = _mm256_sub_ps(e, _mm256_and_ps(_mm256_set1_ps(1.0f), lo));
+
+  __m256 r;
+  if constexpr (M == MathMode::Accurate) {
+    const __m256 t = _mm256_sub_ps(m, _mm256_set1_ps(1.0f));
+    const __m256 z = _mm256_mul_ps(t, t);
+    __m256 y = _mm256_set1_ps(LOG_P0);
+    y = _mm256_fmadd_ps(y, t, _mm256_set1_ps(LOG_P1));
+    y = _mm256_fmadd_ps(y, t, _mm256_set1_ps(LOG_P2));
+    y = _mm256_fmadd_ps(y, t, _mm256_set1_ps(LOG_P3));
+    y = _mm256_fmadd_ps(y, t, _mm256_set1_ps(LOG_P4));
+    y = _mm256_fmadd_ps(y, t, _mm256_set1_ps(LOG_P5));
+    y = _mm256_fmadd_ps(y, t, _mm256_set1_ps(LOG_P6));
+    y = _mm256_fmadd_ps(y, t, _mm256_set1_ps(LOG_P7));
+    y = _mm256_fmadd_ps(y, t, _mm256_set1_ps(LOG_P8));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, t), z);
+    y = _mm256_fmadd_ps(e, _mm256_set1_ps(LN2_LO), y);
+    y = _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, y);
+    r = _mm256_fmadd_ps(e, _mm256_set1_ps(LN2_HI), _mm256_add_ps(t, y));
+  } else {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 u =
+        _mm256_div_ps(_mm256_sub_ps(m, one), _mm256_add_ps(m, one));
+    const __m256 u2 = _mm256_mul_ps(u, u);
+    const __m256 l = _mm256_mul_ps(
+        _mm256_add_ps(u, u), _mm256_fmadd_ps(_mm256_set1_ps(LOG_C1), u2,
+                                             _mm256_set1_ps(LOG_C0)));
+    r = _mm256_fmadd_ps(e, _mm256_set1_ps(LN2_HI + LN2_LO), l);
+  }
+
+  const __m256 normal = _mm256_and_ps(
+      _mm256_cmp_ps(x, _mm256_set1_ps(MIN_NORMAL), _CMP_GE_OQ),
+      _mm256_cmp_ps(x, _mm256_set1_ps(INFINITY), _CMP_LT_OQ));
+  if (_mm256_movemask_ps(normal) != 0xFF) {
+    alignas(32) float xs[8], rs[8];
+    _mm256_store_ps(xs, x);
+    _mm256_store_ps(rs, r);
+    const int keep = _mm256_movemask_ps(normal);
+    for (int i = 0; i < 8; i++)
+      if (!(keep & (1 << i)))
+        rs[i] = std::log(xs[i]);
+    r = _mm256_load_ps(rs);
+  }
+  return r;
+}
+
+template <MathMode M> inline __m256 vexp(__m256 x) {
+  if constexpr (M == MathMode::Exact) {
+    alignas(32) float v[8];
+    _mm256_store_ps(v, x);
+    for (float &e : v)
+      e = std::exp(e);
+    return _mm256_load_ps(v);
+  } else if constexpr (M == MathMode::Accurate) {
+    return exp_ps(x);
+  } else {
+    return fast_exp_ps(x);
+  }
+}
+
+template <MathMode M> inline __m256 vlog(__m256 x) {
+  if constexpr (M == MathMode::Exact) {
+    alignas(32) float v[8];
+    _mm256_store_ps(v, x);
+    for (float &e : v)
+      e = std::log(e);
+    return _mm256_load_ps(v);
+  } else {
+    return log_ps<M>(x);
+  }
+}
+
+void gemm_micro(std::size_t kc, const float *a, const float *b, float *C,
+                std::size_t ldc, float alpha, float beta,
+                const GemmEpilogue<float> *ep) {
+  __m256 c[MR][2];
+  for (std::size_t r = 0; r < MR; r++)
+    c[r][0] = c[r][1] = _mm256_setzero_ps();
+
+  for (std::size_t p = 0; p < kc; p++) {
+    const __m256 b0 = _mm256_load_ps(b), b1 = _mm256_load_ps(b + 8);
+    for (std::size_t r = 0; r < MR; r++) {
+      const __m256 av = _mm256_broadcast_ss(a + r);
+      c[r][0] = _mm256_fmadd_ps(av, b0, c[r][0]);
+      c[r][1] = _mm256_fmadd_ps(av, b1, c[r][1]);
+    }
+    a += MR;
+    b += NR;
+  }
+
+  const __m256 va = _mm256_set1_ps(alpha), vb = _mm256_set1_ps(beta);
+  const __m256 zero = _mm256_setzero_ps();
+  const bool bias = ep && ep->bias, relu = ep && ep->relu;
+  const __m256 b0 = bias ? _mm256_loadu_ps(ep->bias) : zero,
+               b1 = bias ? _mm256_loadu_ps(ep->bias + 8) : zero;
+  for (std::size_t r = 0; r < MR; r++) {
+    float *row = C + r * ldc;
+    __m256 r0 = _mm256_mul_ps(va, c[r][0]), r1 = _mm256_mul_ps(va, c[r][1]);
+    if (beta != 0.0f) {
+      r0 = _mm256_fmadd_ps(vb, _mm256_loadu_ps(row), r0);
+      r1 = _mm256_fmadd_ps(vb, _mm256_loadu_ps(row + 8), r1);
+    }
+    if (bias) {
+      r0 = _mm256_add_ps(r0, b0);
+      r1 = _mm256_add_ps(r1, b1);
+    }
+    if (relu) {
+      const __m256 k0 = _mm256_cmp_ps(r0, zero, _CMP_GT_OQ),
+                   k1 = _mm256_cmp_ps(r1, zero, _CMP_GT_OQ);
+      r0 = _mm256_and_ps(r0, k0);
+      r1 = _mm256_and_ps(r1, k1);
+      if (ep->mask) {
+        const auto bits = static_cast<std::uint16_t>(
+            _mm256_movemask_ps(k0) | (_mm256_movemask_ps(k1) << 8));
+        std::memcpy(ep->mask + r * ep->ldm, &bits, sizeof(bits));
+      }
+    }
+    _mm256_storeu_ps(row, r0);
+    _mm256_storeu_ps(row + 8, r1);
+  }
+}
+
+void add_bias(const float *b, float *X, std::size_t rows, std::size_t cols,
+              std::size_t ld) {
+  for (std::size_t i = 0; i < rows; i++) {
+    float *row = X + i * ld;
+    std::size_t j = 0;
+    for (; j + 8 <= cols; j += 8)
+      _mm256_storeu_ps(row + j, _mm256_add_ps(_mm256_loadu_ps(row + j),
+                                              _mm256_loadu_ps(b + j)));
+    for (; j < cols; j++)
+      row[j] += b[j];
+  }
+}
+
+void sum_rows(const float *X, std::size_t rows, std::size_t cols,
+              std::size_t ld, float *out) {
+  std::memset(out, 0, cols * sizeof(float));
+  for (std::size_t i = 0; i < rows; i++) {
+    const float *row = X + i * ld;
+    std::size_t j = 0;
+    for (; j + 8 <= cols; j += 8)
+      _mm256_storeu_ps(out + j, _mm256_add_ps(_mm256_loadu_ps(out + j),
+                                              _mm256_loadu_ps(row + j)));
+    for (; j < cols; j++)
+      out[j] += row[j];
+  }
+}
+
+void relu_forward(const float *X, float *H, std::uint8_t *mask,
+                  std::size_t n) {
+  const __m256 zero = _mm256_setzero_ps();
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    std::uint32_t bits = 0;
+    for (std::size_t k = 0; k < 4; k++) {
+      const __m256 x = _mm256_loadu_ps(X + i + 8 * k);
+      const __m256 keep = _mm256_cmp_ps(x, zero, _CMP_GT_OQ);
+      _mm256_storeu_ps(H + i + 8 * k, _mm256_and_ps(x, keep));
+      bits |= std::uint32_t(_mm256_movemask_ps(keep)) << (8 * k);
+    }
+    std::memcpy(mask + i / 8, &bits, sizeof(bits));
+  }
+  for (; i + 8 <= n; i += 8) {
+    const __m256 x = _mm256_loadu_ps(X + i);
+    const __m256 keep = _mm256_cmp_ps(x, zero, _CMP_GT_OQ);
+    _mm256_storeu_ps(H + i, _mm256_and_ps(x, keep));
+    mask[i / 8] = static_cast<std::uint8_t>(_mm256_movemask_ps(keep));
+  }
+  if (i < n) {
+    unsigned bits = 0;
+    for (std::size_t k = 0; i + k < n; k++) {
+      const bool fl = X[i + k] > 0.0f;
+      bits |= unsigned(fl) << k;
+      H[i + k] = fl ? X[i + k] : 0.0f;
+    }
+    mask[i / 8] = static_cast<std::uint8_t>(bits);
+  }
+}
+
+void relu_backward(const float *dH, const std::uint8_t *mask, float *dX,
+                   std::size_t n) {
+  // lane k keeps its value when bit k of the mask byte is set
+  const __m256i lane_bit = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i bits = _mm256_set1_epi32(mask[i / 8]);
+    const __m256i sel = _mm256_and_si256(bits, lane_bit);
+    const __m256 keep =
+        _mm256_castsi256_ps(_mm256_cmpeq_epi32(sel, lane_bit));
+    _mm256_storeu_ps(dX + i, _mm256_and_ps(_mm256_loadu_ps(dH + i), keep));
+  }
+  for (; i < n; i++)
+    dX[i] = ((mask[i / 8] >> (i % 8)) & 1u) ? dH[i] : 0.0f;
+}
+
+template <MathMode M>
+void exp_impl(const float *x, float *y, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(y + i, vexp<M>(_mm256_loadu_ps(x + i)));
+  for (; i < n; i++)
+    y[i] = exp_scalar<M>(x[i]);
+}
+
+template <MathMode M>
+void log_impl(const float *x, float *y, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(y + i, vlog<M>(_mm256_loadu_ps(x + i)));
+  for (; i < n; i++)
+    y[i] = log_scalar<M>(x[i]);
+}
+
+// exp(x - max) into out, returning the row max and the sum.
+template <MathMode M>
+void exp_shifted(const float *x, float *out, std::size_t n, float &maxv,
+                 float &sum) {
+  std::size_t j = 0;
+  __m256 vmax = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+  for (; j + 8 <= n; j += 8)
+    vmax = _mm256_max_ps(vmax, _mm256_loadu_ps(x + j));
+  maxv = hmax(vmax);
+  for (; j < n; j++)
+    maxv = (x[j] > maxv) ? x[j] : maxv;
+
+  const __m256 m = _mm256_set1_ps(maxv);
+  __m256 vsum = _mm256_setzero_ps();
+  for (j = 0; j + 8 <= n; j += 8) {
+    const __m256 e = vexp<M>(_mm256_sub_ps(_mm256_loadu_ps(x + j), m));
+    _mm256_storeu_ps(out + j, e);
+    vsum = _mm256_add_ps(vsum, e);
+  }
+  sum = hsum(vsum);
+  for (; j < n; j++) {
+    out[j] = exp_scalar<M>(x[j] - maxv);
+    sum += out[j];
+  }
+}
+
+void scale_row(float *p, std::size_t n, float s) {
+  const __m256 vs = _mm256_set1_ps(s);
+  std::size_t j = 0;
+  for (; j + 8 <= n; j += 8)
+    _mm256_storeu_ps(p + j, _mm256_mul_ps(_mm256_loadu_ps(p + j), vs));
+  for (; j < n; j++)
+    p[j] *= s;
+}
+
+template <MathMode M>
+void softmax_row_impl(const float *x, float *p, std::size_t n) {
+  float maxv, sum;
+  exp_shifted<M>(x, p, n, maxv, sum);
+  scale_row(p, n, 1.0f / sum);
+}
+
+template <MathMode M>
+float softmax_xent_row_impl(const float *x, float *g, std::size_t n,
+                            std::size_t label, float scale) {
+  float maxv, sum;
+  exp_shifted<M>(x, g, n, maxv, sum);
+  scale_row(g, n, scale / sum);
+  g[label] -= scale;
+  return (maxv - x[label]) + log_scalar<M>(sum);
+}
+
+void exp(const float *x, float *y, std::size_t n, MathMode mode) {
+  with_mode(mode, [&](auto m) { exp_impl<decltype(m)::value>(x, y, n); });
+}
+
+void log(const float *x, float *y, std::size_t n, MathMode mode) {
+  with_mode(mode, [&](auto m) { log_impl<decltype(m)::value>(x, y, n); });
+}
+
+void softmax_row(const float *x, float *p, std::size_t n, MathMode mode) {
+  with_mode(mode,
+            [&](auto m) { softmax_row_impl<decltype(m)::value>(x, p, n); });
+}
+
+float softmax_xent_row(const float *x, float *g, std::size_t n,
+                       std::size_t label, float scale, MathMode mode) {
+  return with_mode(mode, [&](auto m) {
+    return softmax_xent_row_impl<decltype(m)::value>(x, g, n, label, scale);
+  });
+}
+
+void axpy(float alpha, const float *x, float *y, std::size_t n) {
+  const __m256 va = _mm256_set1_ps(alpha);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(y + i, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i),
+                                            _mm256_loadu_ps(y + i)));
+  for (; i < n; i++)
+    y[i] += alpha * x[i];
+}
+
+// Plain SGD, or heavy-ball / Nesterov momentum with a velocity buffer.
+template <bool Momentum, bool Nesterov>
+void sgd_step_impl(float *w, float *g, float *v, std::size_t n,
+                   const SgdStep &s) {
+  const __m256 lr = _mm256_set1_ps(s.lr), wd = _mm256_set1_ps(s.weight_decay),
+               mu = _mm256_set1_ps(s.momentum), zero = _mm256_setzero_ps();
+  auto update = [&](__m256 vw, __m256 vg, __m256 &vv) {
+    const __m256 d = _mm256_fmadd_ps(wd, vw, vg);
+    __m256 u = d;
+    if constexpr (Momentum) {
+      vv = _mm256_fmadd_ps(mu, vv, d);
+      u = Nesterov ? _mm256_fmadd_ps(mu, vv, d) : vv;
+    }
+    return _mm256_fnmadd_ps(lr, u, vw);
+  };
+
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 vv = Momentum ? _mm256_loadu_ps(v + i) : zero;
+    const __m256 vw = _mm256_loadu_ps(w + i), vg = _mm256_loadu_ps(g + i);
+    _mm256_storeu_ps(w + i, update(vw, vg, vv));
+    if constexpr (Momentum)
+      _mm256_storeu_ps(v + i, vv);
+    _mm256_storeu_ps(g + i, zero);
+  }
+  for (; i < n; i++) {
+    const float d = g[i] + s.weight_decay * w[i];
+    float u = d;
+    if constexpr (Momentum) {
+      v[i] = s.momentum * v[i] + d;
+      u = Nesterov ? d + s.momentum * v[i] : v[i];
+    }
+    w[i] -= s.lr * u;
+    g[i] = 0.0f;
+  }
+}
+
+void sgd_step(float *w, float *g, float *v, std::size_t n, const SgdStep &s) {
+  if (!v)
+    sgd_step_impl<false, false>(w, g, v, n, s);
+  else if (s.nesterov)
+    sgd_step_impl<true, true>(w, g, v, n, s);
+  else
+    sgd_step_impl<true, false>(w, g, v, n, s);
+}
+
+void adam_step(float *w, float *g, float *m, float *v, std::size_t n,
+               const AdamStep &s) {
+  const FlushDenormals flush;
+  const __m256 l2 = _mm256_set1_ps(s.l2), eps = _mm256_set1_ps(s.eps);
+  const __m256 b1 = _mm256_set1_ps(s.beta1), b2 = _mm256_set1_ps(s.beta2);
+  const __m256 c1 = _mm256_set1_ps(1.0f - s.beta1),
+               c2 = _mm256_set1_ps(1.0f - s.beta2);
+  const __m256 shrink = _mm256_set1_ps(s.shrink), step = _mm256_set1_ps(s.step);
+  const __m256 rb2 = _mm256_set1_ps(s.rsqrt_bias2), zero = _mm256_setzero_ps();
+  auto update = [&](__m256 vw, __m256 vg, __m256 &vm, __m256 &vv) {
+    const __m256 d = _mm256_fmadd_ps(l2, vw, vg);
+    vm = _mm256_fmadd_ps(b1, vm, _mm256_mul_ps(c1, d));
+    vv = _mm256_fmadd_ps(b2, vv, _mm256_mul_ps(c2, _mm256_mul_ps(d, d)));
+    const __m256 denom = _mm256_fmadd_ps(_mm256_sqrt_ps(vv), rb2, eps);
+    return _mm256_fnmadd_ps(step, _mm256_div_ps(vm, denom),
+                            _mm256_mul_ps(shrink, vw));
+  };
+
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 vm = _mm256_loadu_ps(m + i), vv = _mm256_loadu_ps(v + i);
+    const __m256 vw = _mm256_loadu_ps(w + i), vg = _mm256_loadu_ps(g + i);
+    _mm256_storeu_ps(w + i, update(vw, vg, vm, vv));
+    _mm256_storeu_ps(m + i, vm);
+    _mm256_storeu_ps(v + i, vv);
+    _mm256_storeu_ps(g + i, zero);
+  }
+  const float sc1 = 1.0f - s.beta1, sc2 = 1.0f - s.beta2;
+  for (; i < n; i++) {
+    const float d = g[i] + s.l2 * w[i];
+    m[i] = s.beta1 * m[i] + sc1 * d;
+    v[i] = s.beta2 * v[i] + sc2 * (d * d);
+    const float denom = std::sqrt(v[i]) * s.rsqrt_bias2 + s.eps;
+    w[i] = s.shrink * w[i] - s.step * (m[i] / denom);
+    g[i] = 0.0f;
+  }
+}
+
+void u8_to_f32(const std::uint8_t *src, float *dst, std::size_t n,
+               float scale, float shift) {
+  const __m256 vs = _mm256_set1_ps(scale), vb = _mm256_set1_ps(shift);
+  auto convert = [&](__m128i bytes) {
+    return _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes)), vs,
+                           vb);
+  };
+
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+    const __m128i lo = _mm256_castsi256_si128(b),
+                  hi = _mm256_extracti128_si256(b, 1);
+    _mm256_storeu_ps(dst + i, convert(lo));
+    _mm256_storeu_ps(dst + i + 8, convert(_mm_srli_si128(lo, 8)));
+    _mm256_storeu_ps(dst + i + 16, convert(hi));
+    _mm256_storeu_ps(dst + i + 24, convert(_mm_srli_si128(hi, 8)));
+  }
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i,
+                     convert(_mm_loadl_epi64(
+                         reinterpret_cast<const __m128i *>(src + i))));
+  for (; i < n; i++)
+    dst[i] = static_cast<float>(src[i]) * scale + shift;
+}
+
+// Eight floats to bf16 in the low 16 bits of each lane, as
+// bf16_from_scalar.
+inline __m256i bf16_round(__m256 x) {
+  const __m256i u = _mm256_castps_si256(x);
+  const __m256i lsb =
+      _mm256_and_si256(_mm256_srli_epi32(u, 16), _mm256_set1_epi32(1));
+  const __m256i r = _mm256_srli_epi32(
+      _mm256_add_epi32(_mm256_add_epi32(u, _mm256_set1_epi32(0x7FFF)), lsb),
+      16);
+  const __m256i nan =
+      _mm256_cmpgt_epi32(_mm256_and_si256(u, _mm256_set1_epi32(0x7FFFFFFF)),
+                         _mm256_set1_epi32(0x7F800000));
+  const __m256i quiet =
+      _mm256_or_si256(_mm256_srli_epi32(u, 16), _mm256_set1_epi32(0x0040));
+  return _mm256_blendv_epi8(r, quiet, nan);
+}
+
+void f32_to_bf16(const float *src, std::uint16_t *dst, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i r = bf16_round(_mm256_loadu_ps(src + i));
+    const __m128i h = _mm_packus_epi32(_mm256_castsi256_si128(r),
+                                       _mm256_extracti128_si256(r, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), h);
+  }
+  for (; i < n; i++)
+    dst[i] = bf16_from_scalar(src[i]);
+}
+
+void bf16_to_f32(const std::uint16_t *src, float *dst, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i h =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(_mm256_slli_epi32(
+                                  _mm256_cvtepu16_epi32(h), 16)));
+  }
+  for (; i < n; i++)
+    dst[i] = bf16_to_scalar(src[i]);
+}
+
+// F16C, which every AVX2 CPU has (the tier requires it).
+void f32_to_f16(const float *src, std::uint16_t *dst, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(dst + i),
+        _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+  for (; i < n; i++)
+    dst[i] = f16_from_scalar(src[i]);
+}
+
+void f16_to_f32(const std::uint16_t *src, float *dst, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(
+                                  reinterpret_cast<const __m128i *>(src + i))));
+  for (; i < n; i++)
+    dst[i] = f16_to_scalar(src[i]);
+}
+
+// acc plus the dot products of the four-byte groups in each int32 lane,
+// uint8 a against int8 b: pmaddubsw into int16 pairs, pmaddwd by ones into
+// int32, or a single vpdpbusd with AVX-VNNI.
+inline __m256i dot4(__m256i acc, __m256i a, __m256i b) {
+  const __m256i pairs = _mm256_maddubs_epi16(a, b);
+  return _mm256_add_epi32(acc,
+                          _mm256_madd_epi16(pairs, _mm256_set1_epi16(1)));
+}
+[[gnu::target("avxvnni")]] inline __m256i dot4_vnni(__m256i acc, __m256i a,
+                                                    __m256i b) {
+  return _mm256_dpbusd_avx_epi32(acc, a, b);
+}
+
+// R rows against one panel, four int32 vectors per row.
+template <std::size_t R, bool Vnni>
+inline void qgemm_tile(const std::uint8_t *A, std::size_t lda, std::size_t k,
+                       const std::int8_t *B, std::int32_t *out) {
+  constexpr std::size_t V = QGEMM_NR / 8;
+  __m256i acc[R][V];
+  for (std::size_t r = 0; r < R; r++)
+    for (std::size_t v = 0; v < V; v++)
+      acc[r][v] = _mm256_setzero_si256();
+  for (std::size_t g = 0; g < k; g += QGEMM_KU, B += QGEMM_KU * QGEMM_NR) {
+    __m256i b[V];
+    for (std::size_t v = 0; v < V; v++)
+      b[v] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(B) + v);
+    for (std::size_t r = 0; r < R; r++) {
+      std::int32_t quad;
+      std::memcpy(&quad, A + r * lda + g, sizeof(quad));
+      const __m256i a = _mm256_set1_epi32(quad);
+      for (std::size_t v = 0; v < V; v++)
+        acc[r][v] = Vnni ? dot4_vnni(acc[r][v], a, b[v])
+                         : dot4(acc[r][v], a, b[v]);
+    }
+  }
+  for (std::size_t r = 0; r < R; r++)
+    for (std::size_t v = 0; v < V; v++)
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i *>(out + r * QGEMM_NR) + v, acc[r][v]);
+}
+
+// The VNNI tiles are built for AVX-VNNI as a whole; flatten pulls
+// dot4_vnni into the loop, which a plain inline call across the target
+// change would not.
+template <std::size_t R>
+void qgemm_tile_madd(const std::uint8_t *A, std::size_t lda, std::size_t k,
+                     const std::int8_t *B, std::int32_t *out) {
+  qgemm_tile<R, false>(A, lda, k, B, out);
+}
+template <std::size_t R>
+[[gnu::target("avxvnni"), gnu::flatten]] void
+qgemm_tile_vnni(const std::uint8_t *A, std::size_t lda, std::size_t k,
+                const std::int8_t *B, std::int32_t *out) {
+  qgemm_tile<R, true>(A, lda, k, B, out);
+}
+
+bool has_vnni() {
+  static const bool vnni = __builtin_cpu_supports("avxvnni");
+  return vnni;
+}
+
+void qgemm(const std::uint8_t *A, std::size_t lda, std::size_t rows,
+           std::size_t k, const std::int8_t *B, std::size_t n,
+           const QGemmEpilogue &ep) {
+  constexpr std::size_t QR = 2;
+  if (has_vnni())
+    qgemm_panels<QR>(&qgemm_tile_vnni<QR>, &qgemm_tile_vnni<1>, A, lda, rows,
+                     k, B, n, ep);
+  else
+    qgemm_panels<QR>(&qgemm_tile_madd<QR>, &qgemm_tile_madd<1>, A, lda, rows,
+                     k, B, n, ep);
+}
+
+// vpdpbusd adds the four products in int32; pmaddubsw saturates pairs of
+// them in int16.
+std::int32_t qgemm_act_max() {
+  return has_vnni() ? QGEMM_ACT_MAX : QGEMM_ACT_MAX_MADD;
+}
+
+const KernelTable s_Table = {
+    Tier::AVX2,
+    "avx2",
+    MR,
+    NR,
+    &gemm_micro,
+    &add_bias,
+    &sum_rows,
+    &relu_forward,
+    &relu_backward,
+    &exp,
+    &log,
+    &softmax_row,
+    &softmax_xent_row,
+    &axpy,
+    &sgd_step,
+    &adam_step,
+    &u8_to_f32,
+    &f32_to_bf16,
+    &bf16_to_f32,
+    &f32_to_f16,
+    &f16_to_f32,
+    &quantize_u8,
+    &qgemm,
+    &qgemm_act_max,
+};
+} // namespace
+
+const KernelTable &AVX2Table() { return s_Table; }
+} // namespace Logos::linalg::simd
+
+#endif
@@ -0,0 +1,680 @@
+#include "Kernels/Simd/MathCommon.hpp"
+#include "Kernels/Simd/Tables.hpp"
+
+#if LOGOS_SIMD_X86
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <immintrin.h>
+
+namespace Logos::linalg::simd {
+namespace {
+
+constexpr std::size_t MR = 8, NR = 32;
+
+inline __mmask16 tail_mask(std::size_t n) {
+  return static_cast<__mmask16>((1u << n) - 1u);
+}
+
+// Cephes-style expf, ~1 ulp over the clamped range.
+inline __m512 exp_ps(__m512 x) {
+  x = _mm512_min_ps(x, _mm512_set1_ps(EXP_MAX));
+  x = _mm512_max_ps(x, _mm512_set1_ps(-EXP_MAX));
+
+  __m512 fx = _mm512_fmadd_ps(x, _mm512_set1_ps(LOG2E), _mm512_set1_ps(0.5f));
+  fx = _mm512_roundscale_ps(fx, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+
+  x = _mm512_fnmadd_ps(fx, _mm512_set1_ps(LN2_HI), x);
+  x = _mm512_fnmadd_ps(fx, _mm512_set1_ps(LN2_LO), x);
+
+  const __m512 z = _mm512_mul_ps(x, x);
+  __m512 y = _mm512_set1_ps(EXP_P0);
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(EXP_P1));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(EXP_P2));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(EXP_P3));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(EXP_P4));
+  y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(EXP_P5));
+  y = _mm512_add_ps(_mm512_fmadd_ps(y, z, x), _mm512_set1_ps(1.0f));
+
+  __m512i e = _mm512_cvttps_epi32(fx);
+  e = _mm512_slli_epi32(_mm512_add_epi32(e, _mm512_set1_epi32(127)), 23);
+  return _mm512_mul_ps(y, _mm512_castsi512_ps(e));
+}
+
+// 2^n * p(f) with the cubic from MathCommon.hpp, ~1e-4 relative.
+inline __m512 fast_exp_ps(__m512 x) {
+  x = _mm512_min_ps(x, _mm512_set1_ps(EXP_MAX));
+  x = _mm512_max_ps(x, _mm512_set1_ps(FAST_EXP_MIN));
+
+  const __m512 t = _mm512_mul_ps(x, _mm512_set1_ps(LOG2E));
+  const __m512 n =
+      _mm512_roundscale_ps(t, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+  const __m512 f = _mm512_sub_ps(t, n);
+
+  __m512 p = _mm512_fmadd_ps(_mm512_set1_ps(EXP2_C3), f,
+                             _mm512_set1_ps(EXP2_C2));
+  p = _mm512_fmadd_ps(p, f, _mm512_set1_ps(EXP2_C1));
+  p = _mm512_fmadd_ps(p, f, _mm512_set1_ps(EXP2_C0));
+
+  __m512i e = _mm512_cvttps_epi32(n);
+  e = _mm512_slli_epi32(_mm512_add_epi32(e, _mm512_set1_epi32(127)), 23);
+  return _mm512_mul_ps(p, _mm512_castsi512_ps(e));
+}
+
+// Accurate or fast log of positive normal lanes; anything else is redone
+// with std::log.
+template <MathMode M> inline __m512 log_ps(__m512 x) {
+  const __m512i bits = _mm512_castps_si512(x);
+  __m512 e = _mm512_cvtepi32_ps(_mm512_sub_epi32(
+      _mm512_srli_epi32(bits, 23), _mm512_set1_epi32(126)));
+  __m512 m = _mm512_castsi512_ps(
+      _mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi32(0x007FFFFF)),
+                      _mm512_set1_epi32(0x3F000000)));
+  const __mmask16 lo =
+      _mm512_cmp_ps_mask(m, _mm512_set1_ps(SQRT_HALF), _CMP_LT_OQ);
+  m = _mm512_mask_add_ps(m, lo, m, m);
+  e = _mm512_mask_sub_ps(e, lo, e, _mm512_set1_ps(1.0f));
+
+  __m512 r;
+  if constexpr (M == MathMode::Accurate) {
+    const __m512 t = _mm512_sub_ps(m, _mm512_set1_ps(1.0f));
+    const __m512 z = _mm512_mul_ps(t, t);
+    __m512 y = _mm512_set1_ps(LOG_P0);
+    y = _mm512_fmadd_ps(y, t, _mm512_set1_ps(LOG_P1));
+    y = _mm512_fmadd_ps(y, t, _mm512_set1_ps(LOG_P2));
+    y = _mm512_fmadd_ps(y, t, _mm512_set1_ps(LOG_P3));
+    y = _mm512_fmadd_ps(y, t, _mm512_set1_ps(LOG_P4));
+    y = _mm512_fmadd_ps(y, t, _mm512_set1_ps(LOG_P5));
+    y = _mm512_fmadd_ps(y, t, _mm512_set1_ps(LOG_P6));
+    y = _mm512_fmadd_ps(y, t, _mm512_set1_ps(LOG_P7));
+    y = _mm512_fmadd_ps(y, t, _mm512_set1_ps(LOG_P8));
+    y = _mm512_mul_ps(_mm512_mul_ps(y, t), z);
+    y = _mm512_fmadd_ps(e, _mm512_set1_ps(LN2_LO), y);
+    y = _mm512_fnmadd_ps(_mm512_set1_ps(0.5f), z, y);
+    r = _mm512_fmadd_ps(e, _mm512_set1_ps(LN2_HI), _mm512_add_ps(t, y));
+  } else {
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 u =
+        _mm512_div_ps(_mm512_sub_ps(m, one), _mm512_add_ps(m, one));
+    const __m512 u2 = _mm512_mul_ps(u, u);
+    const __m512 l = _mm512_mul_ps(
+        _mm512_add_ps(u, u), _mm512_fmadd_ps(_mm512_set1_ps(LOG_C1), u2,
+                                             _mm512_set1_ps(LOG_C0)));
+    r = _mm512_fmadd_ps(e, _mm512_set1_ps(LN2_HI + LN2_LO), l);
+  }
+
+  const __mmask16 normal =
+      _mm512_cmp_ps_mask(x, _mm512_set1_ps(MIN_NORMAL), _CMP_GE_OQ) &
+      _mm512_cmp_ps_mask(x, _mm512_set1_ps(INFINITY), _CMP_LT_OQ);
+  if (normal != 0xFFFF) {
+    alignas(64) float xs[16], rs[16];
+    _mm512_store_ps(xs, x);
+    _mm512_store_ps(rs, r);
+    for (int i = 0; i < 16; i++)
+      if (!(normal & (1 << i)))
+        rs[i] = std::log(xs[i]);
+    r = _mm512_load_ps(rs);
+  }
+  return r;
+}
+
+template <MathMode M> inline __m512 vexp(__m512 x) {
+  if constexpr (M == MathMode::Exact) {
+    alignas(64) float v[16];
+    _mm512_store_ps(v, x);
+    for (float &e : v)
+      e = std::exp(e);
+    return _mm512_load_ps(v);
+  } else if constexpr (M == MathMode::Accurate) {
+    return exp_ps(x);
+  } else {
+    return fast_exp_ps(x);
+  }
+}
+
+template <MathMode M> inline __m512 vlog(__m512 x) {
+  if constexpr (M == MathMode::Exact) {
+    alignas(64) float v[16];
+    _mm512_store_ps(v, x);
+    for (float &e : v)
+      e = std::log(e);
+    return _mm512_load_ps(v);
+  } else {
+    return log_ps<M>(x);
+  }
+}
+
+void gemm_micro(std::size_t kc, const float *a, const float *b, float *C,
+                std::size_t ldc, float alpha, float beta,
+                const GemmEpilogue<float> *ep) {
+  __m512 c[MR][2];
+  for (std::size_t r = 0; r < MR; r++)
+    c[r][0] = c[r][1] = _mm512_setzero_ps();
+
+  for (std::size_t p = 0; p < kc; p++) {
+    const __m512 b0 = _mm512_load_ps(b), b1 = _mm512_load_ps(b + 16);
+    for (std::size_t r = 0; r < MR; r++) {
+      const __m512 av = _mm512_set1_ps(a[r]);
+      c[r][0] = _mm512_fmadd_ps(av, b0, c[r][0]);
+      c[r][1] = _mm512_fmadd_ps(av, b1, c[r][1]);
+    }
+    a += MR;
+    b += NR;
+  }
+
+  const __m512 va = _mm512_set1_ps(alpha), vb = _mm512_set1_ps(beta);
+  const __m512 zero = _mm512_setzero_ps();
+  const bool bias = ep && ep->bias, relu = ep && ep->relu;
+  const __m512 b0 = bias ? _mm512_loadu_ps(ep->bias) : zero,
+               b1 = bias ? _mm512_loadu_ps(ep->bias + 16) : zero;
+  for (std::size_t r = 0; r < MR; r++) {
+    float *row = C + r * ldc;
+    __m512 r0 = _mm512_mul_ps(va, c[r][0]), r1 = _mm512_mul_ps(va, c[r][1]);
+    if (beta != 0.0f) {
+      r0 = _mm512_fmadd_ps(vb, _mm512_loadu_ps(row), r0);
+      r1 = _mm512_fmadd_ps(vb, _mm512_loadu_ps(row + 16), r1);
+    }
+    if (bias) {
+      r0 = _mm512_add_ps(r0, b0);
+      r1 = _mm512_add_ps(r1, b1);
+    }
+    if (relu) {
+      const __mmask16 k0 = _mm512_cmp_ps_mask(r0, zero, _CMP_GT_OQ),
+                      k1 = _mm512_cmp_ps_mask(r1, zero, _CMP_GT_OQ);
+      r0 = _mm512_maskz_mov_ps(k0, r0);
+      r1 = _mm512_maskz_mov_ps(k1, r1);
+      if (ep->mask) {
+        const std::uint32_t bits = k0 | (std::uint32_t{k1} << 16);
+        std::memcpy(ep->mask + r * ep->ldm, &bits, sizeof(bits));
+      }
+    }
+    _mm512_storeu_ps(row, r0);
+    _mm512_storeu_ps(row + 16, r1);
+  }
+}
+
+void add_bias(const float *b, float *X, std::size_t rows, std::size_t cols,
+              std::size_t ld) {
+  for (std::size_t i = 0; i < rows; i++) {
+    float *row = X + i * ld;
+    std::size_t j = 0;
+    for (; j + 16 <= cols; j += 16)
+      _mm512_storeu_ps(row + j, _mm512_add_ps(_mm512_loadu_ps(row + j),
+                                              _mm512_loadu_ps(b + j)));
+    if (j < cols) {
+      const __mmask16 k = tail_mask(cols - j);
+      _mm512_mask_storeu_ps(row + j, k,
+                            _mm512_add_ps(_mm512_maskz_loadu_ps(k, row + j),
+                                          _mm512_maskz_loadu_ps(k, b + j)));
+    }
+  }
+}
+
+void sum_rows(const float *X, std::size_t rows, std::size_t cols,
+              std::size_t ld, float *out) {
+  std::memset(out, 0, cols * sizeof(float));
+  for (std::size_t i = 0; i < rows; i++) {
+    const float *row = X + i * ld;
+    std::size_t j = 0;
+    for (; j + 16 <= cols; j += 16)
+      _mm512_storeu_ps(out + j, _mm512_add_ps(_mm512_loadu_ps(out + j),
+                                              _mm512_loadu_ps(row + j)));
+    if (j < cols) {
+      const __mmask16 k = tail_mask(cols - j);
+      _mm512_mask_storeu_ps(out + j, k,
+                            _mm512_add_ps(_mm512_maskz_loadu_ps(k, out + j),
+                                          _mm512_maskz_loadu_ps(k, row + j)));
+    }
+  }
+}
+
+// The compare mask of 16 lanes is two bytes of the packed ReLU mask; a
+// tail of n < 16 lanes takes MaskBytes(n) of them.
+void relu_forward(const float *X, float *H, std::uint8_t *mask,
+                  std::size_t n) {
+  const __m512 zero = _mm512_setzero_ps();
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512 x = _mm512_loadu_ps(X + i);
+    const __mmask16 keep = _mm512_cmp_ps_mask(x, zero, _CMP_GT_OQ);
+    _mm512_storeu_ps(H + i, _mm512_maskz_mov_ps(keep, x));
+    const auto bits = static_cast<std::uint16_t>(keep);
+    std::memcpy(mask + i / 8, &bits, sizeof(bits));
+  }
+  if (i < n) {
+    const __mmask16 t = tail_mask(n - i);
+    const __m512 x = _mm512_maskz_loadu_ps(t, X + i);
+    const __mmask16 keep = _mm512_cmp_ps_mask(x, zero, _CMP_GT_OQ);
+    _mm512_mask_storeu_ps(H + i, t, _mm512_maskz_mov_ps(keep, x));
+    const auto bits = static_cast<std::uint16_t>(keep & t);
+    std::memcpy(mask + i / 8, &bits, MaskBytes(n - i));
+  }
+}
+
+void relu_backward(const float *dH, const std::uint8_t *mask, float *dX,
+                   std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    std::uint16_t bits;
+    std::memcpy(&bits, mask + i / 8, sizeof(bits));
+    _mm512_storeu_ps(dX + i, _mm512_maskz_loadu_ps(bits, dH + i));
+  }
+  if (i < n) {
+    const __mmask16 t = tail_mask(n - i);
+    std::uint16_t bits = 0;
+    std::memcpy(&bits, mask + i / 8, MaskBytes(n - i));
+    _mm512_mask_storeu_ps(dX + i, t,
+                          _mm512_maskz_loadu_ps(bits & t, dH + i));
+  }
+}
+
+template <MathMode M>
+void exp_impl(const float *x, float *y, std::size_t n) {
+  for (std::size_t i = 0; i < n; i += 16) {
+    const __mmask16 t = (n - i >= 16) ? __mmask16(0xFFFF) : tail_mask(n - i);
+    _mm512_mask_storeu_ps(y + i, t, vexp<M>(_mm512_maskz_loadu_ps(t, x + i)));
+  }
+}
+
+template <MathMode M>
+void log_impl(const float *x, float *y, std::size_t n) {
+  const __m512 one = _mm512_set1_ps(1.0f);
+  for (std::size_t i = 0; i < n; i += 16) {
+    const __mmask16 t = (n - i >= 16) ? __mmask16(0xFFFF) : tail_mask(n - i);
+    _mm512_mask_storeu_ps(y + i, t,
+                          vlog<M>(_mm512_mask_loadu_ps(one, t, x + i)));
+  }
+}
+
+// exp(x - max) into out, returning the row max and the sum.
+template <MathMode M>
+void exp_shifted(const float *x, float *out, std::size_t n, float &maxv,
+                 float &sum) {
+  const __m512 lowest = _mm512_set1_ps(std::numeric_limits<float>::lowest());
+  __m512 vmax = lowest;
+  for (std::size_t j = 0; j < n; j += 16) {
+    const __mmask16 t = (n - j >= 16) ? __mmask16(0xFFFF) : tail_mask(n - j);
+    vmax = _mm512_max_ps(vmax, _mm512_mask_loadu_ps(lowest, t, x + j));
+  }
+  maxv = _mm512_reduce_max_ps(vmax);
+  const __m512 m = _mm512_set1_ps(maxv);
+
+  __m512 vsum = _mm512_setzero_ps();
+  for (std::size_t j = 0; j < n; j += 16) {
+    const __mmask16 t = (n - j >= 16) ? __mmask16(0xFFFF) : tail_mask(n - j);
+    const __m512 e =
+        vexp<M>(_mm512_sub_ps(_mm512_maskz_loadu_ps(t, x + j), m));
+    _mm512_mask_storeu_ps(out + j, t, e);
+    vsum = _mm512_mask_add_ps(vsum, t, vsum, e);
+  }
+  sum = _mm512_reduce_add_ps(vsum);
+}
+
+void scale_row(float *p, std::size_t n, float s) {
+  const __m512 vs = _mm512_set1_ps(s);
+  for (std::size_t j = 0; j < n; j += 16) {
+    const __mmask16 t = (n - j >= 16) ? __mmask16(0xFFFF) : tail_mask(n - j);
+    _mm512_mask_storeu_ps(p + j, t,
+                          _mm512_mul_ps(_mm512_maskz_loadu_ps(t, p + j), vs));
+  }
+}
+
+template <MathMode M>
+void softmax_row_impl(const float *x, float *p, std::size_t n) {
+  float maxv, sum;
+  exp_shifted<M>(x, p, n, maxv, sum);
+  scale_row(p, n, 1.0f / sum);
+}
+
+template <MathMode M>
+float softmax_xent_row_impl(const float *x, float *g, std::size_t n,
+                            std::size_t label, float scale) {
+  float maxv, sum;
+  exp_shifted<M>(x, g, n, maxv, sum);
+  scale_row(g, n, scale / sum);
+  g[label] -= scale;
+  return (maxv - x[label]) + log_scalar<M>(sum);
+}
+
+void exp(const float *x, float *y, std::size_t n, MathMode mode) {
+  with_mode(mode, [&](auto m) { exp_impl<decltype(m)::value>(x, y, n); });
+}
+
+void log(const float *x, float *y, std::size_t n, MathMode mode) {
+  with_mode(mode, [&](auto m) { log_impl<decltype(m)::value>(x, y, n); });
+}
+
+void softmax_row(const float *x, float *p, std::size_t n, MathMode mode) {
+  with_mode(mode,
+            [&](auto m) { softmax_row_impl<decltype(m)::value>(x, p, n); });
+}
+
+float softmax_xent_row(const float *x, float *g, std::size_t n,
+                       std::size_t label, float scale, MathMode mode) {
+  return with_mode(mode, [&](auto m) {
+    return softmax_xent_row_impl<decltype(m)::value>(x, g, n, label, scale);
+  });
+}
+
+void axpy(float alpha, const float *x, float *y, std::size_t n) {
+  const __m512 va = _mm512_set1_ps(alpha);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(y + i, _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i),
+                                            _mm512_loadu_ps(y + i)));
+  if (i < n) {
+    const __mmask16 k = tail_mask(n - i);
+    _mm512_mask_storeu_ps(y + i, k,
+                          _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(k, x + i),
+                                          _mm512_maskz_loadu_ps(k, y + i)));
+  }
+}
+
+// Plain SGD, or heavy-ball / Nesterov momentum with a velocity buffer.
+template <bool Momentum, bool Nesterov>
+void sgd_step_impl(float *w, float *g, float *v, std::size_t n,
+                   const SgdStep &s) {
+  const __m512 lr = _mm512_set1_ps(s.lr), wd = _mm512_set1_ps(s.weight_decay),
+               mu = _mm512_set1_ps(s.momentum), zero = _mm512_setzero_ps();
+  auto update = [&](__m512 vw, __m512 vg, __m512 &vv) {
+    const __m512 d = _mm512_fmadd_ps(wd, vw, vg);
+    __m512 u = d;
+    if constexpr (Momentum) {
+      vv = _mm512_fmadd_ps(mu, vv, d);
+      u = Nesterov ? _mm512_fmadd_ps(mu, vv, d) : vv;
+    }
+    return _mm512_fnmadd_ps(lr, u, vw);
+  };
+
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512 vv = Momentum ? _mm512_loadu_ps(v + i) : zero;
+    const __m512 vw = _mm512_loadu_ps(w + i), vg = _mm512_loadu_ps(g + i);
+    _mm512_storeu_ps(w + i, update(vw, vg, vv));
+    if constexpr (Momentum)
+      _mm512_storeu_ps(v + i, vv);
+    _mm512_storeu_ps(g + i, zero);
+  }
+  if (i < n) {
+    const __mmask16 k = tail_mask(n - i);
+    __m512 vv = Momentum ? _mm512_maskz_loadu_ps(k, v + i) : zero;
+    _mm512_mask_storeu_ps(w + i, k,
+                          update(_mm512_maskz_loadu_ps(k, w + i),
+                                 _mm512_maskz_loadu_ps(k, g + i), vv));
+    if constexpr (Momentum)
+      _mm512_mask_storeu_ps(v + i, k, vv);
+    _mm512_mask_storeu_ps(g + i, k, zero);
+  }
+}
+
+void sgd_step(float *w, float *g, float *v, std::size_t n, const SgdStep &s) {
+  if (!v)
+    sgd_step_impl<false, false>(w, g, v, n, s);
+  else if (s.nesterov)
+    sgd_step_impl<true, true>(w, g, v, n, s);
+  else
+    sgd_step_impl<true, false>(w, g, v, n, s);
+}
+
+void adam_step(float *w, float *g, float *m, float *v, std::size_t n,
+               const AdamStep &s) {
+  const FlushDenormals flush;
+  const __m512 l2 = _mm512_set1_ps(s.l2), eps = _mm512_set1_ps(s.eps);
+  const __m512 b1 = _mm512_set1_ps(s.beta1), b2 = _mm512_set1_ps(s.beta2);
+  const __m512 c1 = _mm512_set1_ps(1.0f - s.beta1),
+               c2 = _mm512_set1_ps(1.0f - s.beta2);
+  const __m512 shrink = _mm512_set1_ps(s.shrink), step = _mm512_set1_ps(s.step);
+  const __m512 rb2 = _mm512_set1_ps(s.rsqrt_bias2), zero = _mm512_setzero_ps();
+  auto update = [&](__m512 vw, __m512 vg, __m512 &vm, __m512 &vv) {
+    const __m512 d = _mm512_fmadd_ps(l2, vw, vg);
+    vm = _mm512_fmadd_ps(b1, vm, _mm512_mul_ps(c1, d));
+    vv = _mm512_fmadd_ps(b2, vv, _mm512_mul_ps(c2, _mm512_mul_ps(d, d)));
+    const __m512 denom = _mm512_fmadd_ps(_mm512_sqrt_ps(vv), rb2, eps);
+    return _mm512_fnmadd_ps(step, _mm512_div_ps(vm, denom),
+                            _mm512_mul_ps(shrink, vw));
+  };
+
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512 vm = _mm512_loadu_ps(m + i), vv = _mm512_loadu_ps(v + i);
+    const __m512 vw = _mm512_loadu_ps(w + i), vg = _mm512_loadu_ps(g + i);
+    _mm512_storeu_ps(w + i, update(vw, vg, vm, vv));
+    _mm512_storeu_ps(m + i, vm);
+    _mm512_storeu_ps(v + i, vv);
+    _mm512_storeu_ps(g + i, zero);
+  }
+  if (i < n) {
+    const __mmask16 k = tail_mask(n - i);
+    __m512 vm = _mm512_maskz_loadu_ps(k, m + i),
+           vv = _mm512_maskz_loadu_ps(k, v + i);
+    _mm512_mask_storeu_ps(w + i, k,
+                          update(_mm512_maskz_loadu_ps(k, w + i),
+                                 _mm512_maskz_loadu_ps(k, g + i), vm, vv));
+    _mm512_mask_storeu_ps(m + i, k, vm);
+    _mm512_mask_storeu_ps(v + i, k, vv);
+    _mm512_mask_storeu_ps(g + i, k, zero);
+  }
+}
+
+void u8_to_f32(const std::uint8_t *src, float *dst, std::size_t n,
+               float scale, float shift) {
+  const __m512 vs = _mm512_set1_ps(scale), vb = _mm512_set1_ps(shift);
+  auto convert = [&](__m128i bytes) {
+    return _mm512_fmadd_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(bytes)), vs,
+                           vb);
+  };
+
+  std::size_t i = 0;
+  for (; i + 64 <= n; i += 64) {
+    const __m512i b =
+        _mm512_loadu_si512(reinterpret_cast<const void *>(src + i));
+    _mm512_storeu_ps(dst + i, convert(_mm512_castsi512_si128(b)));
+    _mm512_storeu_ps(dst + i + 16, convert(_mm512_extracti32x4_epi32(b, 1)));
+    _mm512_storeu_ps(dst + i + 32, convert(_mm512_extracti32x4_epi32(b, 2)));
+    _mm512_storeu_ps(dst + i + 48, convert(_mm512_extracti32x4_epi32(b, 3)));
+  }
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(dst + i, convert(_mm_loadu_si128(
+                                  reinterpret_cast<const __m128i *>(src + i))));
+  if (i < n) {
+    const __mmask16 k = tail_mask(n - i);
+    _mm512_mask_storeu_ps(dst + i, k,
+                          convert(_mm_maskz_loadu_epi8(k, src + i)));
+  }
+}
+
+// Sixteen floats to bf16 in the low 16 bits of each lane, as
+// bf16_from_scalar.
+inline __m512i bf16_round(__m512 x) {
+  const __m512i u = _mm512_castps_si512(x);
+  const __m512i lsb =
+      _mm512_and_si512(_mm512_srli_epi32(u, 16), _mm512_set1_epi32(1));
+  const __m512i r = _mm512_srli_epi32(
+      _mm512_add_epi32(_mm512_add_epi32(u, _mm512_set1_epi32(0x7FFF)), lsb),
+      16);
+  const __m512i a = _mm512_and_si512(u, _mm512_set1_epi32(0x7FFFFFFF));
+  const __mmask16 nan =
+      _mm512_cmpgt_epi32_mask(a, _mm512_set1_epi32(0x7F800000));
+  return _mm512_mask_or_epi32(r, nan, _mm512_srli_epi32(u, 16),
+                              _mm512_set1_epi32(0x0040));
+}
+
+// AVX512_BF16's vcvtneps2bf16 rounds the same way, but treats denormal
+// inputs as zero; they are below 1.2e-38, where bf16 keeps 0-6 bits anyway.
+[[gnu::target("avx512bf16")]] void
+f32_to_bf16_native(const float *src, std::uint16_t *dst, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                        (__m256i)_mm512_cvtneps_pbh(_mm512_loadu_ps(src + i)));
+  if (i < n) {
+    const __mmask16 k = tail_mask(n - i);
+    const __m256bh h = _mm512_cvtneps_pbh(_mm512_maskz_loadu_ps(k, src + i));
+    _mm256_mask_storeu_epi16(dst + i, k, (__m256i)h);
+  }
+}
+
+void f32_to_bf16(const float *src, std::uint16_t *dst, std::size_t n) {
+  static const bool native = __builtin_cpu_supports("avx512bf16");
+  if (native) {
+    f32_to_bf16_native(src, dst, n);
+    return;
+  }
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(dst + i),
+        _mm512_cvtepi32_epi16(bf16_round(_mm512_loadu_ps(src + i))));
+  if (i < n) {
+    const __mmask16 k = tail_mask(n - i);
+    _mm512_mask_cvtepi32_storeu_epi16(
+        dst + i, k, bf16_round(_mm512_maskz_loadu_ps(k, src + i)));
+  }
+}
+
+void bf16_to_f32(const std::uint16_t *src, float *dst, std::size_t n) {
+  auto widen = [](__m256i h) {
+    return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(h), 16));
+  };
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(dst + i, widen(_mm256_loadu_si256(
+                                  reinterpret_cast<const __m256i *>(src + i))));
+  if (i < n) {
+    const __mmask16 k = tail_mask(n - i);
+    _mm512_mask_storeu_ps(dst + i, k,
+                          widen(_mm256_maskz_loadu_epi16(k, src + i)));
+  }
+}
+
+void f32_to_f16(const float *src, std::uint16_t *dst, std::size_t n) {
+  constexpr int round = _MM_FROUND_TO_NEAREST_INT;
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                        _mm512_cvtps_ph(_mm512_loadu_ps(src + i), round));
+  if (i < n) {
+    const __mmask16 k = tail_mask(n - i);
+    _mm256_mask_storeu_epi16(
+        dst + i, k, _mm512_cvtps_ph(_mm512_maskz_loadu_ps(k, src + i), round));
+  }
+}
+
+void f16_to_f32(const std::uint16_t *src, float *dst, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(_mm256_loadu_si256(
+                                  reinterpret_cast<const __m256i *>(src + i))));
+  if (i < n) {
+    const __mmask16 k = tail_mask(n - i);
+    const __m256i h = _mm256_maskz_loadu_epi16(k, src + i);
+    _mm512_mask_storeu_ps(dst + i, k, _mm512_cvtph_ps(h));
+  }
+}
+
+// As in the AVX2 tier: acc plus the four-byte dot products of each int32
+// lane, through pmaddubsw and pmaddwd, or vpdpbusd with AVX512-VNNI.
+inline __m512i dot4(__m512i acc, __m512i a, __m512i b) {
+  const __m512i pairs = _mm512_maddubs_epi16(a, b);
+  return _mm512_add_epi32(acc,
+                          _mm512_madd_epi16(pairs, _mm512_set1_epi16(1)));
+}
+[[gnu::target("avx512vnni")]] inline __m512i dot4_vnni(__m512i acc, __m512i a,
+                                                       __m512i b) {
+  return _mm512_dpbusd_epi32(acc, a, b);
+}
+
+// R rows against one panel, two int32 vectors per row.
+template <std::size_t R, bool Vnni>
+inline void qgemm_tile(const std::uint8_t *A, std::size_t lda, std::size_t k,
+                       const std::int8_t *B, std::int32_t *out) {
+  constexpr std::size_t V = QGEMM_NR / 16;
+  __m512i acc[R][V];
+  for (std::size_t r = 0; r < R; r++)
+    for (std::size_t v = 0; v < V; v++)
+      acc[r][v] = _mm512_setzero_si512();
+  for (std::size_t g = 0; g < k; g += QGEMM_KU, B += QGEMM_KU * QGEMM_NR) {
+    __m512i b[V];
+    for (std::size_t v = 0; v < V; v++)
+      b[v] = _mm512_loadu_si512(B + 64 * v);
+    for (std::size_t r = 0; r < R; r++) {
+      std::int32_t quad;
+      std::memcpy(&quad, A + r * lda + g, sizeof(quad));
+      const __m512i a = _mm512_set1_epi32(quad);
+      for (std::size_t v = 0; v < V; v++)
+        acc[r][v] = Vnni ? dot4_vnni(acc[r][v], a, b[v])
+                         : dot4(acc[r][v], a, b[v]);
+    }
+  }
+  for (std::size_t r = 0; r < R; r++)
+    for (std::size_t v = 0; v < V; v++)
+      _mm512_storeu_si512(out + r * QGEMM_NR + 16 * v, acc[r][v]);
+}
+
+template <std::size_t R>
+void qgemm_tile_madd(const std::uint8_t *A, std::size_t lda, std::size_t k,
+                     const std::int8_t *B, std::int32_t *out) {
+  qgemm_tile<R, false>(A, lda, k, B, out);
+}
+template <std::size_t R>
+[[gnu::target("avx512vnni"), gnu::flatten]] void
+qgemm_tile_vnni(const std::uint8_t *A, std::size_t lda, std::size_t k,
+                const std::int8_t *B, std::int32_t *out) {
+  qgemm_tile<R, true>(A, lda, k, B, out);
+}
+
+bool has_vnni() {
+  static const bool vnni = __builtin_cpu_supports("avx512vnni");
+  return vnni;
+}
+
+void qgemm(const std::uint8_t *A, std::size_t lda, std::size_t rows,
+           std::size_t k, const std::int8_t *B, std::size_t n,
+           const QGemmEpilogue &ep) {
+  constexpr std::size_t QR = 4;
+  if (has_vnni())
+    qgemm_panels<QR>(&qgemm_tile_vnni<QR>, &qgemm_tile_vnni<1>, A, lda, rows,
+                     k, B, n, ep);
+  else
+    qgemm_panels<QR>(&qgemm_tile_madd<QR>, &qgemm_tile_madd<1>, A, lda, rows,
+                     k, B, n, ep);
+}
+
+std::int32_t qgemm_act_max() {
+  return has_vnni() ? QGEMM_ACT_MAX : QGEMM_ACT_MAX_MADD;
+}
+
+const KernelTable s_Table = {
+    Tier::AVX512,
+    "avx512",
+    MR,
+    NR,
+    &gemm_micro,
+    &add_bias,
+    &sum_rows,
+    &relu_forward,
+    &relu_backward,
+    &exp,
+    &log,
+    &softmax_row,
+    &softmax_xent_row,
+    &axpy,
+    &sgd_step,
+    &adam_step,
+    &u8_to_f32,
+    &f32_to_bf16,
+    &bf16_to_f32,
+    &f32_to_f16,
+    &f16_to_f32,
+    &quantize_u8,
+    &qgemm,
+    &qgemm_act_max,
+};
+} // namespace
+
+const KernelTable &AVX512Table() { return s_Table; }
+} // namespace Logos::linalg::simd
+
+#endif
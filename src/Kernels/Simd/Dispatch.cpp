@@ -0,0 +1,127 @@
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+#include "Kernels/Simd/Tables.hpp"
+
+namespace Logos::linalg::simd {
+namespace {
+
+Tier Detect() {
+#if LOGOS_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+  __builtin_cpu_init();
+  // Must cover every -mavx512* flag AVX512.cpp is built with.
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512dq"))
+    return Tier::AVX512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+      __builtin_cpu_supports("f16c"))
+    return Tier::AVX2;
+  if (__builtin_cpu_supports("sse4.2"))
+    return Tier::SSE42;
+#endif
+  return Tier::Scalar;
+}
+
+const KernelTable &TableFor(Tier tier) {
+#if LOGOS_SIMD_X86
+  switch (tier) {
+  case Tier::AVX512:
+    return AVX512Table();
+  case Tier::AVX2:
+    return AVX2Table();
+  case Tier::SSE42:
+    return SSE42Table();
+  case Tier::Scalar:
+    break;
+  }
+#endif
+  return ScalarTable();
+}
+
+bool ParseTier(std::string_view name, Tier &tier) {
+  if (name == "scalar")
+    tier = Tier::Scalar;
+  else if (name == "sse4.2" || name == "sse42")
+    tier = Tier::SSE42;
+  else if (name == "avx2")
+    tier = Tier::AVX2;
+  else if (name == "avx512")
+    tier = Tier::AVX512;
+  else
+    return false;
+  return true;
+}
+
+const KernelTable *SelectAtStartup() {
+  Tier tier = DetectedTier();
+
+  if (const char *env = std::getenv("LOGOS_SIMD")) {
+    Tier forced;
+    if (!ParseTier(env, forced))
+      std::cerr << "LOGOS_SIMD: unknown tier '" << env << "', using "
+                << TierName(tier) << '\n';
+    else if (forced > tier)
+      std::cerr << "LOGOS_SIMD: " << TierName(forced)
+                << " is not supported by this CPU, using " << TierName(tier)
+                << '\n';
+    else
+      tier = forced;
+  }
+
+  return &TableFor(tier);
+}
+
+std::atomic<const KernelTable *> s_Active{nullptr};
+} // namespace
+
+const KernelTable &Kernels() {
+  if (const auto *table = s_Active.load(std::memory_order_acquire))
+    return *table;
+
+  static const KernelTable *startup = SelectAtStartup();
+  const KernelTable *expected = nullptr;
+  s_Active.compare_exchange_strong(expected, startup,
+                                   std::memory_order_acq_rel);
+  return *s_Active.load(std::memory_order_acquire);
+}
+
+Tier DetectedTier() {
+  static const Tier tier = Detect();
+  return tier;
+}
+
+Tier ForceTier(Tier tier) {
+  if (tier > DetectedTier())
+    tier = DetectedTier();
+  s_Active.store(&TableFor(tier), std::memory_order_release);
+  return tier;
+}
+
+const char *TierName(Tier tier) {
+  switch (tier) {
+  case Tier::Scalar:
+    return "scalar";
+  case Tier::SSE42:
+    return "sse4.2";
+  case Tier::AVX2:
+    return "avx2";
+  case Tier::AVX512:
+    return "avx512";
+  }
+  return "unknown";
+}
+
+const char *MathModeName(MathMode mode) {
+  switch (mode) {
+  case MathMode::Exact:
+    return "exact";
+  case MathMode::Accurate:
+    return "accurate";
+  case MathMode::Fast:
+    return "fast";
+  }
+  return "unknown";
+}
+} // namespace Logos::linalg::simd
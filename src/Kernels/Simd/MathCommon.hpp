@@ -0,0 +1,277 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include "Kernels/Simd.hpp"
+
+#if defined(__SSE2__)
+#include <xmmintrin.h>
+#endif
+
+// Constants and scalar reference versions of the exp/log approximations.
+// Only the tier translation units include this; the functions have internal
+// linkage for the reason given in Tables.hpp. The vector versions in each
+// tier follow the scalar ones step for step, so tails agree with bodies.
+
+namespace Logos::linalg::simd {
+namespace {
+
+// exp: x = n ln2 + r with |r| <= ln2 / 2, ln2 split in two for the
+// reduction. Beyond +-EXP_MAX the result saturates.
+constexpr float EXP_MAX = 88.3762626647949f;
+constexpr float LOG2E = 1.44269504088896341f;
+constexpr float LN2_HI = 0.693359375f, LN2_LO = -2.12194440e-4f;
+
+// Cephes expf: e^r = 1 + r + r^2 * P(r), ~1 ulp.
+constexpr float EXP_P0 = 1.9875691500E-4f, EXP_P1 = 1.3981999507E-3f,
+                EXP_P2 = 8.3334519073E-3f, EXP_P3 = 4.1665795894E-2f,
+                EXP_P4 = 1.6666665459E-1f, EXP_P5 = 5.0000001201E-1f;
+
+// Fast exp: x log2(e) = n + f with n = floor, 2^f for f in [0, 1) as a
+// cubic, minimax in relative error (7.5e-5). Below FAST_EXP_MIN n is -127
+// and the result flushes to zero.
+constexpr float FAST_EXP_MIN = -87.5f;
+constexpr float EXP2_C0 = 0.99992530f, EXP2_C1 = 0.69583286f,
+                EXP2_C2 = 0.22606868f, EXP2_C3 = 0.07802358f;
+
+// log: x = m 2^e with m in [sqrt(1/2), sqrt(2)).
+constexpr float SQRT_HALF = 0.707106781186547524f;
+// Cephes logf: log(1 + t) = t - t^2 / 2 + t^3 * P(t), ~1 ulp.
+constexpr float LOG_P0 = 7.0376836292E-2f, LOG_P1 = -1.1514610310E-1f,
+                LOG_P2 = 1.1676998740E-1f, LOG_P3 = -1.2420140846E-1f,
+                LOG_P4 = 1.4249322787E-1f, LOG_P5 = -1.6668057665E-1f,
+                LOG_P6 = 2.0000714765E-1f, LOG_P7 = -2.4999993993E-1f,
+                LOG_P8 = 3.3333331174E-1f;
+// Fast log: log(m) = 2u (C0 + C1 u^2) with u = (m - 1) / (m + 1), minimax in
+// relative error (2.3e-5).
+constexpr float LOG_C0 = 0.99997775f, LOG_C1 = 0.33933989f;
+constexpr float MIN_NORMAL = 1.17549435e-38f;
+
+template <MathMode M> using ModeTag = std::integral_constant<MathMode, M>;
+
+// Calls fn with the mode as a compile-time tag.
+template <class Fn> inline decltype(auto) with_mode(MathMode mode, Fn &&fn) {
+  switch (mode) {
+  case MathMode::Exact:
+    return fn(ModeTag<MathMode::Exact>{});
+  case MathMode::Fast:
+    return fn(ModeTag<MathMode::Fast>{});
+  default:
+    return fn(ModeTag<MathMode::Accurate>{});
+  }
+}
+
+inline float pow2i(int n) {
+  return std::bit_cast<float>(static_cast<std::uint32_t>(n + 127) << 23);
+}
+
+template <MathMode M> inline float exp_scalar(float x) {
+  if constexpr (M == MathMode::Exact) {
+    return std::exp(x);
+  } else if constexpr (M == MathMode::Accurate) {
+    x = std::clamp(x, -EXP_MAX, EXP_MAX);
+    const float fx = std::floor(x * LOG2E + 0.5f);
+    x -= fx * LN2_HI;
+    x -= fx * LN2_LO;
+
+    const float z = x * x;
+    float y = EXP_P0;
+    y = y * x + EXP_P1;
+    y = y * x + EXP_P2;
+    y = y * x + EXP_P3;
+    y = y * x + EXP_P4;
+    y = y * x + EXP_P5;
+    y = y * z + x + 1.0f;
+    return y * pow2i(static_cast<int>(fx));
+  } else {
+    x = std::clamp(x, FAST_EXP_MIN, EXP_MAX);
+    const float t = x * LOG2E;
+    const float n = std::floor(t);
+    const float f = t - n;
+    const float p = ((EXP2_C3 * f + EXP2_C2) * f + EXP2_C1) * f + EXP2_C0;
+    return p * pow2i(static_cast<int>(n));
+  }
+}
+
+// Positive, finite, normal x only in the approximate modes; other inputs
+// follow std::log.
+template <MathMode M> inline float log_scalar(float x) {
+  if constexpr (M == MathMode::Exact) {
+    return std::log(x);
+  } else {
+    if (!(x >= MIN_NORMAL) || std::isinf(x))
+      return std::log(x);
+
+    const std::uint32_t bits = std::bit_cast<std::uint32_t>(x);
+    float e = static_cast<float>(static_cast<int>(bits >> 23) - 126);
+    float m = std::bit_cast<float>((bits & 0x007FFFFFu) | 0x3F000000u);
+    if (m < SQRT_HALF) {
+      m += m;
+      e -= 1.0f;
+    }
+
+    if constexpr (M == MathMode::Accurate) {
+      const float t = m - 1.0f, z = t * t;
+      float y = LOG_P0;
+      y = y * t + LOG_P1;
+      y = y * t + LOG_P2;
+      y = y * t + LOG_P3;
+      y = y * t + LOG_P4;
+      y = y * t + LOG_P5;
+      y = y * t + LOG_P6;
+      y = y * t + LOG_P7;
+      y = y * t + LOG_P8;
+      y = y * t * z;
+      y += e * LN2_LO;
+      y -= 0.5f * z;
+      return (t + y) + e * LN2_HI;
+    } else {
+      const float u = (m - 1.0f) / (m + 1.0f);
+      const float l = 2.0f * u * (LOG_C1 * u * u + LOG_C0);
+      return l + e * (LN2_HI + LN2_LO);
+    }
+  }
+}
+
+// Scalar 16-bit conversions, the reference for the vector ones and their
+// tails. bf16 keeps the top 16 bits of the float, rounded to nearest even
+// on the dropped half; a NaN gets its quiet bit set instead so the
+// rounding cannot carry it into infinity.
+inline std::uint16_t bf16_from_scalar(float x) {
+  const std::uint32_t u = std::bit_cast<std::uint32_t>(x);
+  if ((u & 0x7FFFFFFFu) > 0x7F800000u)
+    return static_cast<std::uint16_t>((u >> 16) | 0x0040u);
+  return static_cast<std::uint16_t>((u + 0x7FFFu + ((u >> 16) & 1u)) >> 16);
+}
+
+inline float bf16_to_scalar(std::uint16_t h) {
+  return std::bit_cast<float>(static_cast<std::uint32_t>(h) << 16);
+}
+
+// IEEE binary16, as F16C's vcvtps2ph rounds: nearest even, overflow to
+// infinity, quiet NaNs with the top of the payload.
+inline std::uint16_t f16_from_scalar(float x) {
+  const std::uint32_t u = std::bit_cast<std::uint32_t>(x);
+  const std::uint32_t sign = (u >> 16) & 0x8000u, a = u & 0x7FFFFFFFu;
+  std::uint32_t h;
+  if (a > 0x7F800000u) // NaN
+    h = 0x7E00u | ((a >> 13) & 0x3FFu);
+  else if (a >= 0x477FF000u) // rounds past 65504
+    h = 0x7C00u;
+  else if (a < 0x38800000u) // below 2^-14: subnormal half
+    // The float addition rounds |x| to a multiple of 2^-24, the half
+    // subnormal step, and leaves the count in the low mantissa bits.
+    h = std::bit_cast<std::uint32_t>(std::bit_cast<float>(a) + 0.5f) -
+        0x3F000000u;
+  else // rebias the exponent by 127 - 15 and round off 13 bits
+    h = (a - 0x38000000u + 0xFFFu + ((a >> 13) & 1u)) >> 13;
+  return static_cast<std::uint16_t>(sign | h);
+}
+
+// Exact, except that signalling NaNs come back quiet, as from vcvtph2ps.
+inline float f16_to_scalar(std::uint16_t h) {
+  const std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000u) << 16,
+                      e = (h >> 10) & 0x1Fu, m = h & 0x3FFu;
+  if (e == 0x1Fu)
+    return std::bit_cast<float>(sign | 0x7F800000u | (m << 13) |
+                                (m ? 0x00400000u : 0u));
+  if (e == 0) {
+    const float v = static_cast<float>(m) * 0x1p-24f;
+    return sign ? -v : v;
+  }
+  return std::bit_cast<float>(sign | ((e + 112u) << 23) | (m << 13));
+}
+
+// round(x) + zero clamped to [lo, hi], ties to even as cvtps2dq rounds.
+// Adding 1.5 * 2^23 leaves no fraction bits, so the sum is already
+// rounded; written that way, loops over it vectorise.
+inline std::uint8_t requantize(float x, std::int32_t zero, std::int32_t lo,
+                               std::int32_t hi) {
+  constexpr float ROUND = 0x1.8p23f;
+  const float t = std::clamp(x, static_cast<float>(lo - zero),
+                             static_cast<float>(hi - zero));
+  return static_cast<std::uint8_t>(
+      static_cast<std::int32_t>((t + ROUND) - ROUND) + zero);
+}
+
+// Every tier's quantize_u8; the loop vectorises under each tier's flags.
+inline void quantize_u8(const float *src, std::uint8_t *dst, std::size_t n,
+                        float inv_scale, std::int32_t zero,
+                        std::int32_t act_max) {
+  for (std::size_t i = 0; i < n; i++)
+    dst[i] = requantize(src[i] * inv_scale, zero, 0, act_max);
+}
+
+// The QGemmEpilogue for `count` columns of output row i, starting at
+// column j, from their int32 dot products. Every tier ends its int8 tiles
+// here, so they round alike.
+inline void qgemm_store(const std::int32_t *acc, std::size_t i, std::size_t j,
+                        std::size_t count, const QGemmEpilogue &ep) {
+  const float *scale = ep.scale + j, *bias = ep.bias + j;
+  if (ep.q) {
+    const std::int32_t lo = ep.relu ? ep.zero : 0;
+    std::uint8_t *q = ep.q + i * ep.ldo + j;
+    for (std::size_t c = 0; c < count; c++) {
+      const float y = static_cast<float>(acc[c]) * scale[c] + bias[c];
+      q[c] = requantize(y * ep.inv_scale, ep.zero, lo, ep.act_max);
+    }
+  } else {
+    float *out = ep.out + i * ep.ldo + j;
+    for (std::size_t c = 0; c < count; c++) {
+      const float y = static_cast<float>(acc[c]) * scale[c] + bias[c];
+      out[c] = ep.relu ? std::max(y, 0.0f) : y;
+    }
+  }
+}
+
+// One int8 tile: rows of A against one packed panel, the int32 dot
+// products written QGEMM_NR to a row. Each tier has one of R rows and one
+// of a single row; qgemm_panels runs them over the whole product.
+using QGemmTileFn = void (*)(const std::uint8_t *A, std::size_t lda,
+                             std::size_t k, const std::int8_t *B,
+                             std::int32_t *out);
+
+template <std::size_t R>
+inline void qgemm_panels(QGemmTileFn tile, QGemmTileFn row,
+                         const std::uint8_t *A, std::size_t lda,
+                         std::size_t rows, std::size_t k, const std::int8_t *B,
+                         std::size_t n, const QGemmEpilogue &ep) {
+  alignas(64) std::int32_t acc[R * QGEMM_NR];
+  for (std::size_t j = 0; j < n; j += QGEMM_NR, B += k * QGEMM_NR) {
+    const std::size_t cols = std::min(QGEMM_NR, n - j);
+    std::size_t i = 0;
+    for (; i + R <= rows; i += R) {
+      tile(A + i * lda, lda, k, B, acc);
+      for (std::size_t r = 0; r < R; r++)
+        qgemm_store(acc + r * QGEMM_NR, i + r, j, cols, ep);
+    }
+    for (; i < rows; i++) {
+      row(A + i * lda, lda, k, B, acc);
+      qgemm_store(acc, i, j, cols, ep);
+    }
+  }
+}
+
+// Denormal inputs and results flushed to zero on the calling thread while
+// in scope; the previous MXCSR is restored on exit. The Adam update needs
+// it: its second moment decays geometrically and squared small gradients
+// underflow, and on x86 every denormal operand takes a microcode assist.
+// A no-op where floats do not go through SSE.
+class FlushDenormals {
+public:
+#if defined(__SSE2__)
+  FlushDenormals() : m_Csr(_mm_getcsr()) { _mm_setcsr(m_Csr | FTZ_DAZ); }
+  ~FlushDenormals() { _mm_setcsr(m_Csr); }
+
+private:
+  static constexpr unsigned FTZ_DAZ = 0x8040;
+  unsigned m_Csr;
+#endif
+};
+
+} // namespace
+} // namespace Logos::linalg::simd
@@ -0,0 +1,591 @@
+#include "Kernels/Simd/MathCommon.hpp"
+#include "Kernels/Simd/Tables.hpp"
+
+#if LOGOS_SIMD_X86
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <immintrin.h>
+
+namespace Logos::linalg::simd {
+namespace {
+
+constexpr std::size_t MR = 6, NR = 8;
+
+inline float hsum(__m128 v) {
+  v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+  return _mm_cvtss_f32(v);
+}
+
+inline float hmax(__m128 v) {
+  v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+  return _mm_cvtss_f32(v);
+}
+
+// Cephes-style expf, ~1 ulp over the clamped range.
+inline __m128 exp_ps(__m128 x) {
+  x = _mm_min_ps(x, _mm_set1_ps(EXP_MAX));
+  x = _mm_max_ps(x, _mm_set1_ps(-EXP_MAX));
+
+  __m128 fx =
+      _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(LOG2E)), _mm_set1_ps(0.5f));
+  fx = _mm_floor_ps(fx);
+
+  x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(LN2_HI)));
+  x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(LN2_LO)));
+
+  const __m128 z = _mm_mul_ps(x, x);
+  __m128 y = _mm_set1_ps(EXP_P0);
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(EXP_P1));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(EXP_P2));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(EXP_P3));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(EXP_P4));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(EXP_P5));
+  y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(y, z), x), _mm_set1_ps(1.0f));
+
+  __m128i e = _mm_cvttps_epi32(fx);
+  e = _mm_slli_epi32(_mm_add_epi32(e, _mm_set1_epi32(127)), 23);
+  return _mm_mul_ps(y, _mm_castsi128_ps(e));
+}
+
+// 2^n * p(f) with the cubic from MathCommon.hpp, ~1e-4 relative.
+inline __m128 fast_exp_ps(__m128 x) {
+  x = _mm_min_ps(x, _mm_set1_ps(EXP_MAX));
+  x = _mm_max_ps(x, _mm_set1_ps(FAST_EXP_MIN));
+
+  const __m128 t = _mm_mul_ps(x, _mm_set1_ps(LOG2E));
+  const __m128 n = _mm_floor_ps(t);
+  const __m128 f = _mm_sub_ps(t, n);
+
+  __m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(EXP2_C3), f),
+                        _mm_set1_ps(EXP2_C2));
+  p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C1));
+  p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C0));
+
+  __m128i e = _mm_cvttps_epi32(n);
+  e = _mm_slli_epi32(_mm_add_epi32(e, _mm_set1_epi32(127)), 23);
+  return _mm_mul_ps(p, _mm_castsi128_ps(e));
+}
+
+// Accurate or fast log of positive normal lanes; anything else is redone
+// with std::log.
+template <MathMode M> inline __m128 log_ps(__m128 x) {
+  const __m128i bits = _mm_castps_si128(x);
+  __m128 e = _mm_cvtepi32_ps(
+      _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126)));
+  __m128 m = _mm_castsi128_ps(
+      _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)),
+                   _mm_set1_epi32(0x3F000000)));
+  const __m128 lo = _mm_cmplt_ps(m, _mm_set1_ps(SQRT_HALF));
+  m = _mm_add_ps(m, _mm_and_ps(m, lo));
+  e = _mm_sub_ps(e, _mm_and_ps(_mm_set1_ps(1.0f), lo));
+
+  __m128 r;
+  if constexpr (M == MathMode::Accurate) {
+    const __m128 t = _mm_sub_ps(m, _mm_set1_ps(1.0f));
+    const __m128 z = _mm_mul_ps(t, t);
+    __m128 y = _mm_set1_ps(LOG_P0);
+    y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_P1));
+    y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_P2));
+    y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_P3));
+    y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_P4));
+    y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_P5));
+    y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_P6));
+    y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_P7));
+    y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_P8));
+    y = _mm_mul_ps(_mm_mul_ps(y, t), z);
+    y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(LN2_LO)));
+    y = _mm_sub_ps(y, _mm_mul_ps(_mm_set1_ps(0.5f), z));
+    r = _mm_add_ps(_mm_add_ps(t, y), _mm_mul_ps(e, _mm_set1_ps(LN2_HI)));
+  } else {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 u = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+    const __m128 u2 = _mm_mul_ps(u, u);
+    const __m128 l = _mm_mul_ps(
+        _mm_add_ps(u, u), _mm_add_ps(_mm_mul_ps(_mm_set1_ps(LOG_C1), u2),
+                                     _mm_set1_ps(LOG_C0)));
+    r = _mm_add_ps(l, _mm_mul_ps(e, _mm_set1_ps(LN2_HI + LN2_LO)));
+  }
+
+  const __m128 normal =
+      _mm_and_ps(_mm_cmpge_ps(x, _mm_set1_ps(MIN_NORMAL)),
+                 _mm_cmplt_ps(x, _mm_set1_ps(INFINITY)));
+  if (_mm_movemask_ps(normal) != 0xF) {
+    alignas(16) float xs[4], rs[4];
+    _mm_store_ps(xs, x);
+    _mm_store_ps(rs, r);
+    const int keep = _mm_movemask_ps(normal);
+    for (int i = 0; i < 4; i++)
+      if (!(keep & (1 << i)))
+        rs[i] = std::log(xs[i]);
+    r = _mm_load_ps(rs);
+  }
+  return r;
+}
+
+template <MathMode M> inline __m128 vexp(__m128 x) {
+  if constexpr (M == MathMode::Exact) {
+    alignas(16) float v[4];
+    _mm_store_ps(v, x);
+    for (float &e : v)
+      e = std::exp(e);
+    return _mm_load_ps(v);
+  } else if constexpr (M == MathMode::Accurate) {
+    return exp_ps(x);
+  } else {
+    return fast_exp_ps(x);
+  }
+}
+
+template <MathMode M> inline __m128 vlog(__m128 x) {
+  if constexpr (M == MathMode::Exact) {
+    alignas(16) float v[4];
+    _mm_store_ps(v, x);
+    for (float &e : v)
+      e = std::log(e);
+    return _mm_load_ps(v);
+  } else {
+    return log_ps<M>(x);
+  }
+}
+
+void gemm_micro(std::size_t kc, const float *a, const float *b, float *C,
+                std::size_t ldc, float alpha, float beta,
+                const GemmEpilogue<float> *ep) {
+  __m128 c[MR][2];
+  for (std::size_t r = 0; r < MR; r++)
+    c[r][0] = c[r][1] = _mm_setzero_ps();
+
+  for (std::size_t p = 0; p < kc; p++) {
+    const __m128 b0 = _mm_load_ps(b), b1 = _mm_load_ps(b + 4);
+    for (std::size_t r = 0; r < MR; r++) {
+      const __m128 av = _mm_set1_ps(a[r]);
+      c[r][0] = _mm_add_ps(c[r][0], _mm_mul_ps(av, b0));
+      c[r][1] = _mm_add_ps(c[r][1], _mm_mul_ps(av, b1));
+    }
+    a += MR;
+    b += NR;
+  }
+
+  const __m128 va = _mm_set1_ps(alpha), vb = _mm_set1_ps(beta);
+  const __m128 zero = _mm_setzero_ps();
+  const bool bias = ep && ep->bias, relu = ep && ep->relu;
+  const __m128 b0 = bias ? _mm_loadu_ps(ep->bias) : zero,
+               b1 = bias ? _mm_loadu_ps(ep->bias + 4) : zero;
+  for (std::size_t r = 0; r < MR; r++) {
+    float *row = C + r * ldc;
+    __m128 r0 = _mm_mul_ps(va, c[r][0]), r1 = _mm_mul_ps(va, c[r][1]);
+    if (beta != 0.0f) {
+      r0 = _mm_add_ps(r0, _mm_mul_ps(vb, _mm_loadu_ps(row)));
+      r1 = _mm_add_ps(r1, _mm_mul_ps(vb, _mm_loadu_ps(row + 4)));
+    }
+    if (bias) {
+      r0 = _mm_add_ps(r0, b0);
+      r1 = _mm_add_ps(r1, b1);
+    }
+    if (relu) {
+      const __m128 k0 = _mm_cmpgt_ps(r0, zero), k1 = _mm_cmpgt_ps(r1, zero);
+      r0 = _mm_and_ps(r0, k0);
+      r1 = _mm_and_ps(r1, k1);
+      if (ep->mask)
+        ep->mask[r * ep->ldm] = static_cast<std::uint8_t>(
+            _mm_movemask_ps(k0) | (_mm_movemask_ps(k1) << 4));
+    }
+    _mm_storeu_ps(row, r0);
+    _mm_storeu_ps(row + 4, r1);
+  }
+}
+
+void add_bias(const float *b, float *X, std::size_t rows, std::size_t cols,
+              std::size_t ld) {
+  for (std::size_t i = 0; i < rows; i++) {
+    float *row = X + i * ld;
+    std::size_t j = 0;
+    for (; j + 4 <= cols; j += 4)
+      _mm_storeu_ps(row + j,
+                    _mm_add_ps(_mm_loadu_ps(row + j), _mm_loadu_ps(b + j)));
+    for (; j < cols; j++)
+      row[j] += b[j];
+  }
+}
+
+void sum_rows(const float *X, std::size_t rows, std::size_t cols,
+              std::size_t ld, float *out) {
+  std::memset(out, 0, cols * sizeof(float));
+  for (std::size_t i = 0; i < rows; i++) {
+    const float *row = X + i * ld;
+    std::size_t j = 0;
+    for (; j + 4 <= cols; j += 4)
+      _mm_storeu_ps(out + j,
+                    _mm_add_ps(_mm_loadu_ps(out + j), _mm_loadu_ps(row + j)));
+    for (; j < cols; j++)
+      out[j] += row[j];
+  }
+}
+
+void relu_forward(const float *X, float *H, std::uint8_t *mask,
+                  std::size_t n) {
+  const __m128 zero = _mm_setzero_ps();
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    unsigned bits = 0;
+    for (std::size_t k = 0; k < 4; k++) {
+      const __m128 x = _mm_loadu_ps(X + i + 4 * k);
+      const __m128 keep = _mm_cmpgt_ps(x, zero);
+      _mm_storeu_ps(H + i + 4 * k, _mm_and_ps(x, keep));
+      bits |= unsigned(_mm_movemask_ps(keep)) << (4 * k);
+    }
+    const auto packed = static_cast<std::uint16_t>(bits);
+    std::memcpy(mask + i / 8, &packed, sizeof(packed));
+  }
+  for (std::size_t b = i; b < n; b += 8) {
+    unsigned bits = 0;
+    for (std::size_t k = 0; k < 8 && b + k < n; k++) {
+      const bool fl = X[b + k] > 0.0f;
+      bits |= unsigned(fl) << k;
+      H[b + k] = fl ? X[b + k] : 0.0f;
+    }
+    mask[b / 8] = static_cast<std::uint8_t>(bits);
+  }
+}
+
+void relu_backward(const float *dH, const std::uint8_t *mask, float *dX,
+                   std::size_t n) {
+  // lane k keeps its value when bit k of the mask nibble is set
+  const __m128i lane_bit = _mm_setr_epi32(1, 2, 4, 8);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m128i bits = _mm_set1_epi32(mask[i / 8] >> (i % 8));
+    const __m128i sel = _mm_and_si128(bits, lane_bit);
+    const __m128 keep = _mm_castsi128_ps(_mm_cmpeq_epi32(sel, lane_bit));
+    _mm_storeu_ps(dX + i, _mm_and_ps(_mm_loadu_ps(dH + i), keep));
+  }
+  for (; i < n; i++)
+    dX[i] = ((mask[i / 8] >> (i % 8)) & 1u) ? dH[i] : 0.0f;
+}
+
+template <MathMode M>
+void exp_impl(const float *x, float *y, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(y + i, vexp<M>(_mm_loadu_ps(x + i)));
+  for (; i < n; i++)
+    y[i] = exp_scalar<M>(x[i]);
+}
+
+template <MathMode M>
+void log_impl(const float *x, float *y, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(y + i, vlog<M>(_mm_loadu_ps(x + i)));
+  for (; i < n; i++)
+    y[i] = log_scalar<M>(x[i]);
+}
+
+// exp(x - max) into out, returning the row max and the sum.
+template <MathMode M>
+void exp_shifted(const float *x, float *out, std::size_t n, float &maxv,
+                 float &sum) {
+  std::size_t j = 0;
+  __m128 vmax = _mm_set1_ps(std::numeric_limits<float>::lowest());
+  for (; j + 4 <= n; j += 4)
+    vmax = _mm_max_ps(vmax, _mm_loadu_ps(x + j));
+  maxv = hmax(vmax);
+  for (; j < n; j++)
+    maxv = (x[j] > maxv) ? x[j] : maxv;
+
+  const __m128 m = _mm_set1_ps(maxv);
+  __m128 vsum = _mm_setzero_ps();
+  for (j = 0; j + 4 <= n; j += 4) {
+    const __m128 e = vexp<M>(_mm_sub_ps(_mm_loadu_ps(x + j), m));
+    _mm_storeu_ps(out + j, e);
+    vsum = _mm_add_ps(vsum, e);
+  }
+  sum = hsum(vsum);
+  for (; j < n; j++) {
+    out[j] = exp_scalar<M>(x[j] - maxv);
+    sum += out[j];
+  }
+}
+
+void scale_row(float *p, std::size_t n, float s) {
+  const __m128 vs = _mm_set1_ps(s);
+  std::size_t j = 0;
+  for (; j + 4 <= n; j += 4)
+    _mm_storeu_ps(p + j, _mm_mul_ps(_mm_loadu_ps(p + j), vs));
+  for (; j < n; j++)
+    p[j] *= s;
+}
+
+template <MathMode M>
+void softmax_row_impl(const float *x, float *p, std::size_t n) {
+  float maxv, sum;
+  exp_shifted<M>(x, p, n, maxv, sum);
+  scale_row(p, n, 1.0f / sum);
+}
+
+template <MathMode M>
+float softmax_xent_row_impl(const float *x, float *g, std::size_t n,
+                            std::size_t label, float scale) {
+  float maxv, sum;
+  exp_shifted<M>(x, g, n, maxv, sum);
+  scale_row(g, n, scale / sum);
+  g[label] -= scale;
+  return (maxv - x[label]) + log_scalar<M>(sum);
+}
+
+void exp(const float *x, float *y, std::size_t n, MathMode mode) {
+  with_mode(mode, [&](auto m) { exp_impl<decltype(m)::value>(x, y, n); });
+}
+
+void log(const float *x, float *y, std::size_t n, MathMode mode) {
+  with_mode(mode, [&](auto m) { log_impl<decltype(m)::value>(x, y, n); });
+}
+
+void softmax_row(const float *x, float *p, std::size_t n, MathMode mode) {
+  with_mode(mode,
+            [&](auto m) { softmax_row_impl<decltype(m)::value>(x, p, n); });
+}
+
+float softmax_xent_row(const float *x, float *g, std::size_t n,
+                       std::size_t label, float scale, MathMode mode) {
+  return with_mode(mode, [&](auto m) {
+    return softmax_xent_row_impl<decltype(m)::value>(x, g, n, label, scale);
+  });
+}
+
+void axpy(float alpha, const float *x, float *y, std::size_t n) {
+  const __m128 va = _mm_set1_ps(alpha);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i),
+                                    _mm_mul_ps(va, _mm_loadu_ps(x + i))));
+  for (; i < n; i++)
+    y[i] += alpha * x[i];
+}
+
+// Plain SGD, or heavy-ball / Nesterov momentum with a velocity buffer.
+template <bool Momentum, bool Nesterov>
+void sgd_step_impl(float *w, float *g, float *v, std::size_t n,
+                   const SgdStep &s) {
+  const __m128 lr = _mm_set1_ps(s.lr), wd = _mm_set1_ps(s.weight_decay),
+               mu = _mm_set1_ps(s.momentum), zero = _mm_setzero_ps();
+  auto update = [&](__m128 vw, __m128 vg, __m128 &vv) {
+    const __m128 d = _mm_add_ps(_mm_mul_ps(wd, vw), vg);
+    __m128 u = d;
+    if constexpr (Momentum) {
+      vv = _mm_add_ps(_mm_mul_ps(mu, vv), d);
+      u = Nesterov ? _mm_add_ps(_mm_mul_ps(mu, vv), d) : vv;
+    }
+    return _mm_sub_ps(vw, _mm_mul_ps(lr, u));
+  };
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 vv = Momentum ? _mm_loadu_ps(v + i) : zero;
+    const __m128 vw = _mm_loadu_ps(w + i), vg = _mm_loadu_ps(g + i);
+    _mm_storeu_ps(w + i, update(vw, vg, vv));
+    if constexpr (Momentum)
+      _mm_storeu_ps(v + i, vv);
+    _mm_storeu_ps(g + i, zero);
+  }
+  for (; i < n; i++) {
+    const float d = g[i] + s.weight_decay * w[i];
+    float u = d;
+    if constexpr (Momentum) {
+      v[i] = s.momentum * v[i] + d;
+      u = Nesterov ? d + s.momentum * v[i] : v[i];
+    }
+    w[i] -= s.lr * u;
+    g[i] = 0.0f;
+  }
+}
+
+void sgd_step(float *w, float *g, float *v, std::size_t n, const SgdStep &s) {
+  if (!v)
+    sgd_step_impl<false, false>(w, g, v, n, s);
+  else if (s.nesterov)
+    sgd_step_impl<true, true>(w, g, v, n, s);
+  else
+    sgd_step_impl<true, false>(w, g, v, n, s);
+}
+
+void adam_step(float *w, float *g, float *m, float *v, std::size_t n,
+               const AdamStep &s) {
+  const FlushDenormals flush;
+  const __m128 l2 = _mm_set1_ps(s.l2), eps = _mm_set1_ps(s.eps);
+  const __m128 b1 = _mm_set1_ps(s.beta1), b2 = _mm_set1_ps(s.beta2);
+  const __m128 c1 = _mm_set1_ps(1.0f - s.beta1),
+               c2 = _mm_set1_ps(1.0f - s.beta2);
+  const __m128 shrink = _mm_set1_ps(s.shrink), step = _mm_set1_ps(s.step);
+  const __m128 rb2 = _mm_set1_ps(s.rsqrt_bias2), zero = _mm_setzero_ps();
+  auto update = [&](__m128 vw, __m128 vg, __m128 &vm, __m128 &vv) {
+    const __m128 d = _mm_add_ps(_mm_mul_ps(l2, vw), vg);
+    vm = _mm_add_ps(_mm_mul_ps(b1, vm), _mm_mul_ps(c1, d));
+    vv = _mm_add_ps(_mm_mul_ps(b2, vv), _mm_mul_ps(c2, _mm_mul_ps(d, d)));
+    const __m128 denom = _mm_add_ps(_mm_mul_ps(_mm_sqrt_ps(vv), rb2), eps);
+    return _mm_sub_ps(_mm_mul_ps(shrink, vw),
+                      _mm_mul_ps(step, _mm_div_ps(vm, denom)));
+  };
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 vm = _mm_loadu_ps(m + i), vv = _mm_loadu_ps(v + i);
+    const __m128 vw = _mm_loadu_ps(w + i), vg = _mm_loadu_ps(g + i);
+    _mm_storeu_ps(w + i, update(vw, vg, vm, vv));
+    _mm_storeu_ps(m + i, vm);
+    _mm_storeu_ps(v + i, vv);
+    _mm_storeu_ps(g + i, zero);
+  }
+  const float sc1 = 1.0f - s.beta1, sc2 = 1.0f - s.beta2;
+  for (; i < n; i++) {
+    const float d = g[i] + s.l2 * w[i];
+    m[i] = s.beta1 * m[i] + sc1 * d;
+    v[i] = s.beta2 * v[i] + sc2 * (d * d);
+    const float denom = std::sqrt(v[i]) * s.rsqrt_bias2 + s.eps;
+    w[i] = s.shrink * w[i] - s.step * (m[i] / denom);
+    g[i] = 0.0f;
+  }
+}
+
+void u8_to_f32(const std::uint8_t *src, float *dst, std::size_t n,
+               float scale, float shift) {
+  const __m128 vs = _mm_set1_ps(scale), vb = _mm_set1_ps(shift);
+  auto convert = [&](__m128i bytes) {
+    return _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(bytes)), vs),
+                      vb);
+  };
+
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm_storeu_ps(dst + i, convert(b));
+    _mm_storeu_ps(dst + i + 4, convert(_mm_srli_si128(b, 4)));
+    _mm_storeu_ps(dst + i + 8, convert(_mm_srli_si128(b, 8)));
+    _mm_storeu_ps(dst + i + 12, convert(_mm_srli_si128(b, 12)));
+  }
+  for (; i < n; i++)
+    dst[i] = static_cast<float>(src[i]) * scale + shift;
+}
+
+// Four floats to bf16 in the low 32 bits of each lane, as bf16_from_scalar.
+inline __m128i bf16_round(__m128 x) {
+  const __m128i u = _mm_castps_si128(x);
+  const __m128i lsb = _mm_and_si128(_mm_srli_epi32(u, 16), _mm_set1_epi32(1));
+  const __m128i r = _mm_srli_epi32(
+      _mm_add_epi32(_mm_add_epi32(u, _mm_set1_epi32(0x7FFF)), lsb), 16);
+  const __m128i nan =
+      _mm_cmpgt_epi32(_mm_and_si128(u, _mm_set1_epi32(0x7FFFFFFF)),
+                      _mm_set1_epi32(0x7F800000));
+  const __m128i quiet =
+      _mm_or_si128(_mm_srli_epi32(u, 16), _mm_set1_epi32(0x0040));
+  return _mm_blendv_epi8(r, quiet, nan);
+}
+
+void f32_to_bf16(const float *src, std::uint16_t *dst, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i h = _mm_packus_epi32(bf16_round(_mm_loadu_ps(src + i)),
+                                       bf16_round(_mm_loadu_ps(src + i + 4)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), h);
+  }
+  for (; i < n; i++)
+    dst[i] = bf16_from_scalar(src[i]);
+}
+
+void bf16_to_f32(const std::uint16_t *src, float *dst, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i h =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm_storeu_ps(dst + i, _mm_castsi128_ps(_mm_slli_epi32(
+                               _mm_cvtepu16_epi32(h), 16)));
+    _mm_storeu_ps(dst + i + 4, _mm_castsi128_ps(_mm_slli_epi32(
+                                   _mm_cvtepu16_epi32(_mm_srli_si128(h, 8)),
+                                   16)));
+  }
+  for (; i < n; i++)
+    dst[i] = bf16_to_scalar(src[i]);
+}
+
+// No F16C below AVX2: binary16 goes through the scalar conversion.
+void f32_to_f16(const float *src, std::uint16_t *dst, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++)
+    dst[i] = f16_from_scalar(src[i]);
+}
+
+void f16_to_f32(const std::uint16_t *src, float *dst, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++)
+    dst[i] = f16_to_scalar(src[i]);
+}
+
+// One row against one panel, eight int32 vectors. pmaddubsw multiplies
+// the uint8 activations with the int8 weights and adds adjacent pairs into
+// int16, pmaddwd by ones adds those pairs into int32.
+void qgemm_row(const std::uint8_t *A, std::size_t, std::size_t k,
+               const std::int8_t *B, std::int32_t *out) {
+  constexpr std::size_t V = QGEMM_NR / 4;
+  const __m128i ones = _mm_set1_epi16(1);
+  __m128i acc[V];
+  for (std::size_t v = 0; v < V; v++)
+    acc[v] = _mm_setzero_si128();
+  for (std::size_t g = 0; g < k; g += QGEMM_KU, B += QGEMM_KU * QGEMM_NR) {
+    std::int32_t quad;
+    std::memcpy(&quad, A + g, sizeof(quad));
+    const __m128i a = _mm_set1_epi32(quad);
+    for (std::size_t v = 0; v < V; v++) {
+      const __m128i b =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(B) + v);
+      acc[v] = _mm_add_epi32(acc[v],
+                             _mm_madd_epi16(_mm_maddubs_epi16(a, b), ones));
+    }
+  }
+  for (std::size_t v = 0; v < V; v++)
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out) + v, acc[v]);
+}
+
+void qgemm(const std::uint8_t *A, std::size_t lda, std::size_t rows,
+           std::size_t k, const std::int8_t *B, std::size_t n,
+           const QGemmEpilogue &ep) {
+  qgemm_panels<1>(&qgemm_row, &qgemm_row, A, lda, rows, k, B, n, ep);
+}
+
+std::int32_t qgemm_act_max() { return QGEMM_ACT_MAX_MADD; }
+
+const KernelTable s_Table = {
+    Tier::SSE42,
+    "sse4.2",
+    MR,
+    NR,
+    &gemm_micro,
+    &add_bias,
+    &sum_rows,
+    &relu_forward,
+    &relu_backward,
+    &exp,
+    &log,
+    &softmax_row,
+    &softmax_xent_row,
+    &axpy,
+    &sgd_step,
+    &adam_step,
+    &u8_to_f32,
+    &f32_to_bf16,
+    &bf16_to_f32,
+    &f32_to_f16,
+    &f16_to_f32,
+    &quantize_u8,
+    &qgemm,
+    &qgemm_act_max,
+};
+} // namespace
+
+const KernelTable &SSE42Table() { return s_Table; }
+} // namespace Logos::linalg::simd
+
+#endif
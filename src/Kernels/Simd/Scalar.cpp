@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#include "Kernels/Gemm.hpp"
+#include "Kernels/Simd/MathCommon.hpp"
+#include "Kernels/Simd/Tables.hpp"
+
+namespace Logos::linalg::simd {
+namespace {
+
+void add_bias(const float *b, float *X, std::size_t rows, std::size_t cols,
+              std::size_t ld) {
+  for (std::size_t i = 0; i < rows; i++)
+    for (std::size_t j = 0; j < cols; j++)
+      X[i * ld + j] += b[j];
+}
+
+void sum_rows(const float *X, std::size_t rows, std::size_t cols,
+              std::size_t ld, float *out) {
+  std::fill(out, out + cols, 0.0f);
+  for (std::size_t i = 0; i < rows; i++)
+    for (std::size_t j = 0; j < cols; j++)
+      out[j] += X[i * ld + j];
+}
+
+// Separate value and bit loops over m <= 8 elements; the value loop then
+// vectorises with the baseline instruction set.
+inline std::uint8_t relu_byte(const float *__restrict X, float *__restrict H,
+                              std::size_t m) {
+  unsigned bits = 0;
+  for (std::size_t k = 0; k < m; k++)
+    H[k] = X[k] > 0.0f ? X[k] : 0.0f;
+  for (std::size_t k = 0; k < m; k++)
+    bits |= unsigned(X[k] > 0.0f) << k;
+  return static_cast<std::uint8_t>(bits);
+}
+
+void relu_forward(const float *X, float *H, std::uint8_t *mask,
+                  std::size_t n) {
+  std::size_t i = 0;
+  // fixed trip count, so the compiler unrolls the byte
+  for (; i + 8 <= n; i += 8)
+    mask[i / 8] = relu_byte(X + i, H + i, 8);
+  if (i < n)
+    mask[i / 8] = relu_byte(X + i, H + i, n - i);
+}
+
+void relu_backward(const float *__restrict dH,
+                   const std::uint8_t *__restrict mask, float *__restrict dX,
+                   std::size_t n) {
+  std::size_t i = 0;
+  // each bit widened to an all-ones/zero word and ANDed in, branch free
+  for (; i + 8 <= n; i += 8) {
+    const std::uint32_t bits = mask[i / 8];
+    for (std::size_t k = 0; k < 8; k++) {
+      const std::uint32_t keep = 0u - ((bits >> k) & 1u);
+      dX[i + k] =
+          std::bit_cast<float>(std::bit_cast<std::uint32_t>(dH[i + k]) & keep);
+    }
+  }
+  for (; i < n; i++)
+    dX[i] = ((mask[i / 8] >> (i % 8)) & 1u) ? dH[i] : 0.0f;
+}
+
+template <MathMode M>
+void exp_impl(const float *x, float *y, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++)
+    y[i] = exp_scalar<M>(x[i]);
+}
+
+template <MathMode M>
+void log_impl(const float *x, float *y, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++)
+    y[i] = log_scalar<M>(x[i]);
+}
+
+// exp(x - max) into out, returning the row max and the sum.
+template <MathMode M>
+void exp_shifted(const float *x, float *out, std::size_t n, float &maxv,
+                 float &sum) {
+  maxv = std::numeric_limits<float>::lowest();
+  for (std::size_t j = 0; j < n; j++)
+    maxv = std::max(maxv, x[j]);
+
+  sum = 0.0f;
+  for (std::size_t j = 0; j < n; j++) {
+    out[j] = exp_scalar<M>(x[j] - maxv);
+    sum += out[j];
+  }
+}
+
+template <MathMode M>
+void softmax_row_impl(const float *x, float *p, std::size_t n) {
+  float maxv, sum;
+  exp_shifted<M>(x, p, n, maxv, sum);
+
+  const float inv = 1.0f / sum;
+  for (std::size_t j = 0; j < n; j++)
+    p[j] *= inv;
+}
+
+template <MathMode M>
+float softmax_xent_row_impl(const float *x, float *g, std::size_t n,
+                            std::size_t label, float scale) {
+  float maxv, sum;
+  exp_shifted<M>(x, g, n, maxv, sum);
+
+  const float inv = scale / sum;
+  for (std::size_t j = 0; j < n; j++)
+    g[j] *= inv;
+  g[label] -= scale;
+  return (maxv - x[label]) + log_scalar<M>(sum);
+}
+
+// One element at a time the Cephes polynomials lose to libm, which is at
+// least as accurate, so Accurate takes the Exact path on this tier.
+MathMode scalar_mode(MathMode mode) {
+  return mode == MathMode::Accurate ? MathMode::Exact : mode;
+}
+
+void exp(const float *x, float *y, std::size_t n, MathMode mode) {
+  with_mode(scalar_mode(mode),
+            [&](auto m) { exp_impl<decltype(m)::value>(x, y, n); });
+}
+
+void log(const float *x, float *y, std::size_t n, MathMode mode) {
+  with_mode(scalar_mode(mode),
+            [&](auto m) { log_impl<decltype(m)::value>(x, y, n); });
+}
+
+void softmax_row(const float *x, float *p, std::size_t n, MathMode mode) {
+  with_mode(scalar_mode(mode),
+            [&](auto m) { softmax_row_impl<decltype(m)::value>(x, p, n); });
+}
+
+float softmax_xent_row(const float *x, float *g, std::size_t n,
+                       std::size_t label, float scale, MathMode mode) {
+  return with_mode(scalar_mode(mode), [&](auto m) {
+    return softmax_xent_row_impl<decltype(m)::value>(x, g, n, label, scale);
+  });
+}
+
+void axpy(float alpha, const float *x, float *y, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++)
+    y[i] += alpha * x[i];
+}
+
+// Plain SGD, or heavy-ball / Nesterov momentum with a velocity buffer.
+template <bool Momentum, bool Nesterov>
+void sgd_step_impl(float *__restrict w, float *__restrict g,
+                   float *__restrict v, std::size_t n, const SgdStep &s) {
+  for (std::size_t i = 0; i < n; i++) {
+    const float d = g[i] + s.weight_decay * w[i];
+    float u = d;
+    if constexpr (Momentum) {
+      v[i] = s.momentum * v[i] + d;
+      u = Nesterov ? d + s.momentum * v[i] : v[i];
+    }
+    w[i] -= s.lr * u;
+    g[i] = 0.0f;
+  }
+}
+
+void sgd_step(float *w, float *g, float *v, std::size_t n, const SgdStep &s) {
+  if (!v)
+    sgd_step_impl<false, false>(w, g, v, n, s);
+  else if (s.nesterov)
+    sgd_step_impl<true, true>(w, g, v, n, s);
+  else
+    sgd_step_impl<true, false>(w, g, v, n, s);
+}
+
+void adam_step(float *__restrict w, float *__restrict g, float *__restrict m,
+               float *__restrict v, std::size_t n, const AdamStep &s) {
+  const FlushDenormals flush;
+  const float c1 = 1.0f - s.beta1, c2 = 1.0f - s.beta2;
+  for (std::size_t i = 0; i < n; i++) {
+    const float d = g[i] + s.l2 * w[i];
+    m[i] = s.beta1 * m[i] + c1 * d;
+    v[i] = s.beta2 * v[i] + c2 * (d * d);
+    const float denom = std::sqrt(v[i]) * s.rsqrt_bias2 + s.eps;
+    w[i] = s.shrink * w[i] - s.step * (m[i] / denom);
+    g[i] = 0.0f;
+  }
+}
+
+void u8_to_f32(const std::uint8_t *src, float *dst, std::size_t n,
+               float scale, float shift) {
+  for (std::size_t i = 0; i < n; i++)
+    dst[i] = static_cast<float>(src[i]) * scale + shift;
+}
+
+void f32_to_bf16(const float *src, std::uint16_t *dst, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++)
+    dst[i] = bf16_from_scalar(src[i]);
+}
+
+void bf16_to_f32(const std::uint16_t *src, float *dst, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++)
+    dst[i] = bf16_to_scalar(src[i]);
+}
+
+void f32_to_f16(const float *src, std::uint16_t *dst, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++)
+    dst[i] = f16_from_scalar(src[i]);
+}
+
+void f16_to_f32(const std::uint16_t *src, float *dst, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++)
+    dst[i] = f16_to_scalar(src[i]);
+}
+
+void qgemm_row(const std::uint8_t *A, std::size_t, std::size_t k,
+               const std::int8_t *B, std::int32_t *out) {
+  std::fill(out, out + QGEMM_NR, 0);
+  for (std::size_t g = 0; g < k; g += QGEMM_KU, B += QGEMM_KU * QGEMM_NR)
+    for (std::size_t c = 0; c < QGEMM_NR; c++)
+      for (std::size_t r = 0; r < QGEMM_KU; r++)
+        out[c] += A[g + r] * B[c * QGEMM_KU + r];
+}
+
+void qgemm(const std::uint8_t *A, std::size_t lda, std::size_t rows,
+           std::size_t k, const std::int8_t *B, std::size_t n,
+           const QGemmEpilogue &ep) {
+  qgemm_panels<1>(&qgemm_row, &qgemm_row, A, lda, rows, k, B, n, ep);
+}
+
+std::int32_t qgemm_act_max() { return QGEMM_ACT_MAX; }
+
+const KernelTable s_Table = {
+    Tier::Scalar,
+    "scalar",
+    gemm_detail::MR,
+    gemm_detail::NR,
+    &gemm_detail::micro_kernel<float>,
+    &add_bias,
+    &sum_rows,
+    &relu_forward,
+    &relu_backward,
+    &exp,
+    &log,
+    &softmax_row,
+    &softmax_xent_row,
+    &axpy,
+    &sgd_step,
+    &adam_step,
+    &u8_to_f32,
+    &f32_to_bf16,
+    &bf16_to_f32,
+    &f32_to_f16,
+    &f16_to_f32,
+    &quantize_u8,
+    &qgemm,
+    &qgemm_act_max,
+};
+} // namespace
+
+const KernelTable &ScalarTable() { return s_Table; }
+} // namespace Logos::linalg::simd
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Kernels/Simd.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define LOGOS_SIMD_X86 1
+#else
+#define LOGOS_SIMD_X86 0
+#endif
+
+namespace Logos::linalg::simd {
+
+// One table per tier. Each lives in its own translation unit compiled with
+// that tier's target flags (see CMakeLists.txt), so nothing in those files
+// may be reached without checking the CPU first. Keep their helpers in
+// anonymous namespaces: an inline function shared with baseline code could
+// otherwise be merged with an AVX-512 copy by the linker.
+const KernelTable &ScalarTable();
+
+#if LOGOS_SIMD_X86
+const KernelTable &SSE42Table();
+const KernelTable &AVX2Table();
+const KernelTable &AVX512Table();
+#endif
+} // namespace Logos::linalg::simd
@@ -1,6 +1,12 @@
 #pragma once
 
+#include "Half.hpp"
 #include "Matrix.hpp"
+#include "MatrixView.hpp"
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
 
 namespace Logos::NeuralNet {
 template <class T> class ILayer {
@@ -8,12 +14,50 @@ public:
   ILayer() = default;
   virtual ~ILayer() = default;
 
-  virtual void Forward(const linalg::Matrix<T> &in, linalg::Matrix<T> &out) = 0;
-  virtual void Backward(const linalg::Matrix<T> &in,
+  // Inputs are views, so a layer can run on a row range or any other
+  // strided window without a copy. Outputs are resized to fit.
+  virtual void Forward(linalg::ConstMatrixView<T> in,
+                       linalg::Matrix<T> &out) = 0;
+  virtual void Backward(linalg::ConstMatrixView<T> in,
                         linalg::Matrix<T> &out) = 0;
 
+  // Inference-mode forward into caller storage of in.rows() x the output
+  // width. Keeps nothing for Backward and writes no member, so any number
+  // of threads may run it on one layer at once.
+  virtual void Infer(linalg::ConstMatrixView<T> /*in*/,
+                     linalg::MatrixView<T> /*out*/) const {
+    throw std::logic_error("Layer has no inference-mode forward");
+  }
+
   virtual void ZeroGrads() = 0;
   virtual void GradientDescentStep(float learning_rate) = 0;
+
+  // Flat views of the trainable tensors and of their gradients from the last
+  // Backward, in matching order. Layers without parameters return nothing.
+  virtual std::vector<std::span<T>> Parameters() { return {}; }
+  virtual std::vector<std::span<T>> Gradients() { return {}; }
+
+  // Moves the trainable tensors into storage owned by the caller, e.g. a
+  // ParameterArena: params[t] and grads[t] must have the sizes of
+  // Parameters()[t]. Current values are copied over and the layer works on
+  // the new storage from then on, so it must outlive the layer.
+  virtual void BindParameters(std::span<const std::span<T>> /*params*/,
+                              std::span<const std::span<T>> /*grads*/) {}
+
+  // Points the trainable tensors at params[t], sized as Parameters()[t],
+  // without copying: the layer now computes with whatever that storage
+  // holds, e.g. weights in a mapped checkpoint. Gradients stay where they
+  // are. The storage must outlive the layer.
+  virtual void
+  ReferenceParameters(std::span<const std::span<T>> /*params*/) {}
+
+  // Mixed precision: weights[t] holds Parameters()[t] in the 16-bit
+  // `storage` format, kept current by the owner after every update. A
+  // layer may run its matrix products on these copies instead; gradients
+  // and the master weights stay in T. Precision::F32 switches back.
+  virtual void
+  BindStorage(linalg::Precision /*storage*/,
+              std::span<const std::span<std::uint16_t>> /*weights*/) {}
 };
 
 } // namespace Logos::NeuralNet
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "Layer.hpp"
+#include "Matrix.inl"
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Logos::NeuralNet {
+// A run of layers used as one layer: a deep MLP, or one segment of it.
+//
+// Layers keep a view of their input for Backward, so ordinarily every
+// intermediate activation of the block stays alive from Forward until
+// Backward. With checkpointing on, Forward keeps only the block's own input
+// and passes the intermediates through two ping-pong buffers that are freed
+// when it returns. Backward first repeats the forward pass to rebuild them,
+// then runs the layers in reverse and frees them again.
+//
+// Checkpointed blocks nested in a plain one give the usual segment scheme:
+// only the block boundaries live across the step, plus the activations of
+// the one block being differentiated, for one extra forward pass. ReLU
+// masks are bit-packed and stay with their layers.
+template <class T> class LayerBlock : public ILayer<T> {
+public:
+  explicit LayerBlock(bool checkpoint = false) : m_Checkpoint(checkpoint) {}
+
+  // Constructs an L in place at the end of the block.
+  template <class L, class... Args> L &Emplace(Args &&...args) {
+    auto layer = std::make_unique<L>(std::forward<Args>(args)...);
+    L &ref = *layer;
+    m_Layers.push_back(std::move(layer));
+    return ref;
+  }
+
+  void Forward(linalg::ConstMatrixView<T> X, linalg::Matrix<T> &out) override {
+    if (m_Layers.empty())
+      throw std::logic_error("LayerBlock::Forward on an empty block");
+
+    m_LastX = X;
+    m_HasLastX = true;
+
+    if (!m_Checkpoint) {
+      RunForward(X, out);
+      return;
+    }
+
+    linalg::ConstMatrixView<T> in = X;
+    for (std::size_t i = 0; i + 1 < m_Layers.size(); i++) {
+      m_Layers[i]->Forward(in, m_Scratch[i % 2]);
+      in = m_Scratch[i % 2];
+    }
+    m_Layers.back()->Forward(in, out);
+    Release();
+  }
+
+  void Backward(linalg::ConstMatrixView<T> dOut,
+                linalg::Matrix<T> &dX) override {
+    if (!m_HasLastX)
+      throw std::runtime_error("LayerBlock::Backward called before Forward");
+
+    // Rebuild the activations and each layer's saved state; the block
+    // output itself is not needed again.
+    if (m_Checkpoint)
+      RunForward(m_LastX, m_Scratch[0]);
+
+    linalg::ConstMatrixView<T> grad = dOut;
+    for (std::size_t i = m_Layers.size() - 1; i > 0; i--) {
+      m_Layers[i]->Backward(grad, m_Grads[i % 2]);
+      grad = m_Grads[i % 2];
+    }
+    m_Layers.front()->Backward(grad, dX);
+
+    if (m_Checkpoint)
+      Release();
+  }
+
+  void ZeroGrads() override {
+    for (auto &layer : m_Layers)
+      layer->ZeroGrads();
+  }
+
+  void GradientDescentStep(float learning_rate) override {
+    for (auto &layer : m_Layers)
+      layer->GradientDescentStep(learning_rate);
+  }
+
+  std::vector<std::span<T>> Parameters() override {
+    std::vector<std::span<T>> out;
+    for (auto &layer : m_Layers)
+      for (auto p : layer->Parameters())
+        out.push_back(p);
+    return out;
+  }
+  std::vector<std::span<T>> Gradients() override {
+    std::vector<std::span<T>> out;
+    for (auto &layer : m_Layers)
+      for (auto g : layer->Gradients())
+        out.push_back(g);
+    return out;
+  }
+  // Each layer gets the slice matching its own Parameters().
+  void BindParameters(std::span<const std::span<T>> params,
+                      std::span<const std::span<T>> grads) override {
+    if (params.size() != grads.size())
+      throw std::logic_error("LayerBlock: parameter/gradient count mismatch");
+    std::size_t t = 0;
+    for (auto &layer : m_Layers) {
+      const std::size_t n = layer->Parameters().size();
+      if (t + n > params.size())
+        throw std::logic_error("LayerBlock: too few parameter tensors");
+      layer->BindParameters(params.subspan(t, n), grads.subspan(t, n));
+      t += n;
+    }
+  }
+  void ReferenceParameters(std::span<const std::span<T>> params) override {
+    std::size_t t = 0;
+    for (auto &layer : m_Layers) {
+      const std::size_t n = layer->Parameters().size();
+      if (t + n > params.size())
+        throw std::logic_error("LayerBlock: too few parameter tensors");
+      layer->ReferenceParameters(params.subspan(t, n));
+      t += n;
+    }
+  }
+  void BindStorage(linalg::Precision storage,
+                   std::span<const std::span<std::uint16_t>> weights) override {
+    std::size_t t = 0;
+    for (auto &layer : m_Layers) {
+      const std::size_t n = layer->Parameters().size();
+      layer->BindStorage(storage, storage == linalg::Precision::F32
+                                      ? weights
+                                      : weights.subspan(t, n));
+      t += n;
+    }
+  }
+
+  void SetCheckpoint(bool on) noexcept { m_Checkpoint = on; }
+  bool checkpoint() const noexcept { return m_Checkpoint; }
+
+  std::size_t size() const noexcept { return m_Layers.size(); }
+  ILayer<T> &layer(std::size_t i) { return *m_Layers[i]; }
+
+private:
+  // Forward keeping every intermediate in m_Acts.
+  void RunForward(linalg::ConstMatrixView<T> X, linalg::Matrix<T> &out) {
+    m_Acts.resize(m_Layers.size() - 1);
+    linalg::ConstMatrixView<T> in = X;
+    for (std::size_t i = 0; i + 1 < m_Layers.size(); i++) {
+      m_Layers[i]->Forward(in, m_Acts[i]);
+      in = m_Acts[i];
+    }
+    m_Layers.back()->Forward(in, out);
+  }
+
+  // Hands the intermediates back to the buffer pool.
+  void Release() {
+    m_Acts.clear();
+    for (auto &m : m_Scratch)
+      m = linalg::Matrix<T>();
+    for (auto &m : m_Grads)
+      m = linalg::Matrix<T>();
+  }
+
+  std::vector<std::unique_ptr<ILayer<T>>> m_Layers;
+  bool m_Checkpoint = false;
+
+  // Outputs of all but the last layer; empty between the passes of a
+  // checkpointed block.
+  std::vector<linalg::Matrix<T>> m_Acts;
+  linalg::Matrix<T> m_Scratch[2], m_Grads[2];
+
+  linalg::ConstMatrixView<T> m_LastX;
+  bool m_HasLastX = false;
+};
+} // namespace Logos::NeuralNet
@@ -2,15 +2,18 @@
 
 #include "Kernels.hpp"
 #include "Layer.hpp"
+#include <cstdint>
 #include <random>
+#include <span>
+#include <type_traits>
 
 namespace Logos::NeuralNet {
-template <class T> class Linear : public ILayer<T> {
+template <class T> class Linear final : public ILayer<T> {
 public:
   Linear() = default;
   Linear(std::size_t in, std::size_t out, std::mt19937 &rng)
-      : m_Weights(in, out), m_GradWeights(in, out), m_Bias(out),
-        m_GradBias(out), m_LastX(nullptr), m_HasLastX(false) {
+      : m_Weights(in, out), m_GradWeights(in, out), m_Bias(1, out),
+        m_GradBias(1, out) {
 
     const T upper_lim = std::sqrt(T(2) / static_cast<T>(in));
     std::normal_distribution<T> nd(T(0), upper_lim);
@@ -21,35 +24,88 @@ public:
       for (std::size_t j = 0; j < out; j++)
         X[i * out + j] = nd(rng);
 
+    m_Bias.fill_zeroes();
     ZeroGrads();
   }
-  ~Linear() = default;
 
-  void Forward(const linalg::Matrix<T> &X, linalg::Matrix<T> &H) override {
+  void Forward(linalg::ConstMatrixView<T> X, linalg::Matrix<T> &H) override {
     if (X.cols() != m_Weights.rows())
       throw std::logic_error("Wrong input");
 
-    m_LastX = &X;
-    m_HasLastX = true;
+    KeepInput(X);
+    WithStorage([&]<class S>(S) {
+      linalg::matmul_bias<T, S>(X, WeightsAs<S>(), Bias(), H);
+    });
+  }
+
+  // Forward followed by ReLU in a single GEMM: H = max(X W + b, 0) and
+  // mask = (X W + b > 0). H is N x OutputDim(), mask the bit-packed
+  // N x MaskBytes(OutputDim()) layout of linalg::simd. Backward expects
+  // the gradient with respect to X W + b, i.e. after the ReLU mask.
+  void ForwardReLU(linalg::ConstMatrixView<T> X, linalg::MatrixView<T> H,
+                   linalg::MatrixView<std::uint8_t> mask) {
+    if (X.cols() != m_Weights.rows())
+      throw std::logic_error("Wrong input");
+
+    KeepInput(X);
+    WithStorage([&]<class S>(S) {
+      linalg::matmul_bias_relu<T, S>(X, WeightsAs<S>(), Bias(), H, mask);
+    });
+  }
+
+  // Forward without keeping X: H = X W + b into caller storage.
+  void Infer(linalg::ConstMatrixView<T> X,
+             linalg::MatrixView<T> H) const override {
+    if (X.cols() != m_Weights.rows())
+      throw std::logic_error("Wrong input");
+
+    WithStorage([&]<class S>(S) {
+      linalg::matmul_bias<T, S>(X, WeightsAs<S>(), Bias(), H);
+    });
+  }
 
-    linalg::matmul<T>(X, m_Weights, H);
-    linalg::add_rowwise_bias<T>(m_Bias, H);
+  // ForwardReLU for inference: H = max(X W + b, 0), with no mask.
+  void InferReLU(linalg::ConstMatrixView<T> X,
+                 linalg::MatrixView<T> H) const {
+    if (X.cols() != m_Weights.rows())
+      throw std::logic_error("Wrong input");
+
+    WithStorage([&]<class S>(S) {
+      linalg::matmul_bias_relu<T, S>(X, WeightsAs<S>(), Bias(), H);
+    });
   }
 
-  void Backward(const linalg::Matrix<T> &dA, linalg::Matrix<T> &dX) override {
+  void Backward(linalg::ConstMatrixView<T> dA, linalg::Matrix<T> &dX) override {
     if (!m_HasLastX)
       throw std::runtime_error("Somethinh went wrong");
 
-    if (m_LastX->rows() != dA.rows() || dA.cols() != m_Weights.cols() ||
-        m_LastX->cols() != m_Weights.rows())
+    if (m_LastX.rows() != dA.rows() || dA.cols() != m_Weights.cols() ||
+        m_LastX.cols() != m_Weights.rows())
       throw std::logic_error("Wrong input");
 
-    linalg::matmul_transposeA<T>(*m_LastX, dA, m_GradWeights);
-    linalg::sum_rows<T>(dA, m_GradBias);
-    linalg::matmul_transposeB<T>(dA, m_Weights, dX);
+    WithStorage([&]<class S>(S) {
+      if (m_X16.data())
+        linalg::matmul_transposeA<T, S>(InputAs<S>(), dA, m_GradWeights);
+      else
+        linalg::matmul_transposeA<T>(m_LastX, dA, m_GradWeights);
+      linalg::sum_rows<T>(dA, GradBias());
+      linalg::matmul_transposeB<T, S>(dA, WeightsAs<S>(), dX);
+    });
   }
 
   void GradientDescentStep(float learning_rate) override {
+    if constexpr (std::is_same_v<T, float>) {
+      const auto &k = linalg::simd::Kernels();
+      const float *dW = m_GradWeights.data();
+      float *W = m_Weights.data();
+      Threading::parallel_for(0, m_Weights.size(), Threading::GrainFor(1),
+                              [&](std::size_t b, std::size_t e) {
+                                k.axpy(-learning_rate, dW + b, W + b, e - b);
+                              });
+      k.axpy(-learning_rate, m_GradBias.data(), m_Bias.data(), m_Bias.size());
+      return;
+    }
+
     const auto N = m_Weights.rows(), M = m_Weights.cols();
     const auto dX_ptr = m_GradWeights.data();
     auto X = m_Weights.data();
@@ -57,20 +113,161 @@ public:
       for (std::size_t j = 0; j < M; j++)
         X[i * M + j] -= learning_rate * dX_ptr[i * M + j];
 
+    const auto db = m_GradBias.data();
+    auto b = m_Bias.data();
     for (std::size_t i = 0; i < m_Bias.size(); i++)
-      m_Bias[i] -= learning_rate * m_GradBias[i];
+      b[i] -= learning_rate * db[i];
   }
 
   void ZeroGrads() override {
     m_GradWeights.fill_zeroes();
-    std::fill(m_GradBias.begin(), m_GradBias.end(), T{0});
+    m_GradBias.fill_zeroes();
+  }
+
+  std::size_t InputDim() const noexcept { return m_Weights.rows(); }
+  std::size_t OutputDim() const noexcept { return m_Weights.cols(); }
+
+  // Flat views of the parameters and of the gradients from the last
+  // Backward, in row-major order.
+  std::span<T> Weights() noexcept {
+    return {m_Weights.data(), m_Weights.size()};
+  }
+  std::span<T> Bias() noexcept { return {m_Bias.data(), m_Bias.size()}; }
+  std::span<const T> Bias() const noexcept {
+    return {m_Bias.data(), m_Bias.size()};
+  }
+  std::span<T> GradWeights() noexcept {
+    return {m_GradWeights.data(), m_GradWeights.size()};
+  }
+  std::span<T> GradBias() noexcept {
+    return {m_GradBias.data(), m_GradBias.size()};
   }
 
+  std::vector<std::span<T>> Parameters() override {
+    return {Weights(), Bias()};
+  }
+  std::vector<std::span<T>> Gradients() override {
+    return {GradWeights(), GradBias()};
+  }
+
+  void BindParameters(std::span<const std::span<T>> params,
+                      std::span<const std::span<T>> grads) override {
+    if (params.size() != 2 || grads.size() != 2)
+      throw std::logic_error("Linear: expected weights and bias");
+    m_Weights = Rebind(m_Weights, params[0]);
+    m_Bias = Rebind(m_Bias, params[1]);
+    m_GradWeights = Rebind(m_GradWeights, grads[0]);
+    m_GradBias = Rebind(m_GradBias, grads[1]);
+  }
+
+  void ReferenceParameters(std::span<const std::span<T>> params) override {
+    if (params.size() != 2 || params[0].size() != m_Weights.size() ||
+        params[1].size() != m_Bias.size())
+      throw std::logic_error("Linear: parameter size mismatch");
+    m_Weights = linalg::Matrix<T>::Wrap(params[0].data(), m_Weights.rows(),
+                                        m_Weights.cols());
+    m_Bias = linalg::Matrix<T>::Wrap(params[1].data(), 1, m_Bias.cols());
+  }
+
+  void BindStorage(linalg::Precision storage,
+                   std::span<const std::span<std::uint16_t>> weights) override {
+    if (storage == linalg::Precision::F32) {
+      m_Storage = storage;
+      m_Weights16 = nullptr;
+      m_X16 = {};
+      return;
+    }
+    if (!std::is_same_v<T, float>)
+      throw std::logic_error("Linear: 16-bit storage needs float math");
+    if (weights.size() != 2 || weights[0].size() != m_Weights.size())
+      throw std::logic_error("Linear: 16-bit weight size mismatch");
+    m_Storage = storage;
+    m_Weights16 = weights[0].data();
+  }
+
+  // With 16-bit storage bound: keep the input of the next Forward for
+  // Backward in that format, in caller-owned rows x InputDim() storage
+  // (e.g. a planned workspace buffer), instead of reading the caller's
+  // input again. Halves what an activation costs between the two passes.
+  // nullptr goes back to keeping a view of the input.
+  void BindInputStorage(std::uint16_t *storage, std::size_t rows) {
+    if (!storage || m_Storage == linalg::Precision::F32) {
+      m_X16 = {};
+      return;
+    }
+    m_X16 = linalg::Matrix<std::uint16_t>::Wrap(storage, rows, InputDim());
+  }
+
+  linalg::Precision storage() const noexcept { return m_Storage; }
+
 private:
+  // Calls fn with the element type the GEMMs read the weights in: T, or the
+  // 16-bit format of BindStorage.
+  template <class Fn> void WithStorage(Fn &&fn) const {
+    if constexpr (std::is_same_v<T, float>) {
+      if (m_Storage == linalg::Precision::BF16)
+        return fn(linalg::bf16{});
+      if (m_Storage == linalg::Precision::F16)
+        return fn(linalg::f16{});
+    }
+    fn(T{});
+  }
+
+  template <class S> linalg::ConstMatrixView<S> WeightsAs() const {
+    if constexpr (std::is_same_v<S, T>)
+      return m_Weights;
+    else
+      return {reinterpret_cast<const S *>(m_Weights16), m_Weights.rows(),
+              m_Weights.cols(), m_Weights.cols()};
+  }
+
+  template <class S> linalg::ConstMatrixView<S> InputAs() const {
+    return {reinterpret_cast<const S *>(m_X16.data()), m_LastX.rows(),
+            m_LastX.cols(), m_X16.leading_dim()};
+  }
+
+  // Remembers X for Backward: a view, or a 16-bit copy when input storage
+  // is bound (BindInputStorage). The view keeps X's shape either way.
+  void KeepInput(linalg::ConstMatrixView<T> X) {
+    m_LastX = X;
+    m_HasLastX = true;
+    if (!m_X16.data())
+      return;
+    if (X.rows() > m_X16.rows())
+      throw std::logic_error("Linear: batch larger than the input storage");
+
+    const auto M = X.cols();
+    std::uint16_t *dst = m_X16.data();
+    Threading::parallel_for(0, X.rows(), Threading::GrainFor(M),
+                            [&](std::size_t r0, std::size_t r1) {
+                              for (std::size_t i = r0; i < r1; i++)
+                                linalg::ToHalf(m_Storage, X.row(i),
+                                               dst + i * M, M);
+                            });
+  }
+
+  // A view of `to` holding the contents of `from`.
+  static linalg::Matrix<T> Rebind(linalg::Matrix<T> &from, std::span<T> to) {
+    if (to.size() != from.size())
+      throw std::logic_error("Linear: parameter size mismatch");
+    std::copy(from.data(), from.data() + from.size(), to.data());
+    return linalg::Matrix<T>::Wrap(to.data(), from.rows(), from.cols());
+  }
+
+  // Own their storage until BindParameters moves them elsewhere. The bias
+  // and its gradient are single rows.
   linalg::Matrix<T> m_Weights, m_GradWeights;
-  std::vector<T> m_Bias, m_GradBias;
+  linalg::Matrix<T> m_Bias, m_GradBias;
 
-  const linalg::Matrix<T> *m_LastX = nullptr;
+  // Input of the last Forward; the caller keeps it alive until Backward
+  // unless m_X16 holds a copy.
+  linalg::ConstMatrixView<T> m_LastX;
   bool m_HasLastX = false;
+
+  // Mixed precision: the 16-bit weights the owner keeps in step with
+  // m_Weights (BindStorage), and the optional 16-bit copy of the input.
+  linalg::Precision m_Storage = linalg::Precision::F32;
+  const std::uint16_t *m_Weights16 = nullptr;
+  linalg::Matrix<std::uint16_t> m_X16;
 };
 } // namespace Logos::NeuralNet
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Layer.hpp"
+#include "Linear.hpp"
+#include "ReLU.hpp"
+#include <cstdint>
+#include <random>
+#include <span>
+#include <utility>
+
+namespace Logos::NeuralNet {
+// Linear followed by ReLU as one layer. Forward runs a single GEMM whose
+// epilogue adds the bias, clamps and writes the mask while each output tile
+// is still in registers, so the pre-activation is never stored and read
+// back. Backward masks the incoming gradient into a scratch matrix and
+// hands it to the Linear part. Numerically the same as the pair.
+template <class T> class LinearReLU final : public ILayer<T> {
+public:
+  LinearReLU() = default;
+  LinearReLU(std::size_t in, std::size_t out, std::mt19937 &rng)
+      : m_Linear(in, out, rng) {}
+  // Takes over an existing Linear, e.g. when Sequential fuses a Linear ->
+  // ReLU pair.
+  explicit LinearReLU(Linear<T> &&linear) : m_Linear(std::move(linear)) {}
+
+  void Forward(linalg::ConstMatrixView<T> X, linalg::Matrix<T> &H) override {
+    const auto N = X.rows(), M = m_Linear.OutputDim();
+    if (H.rows() != N || H.cols() != M)
+      H = linalg::Matrix<T>(N, M);
+
+    m_Linear.ForwardReLU(X, H, m_ReLU.MaskFor(N, M));
+  }
+
+  void Infer(linalg::ConstMatrixView<T> X,
+             linalg::MatrixView<T> H) const override {
+    m_Linear.InferReLU(X, H);
+  }
+
+  void Backward(linalg::ConstMatrixView<T> dH, linalg::Matrix<T> &dX) override {
+    // Without bound storage the masked gradient goes to a per-thread buffer
+    // shared by every LinearReLU, so a deep stack does not keep one
+    // activation-sized gradient per layer.
+    thread_local linalg::Matrix<T> t_dA;
+    linalg::Matrix<T> &dA = m_dA.data() ? m_dA : t_dA;
+    m_ReLU.Backward(dH, dA);
+    m_Linear.Backward(dA, dX);
+  }
+
+  // Caller-owned rows x OutputDim() storage for the mask and for the masked
+  // gradient, e.g. planned workspace buffers. The masking is elementwise, so
+  // the gradient scratch may be the storage of Backward's dH itself. The
+  // mask is dead once Backward starts writing dX.
+  void BindMask(std::uint8_t *storage, std::size_t rows) {
+    m_ReLU.BindMask(storage, rows, m_Linear.OutputDim());
+  }
+  void BindGradScratch(T *storage, std::size_t rows) {
+    const auto M = m_Linear.OutputDim();
+    m_dA = linalg::Matrix<T>::Wrap(storage, rows, M, M,
+                                   Memory::DEFAULT_ALIGNMENT);
+  }
+
+  void ZeroGrads() override { m_Linear.ZeroGrads(); }
+  void GradientDescentStep(float learning_rate) override {
+    m_Linear.GradientDescentStep(learning_rate);
+  }
+
+  std::size_t InputDim() const noexcept { return m_Linear.InputDim(); }
+  std::size_t OutputDim() const noexcept { return m_Linear.OutputDim(); }
+
+  std::span<T> Weights() noexcept { return m_Linear.Weights(); }
+  std::span<T> Bias() noexcept { return m_Linear.Bias(); }
+  std::span<T> GradWeights() noexcept { return m_Linear.GradWeights(); }
+  std::span<T> GradBias() noexcept { return m_Linear.GradBias(); }
+
+  std::vector<std::span<T>> Parameters() override {
+    return m_Linear.Parameters();
+  }
+  std::vector<std::span<T>> Gradients() override {
+    return m_Linear.Gradients();
+  }
+  void BindParameters(std::span<const std::span<T>> params,
+                      std::span<const std::span<T>> grads) override {
+    m_Linear.BindParameters(params, grads);
+  }
+  void ReferenceParameters(std::span<const std::span<T>> params) override {
+    m_Linear.ReferenceParameters(params);
+  }
+  void BindStorage(linalg::Precision storage,
+                   std::span<const std::span<std::uint16_t>> weights) override {
+    m_Linear.BindStorage(storage, weights);
+  }
+  void BindInputStorage(std::uint16_t *storage, std::size_t rows) {
+    m_Linear.BindInputStorage(storage, rows);
+  }
+
+private:
+  Linear<T> m_Linear;
+  ReLU<T> m_ReLU;
+
+  // Gradient with respect to the pre-activation, dH with the mask applied;
+  // empty unless bound by BindGradScratch.
+  linalg::Matrix<T> m_dA;
+};
+} // namespace Logos::NeuralNet
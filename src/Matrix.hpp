@@ -19,6 +19,12 @@ public:
   Matrix(Matrix &&other) noexcept;
   Matrix &operator=(Matrix &&other) noexcept;
 
+  // Non-owning rows x cols matrix over external storage (row stride `ld`
+  // elements). The storage must outlive the Matrix.
+  static Matrix Wrap(T *data, std::size_t rows, std::size_t cols,
+                     std::size_t ld = 0,
+                     std::size_t alignment = alignof(T));
+
   T &operator()(std::size_t row, std::size_t col) {
     return reinterpret_cast<T *>(m_Buffer.data())[row * m_LeadingDim + col];
   }
@@ -42,6 +48,9 @@ public:
   void fill_zeroes() { m_Buffer.fill_zeroes(); }
 
 private:
+  Matrix(Logos::Memory::Buffer buffer, std::size_t rows, std::size_t cols,
+         std::size_t ld);
+
   Logos::Memory::Buffer m_Buffer;
   std::size_t m_Rows = 0, m_Cols = 0, m_LeadingDim = 0;
 };
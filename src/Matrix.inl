@@ -1,3 +1,5 @@
+#pragma once
+
 #include "Matrix.hpp"
 
 #include <utility>
@@ -8,6 +10,23 @@ Matrix<T>::Matrix(std::size_t rows, std::size_t cols, std::size_t alignment)
     : m_Buffer(sizeof(T) * rows * cols, alignment), m_Rows(rows), m_Cols(cols),
       m_LeadingDim(cols) {}
 
+template <class T>
+Matrix<T>::Matrix(Logos::Memory::Buffer buffer, std::size_t rows,
+                  std::size_t cols, std::size_t ld)
+    : m_Buffer(std::move(buffer)), m_Rows(rows), m_Cols(cols),
+      m_LeadingDim(ld) {}
+
+template <class T>
+Matrix<T> Matrix<T>::Wrap(T *data, std::size_t rows, std::size_t cols,
+                          std::size_t ld, std::size_t alignment) {
+  if (ld == 0)
+    ld = cols;
+  assert(ld >= cols);
+  const std::size_t bytes = rows == 0 ? 0 : ((rows - 1) * ld + cols) * sizeof(T);
+  return Matrix(Logos::Memory::Buffer::Wrap(data, bytes, alignment), rows, cols,
+                ld);
+}
+
 template <class T>
 Matrix<T>::Matrix(Matrix &&other) noexcept
     : m_Buffer(std::move(other.m_Buffer)), m_Rows(other.m_Rows),
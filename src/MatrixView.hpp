@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+#include "Matrix.hpp"
+
+namespace Logos::linalg {
+
+// Non-owning row-major window into matrix storage: rows x cols elements with
+// a row stride of leading_dim() >= cols. Views are cheap to copy and never
+// allocate; the storage they point into must outlive them.
+template <class T> class MatrixView {
+public:
+  MatrixView() = default;
+  MatrixView(T *data, std::size_t rows, std::size_t cols, std::size_t ld)
+      : m_Data(data), m_Rows(rows), m_Cols(cols), m_LeadingDim(ld) {
+    assert(ld >= cols || rows == 0);
+  }
+  MatrixView(Matrix<T> &m) noexcept
+      : m_Data(m.data()), m_Rows(m.rows()), m_Cols(m.cols()),
+        m_LeadingDim(m.leading_dim()) {}
+
+  T &operator()(std::size_t row, std::size_t col) const {
+    return m_Data[row * m_LeadingDim + col];
+  }
+
+  std::size_t rows() const noexcept { return m_Rows; }
+  std::size_t cols() const noexcept { return m_Cols; }
+  std::size_t size() const noexcept { return m_Rows * m_Cols; }
+  std::size_t leading_dim() const noexcept { return m_LeadingDim; }
+  T *data() const noexcept { return m_Data; }
+  T *row(std::size_t i) const noexcept { return m_Data + i * m_LeadingDim; }
+
+  // True when the rows are back to back, so the view is one flat array.
+  bool contiguous() const noexcept {
+    return m_LeadingDim == m_Cols || m_Rows <= 1;
+  }
+
+  // Rows [first, first + count).
+  MatrixView row_range(std::size_t first, std::size_t count) const {
+    assert(first + count <= m_Rows);
+    return {row(first), count, m_Cols, m_LeadingDim};
+  }
+  // rows x cols block starting at (row0, col0).
+  MatrixView block(std::size_t row0, std::size_t col0, std::size_t rows,
+                   std::size_t cols) const {
+    assert(row0 + rows <= m_Rows && col0 + cols <= m_Cols);
+    return {row(row0) + col0, rows, cols, m_LeadingDim};
+  }
+
+private:
+  T *m_Data = nullptr;
+  std::size_t m_Rows = 0, m_Cols = 0, m_LeadingDim = 0;
+};
+
+template <class T> class ConstMatrixView {
+public:
+  ConstMatrixView() = default;
+  ConstMatrixView(const T *data, std::size_t rows, std::size_t cols,
+                  std::size_t ld)
+      : m_Data(data), m_Rows(rows), m_Cols(cols), m_LeadingDim(ld) {
+    assert(ld >= cols || rows == 0);
+  }
+  ConstMatrixView(const Matrix<T> &m) noexcept
+      : m_Data(m.data()), m_Rows(m.rows()), m_Cols(m.cols()),
+        m_LeadingDim(m.leading_dim()) {}
+  ConstMatrixView(MatrixView<T> v) noexcept
+      : m_Data(v.data()), m_Rows(v.rows()), m_Cols(v.cols()),
+        m_LeadingDim(v.leading_dim()) {}
+
+  const T &operator()(std::size_t row, std::size_t col) const {
+    return m_Data[row * m_LeadingDim + col];
+  }
+
+  std::size_t rows() const noexcept { return m_Rows; }
+  std::size_t cols() const noexcept { return m_Cols; }
+  std::size_t size() const noexcept { return m_Rows * m_Cols; }
+  std::size_t leading_dim() const noexcept { return m_LeadingDim; }
+  const T *data() const noexcept { return m_Data; }
+  const T *row(std::size_t i) const noexcept {
+    return m_Data + i * m_LeadingDim;
+  }
+
+  bool contiguous() const noexcept {
+    return m_LeadingDim == m_Cols || m_Rows <= 1;
+  }
+
+  ConstMatrixView row_range(std::size_t first, std::size_t count) const {
+    assert(first + count <= m_Rows);
+    return {row(first), count, m_Cols, m_LeadingDim};
+  }
+  ConstMatrixView block(std::size_t row0, std::size_t col0, std::size_t rows,
+                        std::size_t cols) const {
+    assert(row0 + rows <= m_Rows && col0 + cols <= m_Cols);
+    return {row(row0) + col0, rows, cols, m_LeadingDim};
+  }
+
+private:
+  const T *m_Data = nullptr;
+  std::size_t m_Rows = 0, m_Cols = 0, m_LeadingDim = 0;
+};
+} // namespace Logos::linalg
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Logos::Memory {
+
+// Source of aligned blocks for Buffer. Deallocate receives the same size and
+// alignment that were passed to Allocate.
+class Allocator {
+public:
+  virtual ~Allocator() = default;
+
+  virtual void *Allocate(std::size_t bytes, std::size_t alignment) = 0;
+  virtual void Deallocate(void *ptr, std::size_t bytes,
+                          std::size_t alignment) noexcept = 0;
+};
+
+// posix_memalign / _aligned_malloc.
+Allocator &SystemAllocator();
+
+// Allocator used by Buffers that are not given one: BufferPool::Global(),
+// or SystemAllocator() when LOGOS_BUFFER_POOL=0.
+Allocator &DefaultAllocator();
+// Changes the default for Buffers allocated from now on; existing Buffers
+// keep freeing through the allocator they came from.
+void SetDefaultAllocator(Allocator &allocator);
+} // namespace Logos::Memory
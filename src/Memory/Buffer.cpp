@@ -1,51 +1,86 @@
-#include <new>
+#include <atomic>
+#include <cstdint>
 #include <stdexcept>
 
-#include "AlignedAlloc.hpp"
 #include "Buffer.hpp"
 
 namespace Logos::Memory {
+namespace {
+std::atomic<std::uint64_t> s_Allocations{0};
+} // namespace
+
+std::uint64_t Buffer::AllocationCount() noexcept {
+  return s_Allocations.load(std::memory_order_relaxed);
+}
+
 Buffer::Buffer()
-    : m_Data(nullptr), m_Bytes(0), m_Alignment(DEFAULT_ALIGNMENT) {}
+    : m_Data(nullptr), m_Bytes(0), m_Alignment(DEFAULT_ALIGNMENT),
+      m_Allocator(&DefaultAllocator()) {}
 
-Buffer::Buffer(std::size_t size, std::size_t alignment)
-    : m_Data(nullptr), m_Bytes(0), m_Alignment(alignment) {
+Buffer::Buffer(std::size_t size, std::size_t alignment, Allocator *allocator)
+    : m_Data(nullptr), m_Bytes(0), m_Alignment(alignment),
+      m_Allocator(allocator ? allocator : &DefaultAllocator()) {
   reset(size, alignment);
 }
 
-Buffer::~Buffer() { aligned_free(m_Data); }
+Buffer::~Buffer() { release(); }
 
 Buffer::Buffer(Buffer &&other) noexcept
     : m_Data(other.m_Data), m_Bytes(other.m_Bytes),
-      m_Alignment(other.m_Alignment) {
+      m_Alignment(other.m_Alignment), m_Allocator(other.m_Allocator),
+      m_Owned(other.m_Owned) {
   other.m_Data = nullptr;
   other.m_Bytes = 0;
   other.m_Alignment = DEFAULT_ALIGNMENT;
+  other.m_Owned = true;
 }
 
 Buffer &Buffer::operator=(Buffer &&other) noexcept {
   if (this == &other)
     return *this;
 
-  aligned_free(m_Data);
+  release();
   m_Data = other.m_Data;
   m_Bytes = other.m_Bytes;
   m_Alignment = other.m_Alignment;
+  m_Allocator = other.m_Allocator;
+  m_Owned = other.m_Owned;
 
   other.m_Data = nullptr;
   other.m_Bytes = 0;
   other.m_Alignment = DEFAULT_ALIGNMENT;
+  other.m_Owned = true;
   return *this;
 }
 
+Buffer Buffer::Wrap(void *data, std::size_t size, std::size_t alignment) {
+  if (!IsPow2(alignment))
+    throw std::logic_error("Buffer alignment must be a power of two");
+  if (reinterpret_cast<std::uintptr_t>(data) % alignment != 0)
+    throw std::logic_error("Buffer::Wrap: data is not aligned");
+
+  Buffer buffer;
+  buffer.m_Data = data;
+  buffer.m_Bytes = size;
+  buffer.m_Alignment = alignment;
+  buffer.m_Owned = false;
+  return buffer;
+}
+
+void Buffer::release() noexcept {
+  if (m_Owned && m_Data)
+    m_Allocator->Deallocate(m_Data, m_Bytes, m_Alignment);
+  m_Data = nullptr;
+}
+
 void Buffer::reset(std::size_t size, std::size_t alignment) {
   if (!IsPow2(alignment))
     throw std::logic_error("Buffer alignment must be a power of two");
   if (alignment < alignof(void *))
     throw std::logic_error("Buffer alignment is too small");
 
-  aligned_free(m_Data);
-  m_Data = nullptr;
+  release();
+  m_Owned = true;
   m_Bytes = 0;
 
   if (size == 0) {
@@ -53,9 +88,8 @@ void Buffer::reset(std::size_t size, std::size_t alignment) {
     return;
   }
 
-  m_Data = aligned_malloc(size, alignment);
-  if (!m_Data)
-    throw std::bad_alloc();
+  m_Data = m_Allocator->Allocate(size, alignment);
+  s_Allocations.fetch_add(1, std::memory_order_relaxed);
 
   m_Bytes = size;
   m_Alignment = alignment;
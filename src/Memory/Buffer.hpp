@@ -1,15 +1,19 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 
+#include "Allocator.hpp"
 #include "MemoryUtility.hpp"
 
 namespace Logos::Memory {
 class Buffer {
 public:
   Buffer();
-  explicit Buffer(std::size_t size, std::size_t alignment = DEFAULT_ALIGNMENT);
+  // Blocks come from `allocator`, or from DefaultAllocator() when null.
+  explicit Buffer(std::size_t size, std::size_t alignment = DEFAULT_ALIGNMENT,
+                  Allocator *allocator = nullptr);
   ~Buffer();
 
   Buffer(const Buffer &other) = delete;
@@ -18,6 +22,11 @@ public:
   Buffer(Buffer &&other) noexcept;
   Buffer &operator=(Buffer &&other) noexcept;
 
+  // Non-owning buffer over memory managed elsewhere (e.g. a file mapping).
+  // It is never freed and must outlive the Buffer.
+  static Buffer Wrap(void *data, std::size_t size,
+                     std::size_t alignment = DEFAULT_ALIGNMENT);
+
   void reset(std::size_t size, std::size_t alignment = DEFAULT_ALIGNMENT);
 
   void fill_zeroes() { std::memset(m_Data, 0, m_Bytes); }
@@ -26,9 +35,19 @@ public:
 
   std::size_t size_bytes() const noexcept { return m_Bytes; }
   std::size_t alignment() const noexcept { return m_Alignment; }
+  bool owns_data() const noexcept { return m_Owned; }
+  Allocator &allocator() const noexcept { return *m_Allocator; }
+
+  // Blocks requested by all Buffers since startup, whether or not the
+  // allocator had to go to the heap for them.
+  static std::uint64_t AllocationCount() noexcept;
 
 private:
+  void release() noexcept;
+
   void *m_Data;
   std::size_t m_Bytes, m_Alignment;
+  Allocator *m_Allocator;
+  bool m_Owned = true;
 };
 } // namespace Logos::Memory
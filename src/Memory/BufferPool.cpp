@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "AlignedAlloc.hpp"
+#include "BufferPool.hpp"
+#include "MemoryUtility.hpp"
+
+namespace Logos::Memory {
+namespace {
+constexpr std::size_t MIN_BLOCK = 64;
+constexpr std::size_t PAGE = 4096;
+constexpr std::size_t HUGE_PAGE = std::size_t(2) << 20;
+constexpr std::size_t MAX_POOLED = std::size_t(4) << 30;
+
+// Classes 0-3 are 64..256 in steps of 64; above that every octave
+// (2^e, 2^(e+1)] is split into four steps of 2^(e-2).
+constexpr std::size_t ClassIndex(std::size_t bytes) {
+  if (bytes <= 4 * MIN_BLOCK)
+    return bytes == 0 ? 0 : (bytes - 1) / MIN_BLOCK;
+  const std::size_t e = std::bit_width(bytes - 1) - 1;
+  const std::size_t step = std::size_t(1) << (e - 2);
+  return 4 + (e - 8) * 4 + ((bytes + step - 1) / step - 5);
+}
+
+constexpr std::size_t ClassBytes(std::size_t cls) {
+  if (cls < 4)
+    return (cls + 1) * MIN_BLOCK;
+  const std::size_t e = 8 + (cls - 4) / 4;
+  return (5 + (cls - 4) % 4) << (e - 2);
+}
+
+constexpr std::size_t NUM_CLASSES = ClassIndex(MAX_POOLED) + 1;
+static_assert(ClassBytes(ClassIndex(257)) == 320);
+static_assert(ClassBytes(ClassIndex(513)) == 640);
+static_assert(ClassBytes(NUM_CLASSES - 1) == MAX_POOLED);
+
+// Alignment every block of a class is allocated with.
+constexpr std::size_t ClassAlignment(std::size_t bytes) {
+  return bytes >= HUGE_PAGE ? HUGE_PAGE : bytes >= PAGE ? PAGE : MIN_BLOCK;
+}
+
+// Reserved size: huge blocks are padded to whole huge pages so the tail of
+// the last one can be backed too.
+constexpr std::size_t ReservedBytes(std::size_t bytes) {
+  return bytes >= HUGE_PAGE ? AlignUp(bytes, HUGE_PAGE) : bytes;
+}
+
+class System final : public Allocator {
+public:
+  void *Allocate(std::size_t bytes, std::size_t alignment) override {
+    void *ptr = aligned_malloc(bytes, alignment);
+    if (!ptr)
+      throw std::bad_alloc();
+    return ptr;
+  }
+  void Deallocate(void *ptr, std::size_t, std::size_t) noexcept override {
+    aligned_free(ptr);
+  }
+};
+
+Allocator &InitialDefault() {
+  const char *env = std::getenv("LOGOS_BUFFER_POOL");
+  if (env && std::strcmp(env, "0") == 0)
+    return SystemAllocator();
+  return BufferPool::Global();
+}
+
+std::atomic<Allocator *> s_Default{nullptr};
+} // namespace
+
+Allocator &SystemAllocator() {
+  static System system;
+  return system;
+}
+
+Allocator &DefaultAllocator() {
+  Allocator *current = s_Default.load(std::memory_order_acquire);
+  if (current)
+    return *current;
+  Allocator *initial = &InitialDefault();
+  s_Default.compare_exchange_strong(current, initial,
+                                    std::memory_order_acq_rel);
+  return *s_Default.load(std::memory_order_acquire);
+}
+
+void SetDefaultAllocator(Allocator &allocator) {
+  s_Default.store(&allocator, std::memory_order_release);
+}
+
+// Per-thread stacks of free blocks for the small classes. Flushed to the
+// shared lists when full and when the thread exits.
+struct ThreadCache {
+  static constexpr std::size_t CLASSES = ClassIndex(256 << 10) + 1;
+  static constexpr std::size_t DEPTH = 8;
+
+  std::array<std::array<void *, DEPTH>, CLASSES> slots{};
+  std::array<std::size_t, CLASSES> counts{};
+
+  ThreadCache();
+  ~ThreadCache();
+
+  void Flush() noexcept {
+    BufferPool &pool = BufferPool::Global();
+    for (std::size_t cls = 0; cls < CLASSES; cls++) {
+      while (counts[cls] > 0) {
+        void *ptr = slots[cls][--counts[cls]];
+        try {
+          pool.PushShared(cls, ptr);
+        } catch (...) {
+          pool.m_Cached.fetch_sub(ClassBytes(cls), std::memory_order_relaxed);
+          pool.SystemFree(ptr, cls);
+        }
+      }
+    }
+  }
+};
+
+namespace {
+enum class CacheState : unsigned char { Unused, Live, Destroyed };
+
+// Plain flag next to the cache so Buffers released by thread_locals that
+// outlive it (or by statics, after the main thread's cache is gone) can
+// fall back to the shared lists.
+thread_local CacheState t_CacheState = CacheState::Unused;
+thread_local ThreadCache t_Cache;
+
+ThreadCache *LocalCache() noexcept {
+  return t_CacheState == CacheState::Destroyed ? nullptr : &t_Cache;
+}
+} // namespace
+
+ThreadCache::ThreadCache() { t_CacheState = CacheState::Live; }
+
+ThreadCache::~ThreadCache() {
+  Flush();
+  t_CacheState = CacheState::Destroyed;
+}
+
+BufferPool::BufferPool() : m_Lists(NUM_CLASSES) {}
+
+BufferPool &BufferPool::Global() {
+  // Never destroyed: Buffers in other statics may be freed after main.
+  static BufferPool *pool = new BufferPool();
+  return *pool;
+}
+
+std::size_t BufferPool::ClassSize(std::size_t bytes) {
+  return bytes > MAX_POOLED ? bytes : ClassBytes(ClassIndex(bytes));
+}
+
+void *BufferPool::SystemAllocate(std::size_t cls) {
+  const std::size_t bytes = ClassBytes(cls);
+  void *ptr = aligned_malloc(ReservedBytes(bytes), ClassAlignment(bytes));
+  if (!ptr)
+    throw std::bad_alloc();
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (bytes >= HUGE_PAGE)
+    madvise(ptr, ReservedBytes(bytes), MADV_HUGEPAGE);
+#endif
+  return ptr;
+}
+
+void BufferPool::SystemFree(void *ptr, std::size_t) noexcept {
+  aligned_free(ptr);
+}
+
+void BufferPool::PushShared(std::size_t cls, void *ptr) {
+  FreeList &list = m_Lists[cls];
+  std::lock_guard lock(list.mutex);
+  list.blocks.push_back(ptr);
+}
+
+void BufferPool::PushShared(std::size_t cls, void *const *first,
+                            void *const *last) {
+  FreeList &list = m_Lists[cls];
+  std::lock_guard lock(list.mutex);
+  // Only the reserve can throw, and it leaves the list as it was.
+  list.blocks.reserve(list.blocks.size() + (last - first));
+  list.blocks.insert(list.blocks.end(), first, last);
+}
+
+void *BufferPool::PopShared(std::size_t cls) {
+  FreeList &list = m_Lists[cls];
+  std::lock_guard lock(list.mutex);
+  if (list.blocks.empty())
+    return nullptr;
+  void *ptr = list.blocks.back();
+  list.blocks.pop_back();
+  return ptr;
+}
+
+void BufferPool::OnLive(std::ptrdiff_t delta) noexcept {
+  const std::size_t live =
+      m_Live.fetch_add(std::size_t(delta), std::memory_order_relaxed) +
+      std::size_t(delta);
+  if (delta <= 0)
+    return;
+  std::size_t peak = m_Peak.load(std::memory_order_relaxed);
+  while (live > peak &&
+         !m_Peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    ;
+}
+
+void *BufferPool::Allocate(std::size_t bytes, std::size_t alignment) {
+  const std::size_t cls = ClassIndex(bytes);
+  if (bytes > MAX_POOLED || alignment > ClassAlignment(ClassBytes(cls))) {
+    m_Bypassed.fetch_add(1, std::memory_order_relaxed);
+    return SystemAllocator().Allocate(bytes, alignment);
+  }
+
+  const std::size_t size = ClassBytes(cls);
+  ThreadCache *cache = cls < ThreadCache::CLASSES ? LocalCache() : nullptr;
+  void *ptr = nullptr;
+  if (cache && cache->counts[cls] > 0)
+    ptr = cache->slots[cls][--cache->counts[cls]];
+  else
+    ptr = PopShared(cls);
+
+  if (ptr) {
+    m_Hits.fetch_add(1, std::memory_order_relaxed);
+    m_Cached.fetch_sub(size, std::memory_order_relaxed);
+  } else {
+    ptr = SystemAllocate(cls);
+    m_Misses.fetch_add(1, std::memory_order_relaxed);
+  }
+  OnLive(std::ptrdiff_t(size));
+  return ptr;
+}
+
+void BufferPool::Deallocate(void *ptr, std::size_t bytes,
+                            std::size_t alignment) noexcept {
+  if (!ptr)
+    return;
+  const std::size_t cls = ClassIndex(bytes);
+  if (bytes > MAX_POOLED || alignment > ClassAlignment(ClassBytes(cls))) {
+    SystemAllocator().Deallocate(ptr, bytes, alignment);
+    return;
+  }
+
+  const std::size_t size = ClassBytes(cls);
+  OnLive(-std::ptrdiff_t(size));
+  m_Cached.fetch_add(size, std::memory_order_relaxed);
+
+  ThreadCache *cache = cls < ThreadCache::CLASSES ? LocalCache() : nullptr;
+  if (cache) {
+    if (cache->counts[cls] == ThreadCache::DEPTH) {
+      // Hand the older half to the shared list so other threads see it.
+      // The cache only gives them up once the push has succeeded: a block
+      // in both places would go to two Buffers.
+      try {
+        void *const *first = cache->slots[cls].data();
+        PushShared(cls, first, first + ThreadCache::DEPTH / 2);
+      } catch (...) {
+        m_Cached.fetch_sub(size, std::memory_order_relaxed);
+        SystemFree(ptr, cls);
+        return;
+      }
+      std::copy(cache->slots[cls].begin() + ThreadCache::DEPTH / 2,
+                cache->slots[cls].end(), cache->slots[cls].begin());
+      cache->counts[cls] -= ThreadCache::DEPTH / 2;
+    }
+    cache->slots[cls][cache->counts[cls]++] = ptr;
+    return;
+  }
+
+  try {
+    PushShared(cls, ptr);
+  } catch (...) {
+    m_Cached.fetch_sub(size, std::memory_order_relaxed);
+    SystemFree(ptr, cls);
+  }
+}
+
+BufferPool::Stats BufferPool::GetStats() const noexcept {
+  Stats stats;
+  stats.live_bytes = m_Live.load(std::memory_order_relaxed);
+  stats.peak_bytes = m_Peak.load(std::memory_order_relaxed);
+  stats.cached_bytes = m_Cached.load(std::memory_order_relaxed);
+  stats.hits = m_Hits.load(std::memory_order_relaxed);
+  stats.misses = m_Misses.load(std::memory_order_relaxed);
+  stats.bypassed = m_Bypassed.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void BufferPool::ResetPeak() noexcept {
+  m_Peak.store(m_Live.load(std::memory_order_relaxed),
+               std::memory_order_relaxed);
+}
+
+void BufferPool::Trim() {
+  if (ThreadCache *cache = LocalCache())
+    cache->Flush();
+  for (std::size_t cls = 0; cls < NUM_CLASSES; cls++) {
+    std::vector<void *> blocks;
+    {
+      std::lock_guard lock(m_Lists[cls].mutex);
+      blocks.swap(m_Lists[cls].blocks);
+    }
+    for (void *ptr : blocks)
+      SystemFree(ptr, cls);
+    m_Cached.fetch_sub(blocks.size() * ClassBytes(cls),
+                       std::memory_order_relaxed);
+  }
+}
+} // namespace Logos::Memory
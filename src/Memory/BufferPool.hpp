@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "Allocator.hpp"
+
+namespace Logos::Memory {
+
+// Recycling allocator for Buffer. Requests are rounded up to a size class
+// (four classes per power of two, so at most 25% slack) and freed blocks are
+// kept for the next request of the same class instead of going back to the
+// system.
+//
+// Classes up to 256 KiB have a small per-thread cache in front of the shared
+// free lists, so the common reshape/free/reallocate pattern needs no lock.
+// Blocks of 2 MiB and more are 2 MiB aligned and advised for transparent
+// huge pages. Requests above 4 GiB or with more than page alignment bypass
+// the pool.
+class BufferPool final : public Allocator {
+public:
+  struct Stats {
+    std::size_t live_bytes = 0;   // handed out and not yet freed
+    std::size_t peak_bytes = 0;   // high-water mark of live_bytes
+    std::size_t cached_bytes = 0; // free blocks held by the pool
+    std::uint64_t hits = 0;       // served from a free block
+    std::uint64_t misses = 0;     // needed a fresh system allocation
+    std::uint64_t bypassed = 0;   // too large or over-aligned for the pool
+  };
+
+  static BufferPool &Global();
+
+  void *Allocate(std::size_t bytes, std::size_t alignment) override;
+  void Deallocate(void *ptr, std::size_t bytes,
+                  std::size_t alignment) noexcept override;
+
+  Stats GetStats() const noexcept;
+  void ResetPeak() noexcept;
+
+  // Returns every free block in the shared lists, and in the calling
+  // thread's cache, to the system.
+  void Trim();
+
+  // Block size actually reserved for a request of `bytes`.
+  static std::size_t ClassSize(std::size_t bytes);
+
+private:
+  friend struct ThreadCache;
+
+  BufferPool();
+
+  struct FreeList {
+    std::mutex mutex;
+    std::vector<void *> blocks;
+  };
+
+  void *SystemAllocate(std::size_t cls);
+  void SystemFree(void *ptr, std::size_t cls) noexcept;
+  void PushShared(std::size_t cls, void *ptr);
+  // Pushes [first, last) under one lock; if it throws, none were pushed.
+  void PushShared(std::size_t cls, void *const *first, void *const *last);
+  void *PopShared(std::size_t cls);
+  void OnLive(std::ptrdiff_t delta) noexcept;
+
+  std::vector<FreeList> m_Lists;
+
+  std::atomic<std::size_t> m_Live{0}, m_Peak{0}, m_Cached{0};
+  std::atomic<std::uint64_t> m_Hits{0}, m_Misses{0}, m_Bypassed{0};
+};
+} // namespace Logos::Memory
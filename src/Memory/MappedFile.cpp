@@ -0,0 +1,89 @@
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Memory/MappedFile.hpp"
+
+namespace Logos::Memory {
+
+MappedFile::~MappedFile() { close(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : m_Mapping(std::exchange(other.m_Mapping, nullptr)),
+      m_Owned(std::move(other.m_Owned)),
+      m_Data(std::exchange(other.m_Data, nullptr)),
+      m_Bytes(std::exchange(other.m_Bytes, 0)) {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this == &other)
+    return *this;
+
+  close();
+  m_Mapping = std::exchange(other.m_Mapping, nullptr);
+  m_Owned = std::move(other.m_Owned);
+  m_Data = std::exchange(other.m_Data, nullptr);
+  m_Bytes = std::exchange(other.m_Bytes, 0);
+  return *this;
+}
+
+void MappedFile::close() noexcept {
+#if !defined(_WIN32)
+  if (m_Mapping)
+    munmap(m_Mapping, m_Bytes);
+#endif
+  m_Mapping = nullptr;
+  m_Owned = Buffer();
+  m_Data = nullptr;
+  m_Bytes = 0;
+}
+
+MappedFile MappedFile::Open(const std::string &path) {
+  MappedFile f;
+
+#if !defined(_WIN32)
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Cannot open: " + path);
+
+  struct stat st{};
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    throw std::runtime_error("Cannot map empty file: " + path);
+  }
+
+  const auto bytes = static_cast<std::size_t>(st.st_size);
+  void *map = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED)
+    throw std::runtime_error("mmap failed: " + path);
+
+  f.m_Mapping = map;
+  f.m_Data = map;
+  f.m_Bytes = bytes;
+#else
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in)
+    throw std::runtime_error("Cannot open: " + path);
+  const auto bytes = static_cast<std::size_t>(in.tellg());
+  if (bytes == 0)
+    throw std::runtime_error("Cannot map empty file: " + path);
+  in.seekg(0);
+
+  f.m_Owned.reset(bytes, 4096); // as aligned as a mapping
+  in.read(static_cast<char *>(f.m_Owned.data()),
+          static_cast<std::streamsize>(bytes));
+  if (!in)
+    throw std::runtime_error("Failed reading: " + path);
+  f.m_Data = f.m_Owned.data();
+  f.m_Bytes = bytes;
+#endif
+  return f;
+}
+} // namespace Logos::Memory
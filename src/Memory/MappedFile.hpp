@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "Memory/Buffer.hpp"
+
+namespace Logos::Memory {
+// A whole file in memory. On POSIX the file is mmap'ed private and
+// writable: its pages stay shared with the page cache (and with other
+// processes mapping it) until written, opening costs no read, and writes
+// never reach the file. Elsewhere it is read into an owned, page-aligned
+// buffer.
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  static MappedFile Open(const std::string &path);
+
+  void *data() noexcept { return m_Data; }
+  const void *data() const noexcept { return m_Data; }
+  std::size_t size() const noexcept { return m_Bytes; }
+  bool is_mapped() const noexcept { return m_Mapping != nullptr; }
+
+private:
+  void close() noexcept;
+
+  void *m_Mapping = nullptr; // when mmap'ed
+  Buffer m_Owned;            // when read instead
+  void *m_Data = nullptr;
+  std::size_t m_Bytes = 0;
+};
+} // namespace Logos::Memory
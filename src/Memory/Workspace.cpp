@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "Workspace.hpp"
+
+namespace Logos::Memory {
+
+WorkspacePlan::Id WorkspacePlan::Add(const char *name, std::size_t bytes,
+                                     std::size_t first_step,
+                                     std::size_t last_step,
+                                     std::size_t alignment) {
+  if (last_step < first_step)
+    throw std::logic_error("WorkspacePlan: buffer ends before it starts");
+  if (!IsPow2(alignment))
+    throw std::logic_error("WorkspacePlan alignment must be a power of two");
+
+  m_Buffers.push_back({name, bytes, first_step, last_step, alignment});
+  return m_Buffers.size() - 1;
+}
+
+void WorkspacePlan::Solve() {
+  std::vector<Id> order(m_Buffers.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](Id a, Id b) {
+    return m_Buffers[a].bytes > m_Buffers[b].bytes;
+  });
+
+  std::vector<Id> placed, conflicts;
+  m_Peak = 0;
+  for (const Id id : order) {
+    Entry &e = m_Buffers[id];
+
+    conflicts.clear();
+    for (const Id p : placed) {
+      const Entry &o = m_Buffers[p];
+      if (o.first <= e.last && e.first <= o.last)
+        conflicts.push_back(p);
+    }
+    std::sort(conflicts.begin(), conflicts.end(), [&](Id a, Id b) {
+      return m_Buffers[a].offset < m_Buffers[b].offset;
+    });
+
+    // First gap between live neighbours that fits.
+    std::size_t offset = 0;
+    for (const Id c : conflicts) {
+      const Entry &o = m_Buffers[c];
+      if (offset + e.bytes <= o.offset)
+        break;
+      offset = std::max(offset, AlignUp(o.offset + o.bytes, e.alignment));
+    }
+
+    e.offset = offset;
+    m_Peak = std::max(m_Peak, offset + e.bytes);
+    placed.push_back(id);
+  }
+}
+
+std::size_t WorkspacePlan::total_bytes() const noexcept {
+  std::size_t total = 0;
+  for (const auto &e : m_Buffers)
+    total += e.bytes;
+  return total;
+}
+
+void Workspace::Reserve(const WorkspacePlan &plan, std::size_t scratch_bytes) {
+  const std::size_t planned = AlignUp(plan.peak_bytes(), DEFAULT_ALIGNMENT);
+  const std::size_t needed = planned + scratch_bytes;
+  if (!m_Arena || m_Arena->capacity() < needed) {
+    m_Arena = std::make_unique<Arena>(needed);
+    m_Base = m_Arena->Allocate<std::byte>(0);
+  }
+
+  m_Offsets.resize(plan.size());
+  for (WorkspacePlan::Id id = 0; id < plan.size(); id++)
+    m_Offsets[id] = plan.offset(id);
+  m_Planned = planned;
+  BeginStep();
+}
+
+void Workspace::BeginStep() {
+  m_Arena->reset();
+  m_Arena->Allocate<std::byte>(m_Planned, DEFAULT_ALIGNMENT);
+}
+} // namespace Logos::Memory
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "MemoryPool.hpp"
+
+namespace Logos::Memory {
+
+// Static memory plan for buffers with known lifetimes. Every buffer is live
+// over an inclusive range of step indices; buffers whose lifetimes do not
+// intersect may share bytes. Solve() places them largest first at the lowest
+// aligned offset that does not collide with an already placed, overlapping
+// buffer.
+class WorkspacePlan {
+public:
+  using Id = std::size_t;
+
+  Id Add(const char *name, std::size_t bytes, std::size_t first_step,
+         std::size_t last_step, std::size_t alignment = DEFAULT_ALIGNMENT);
+  void Solve();
+
+  std::size_t size() const noexcept { return m_Buffers.size(); }
+  const char *name(Id id) const { return m_Buffers[id].name; }
+  std::size_t bytes(Id id) const { return m_Buffers[id].bytes; }
+  std::size_t offset(Id id) const { return m_Buffers[id].offset; }
+
+  // Arena bytes needed by the plan, and what the buffers would take without
+  // any reuse.
+  std::size_t peak_bytes() const noexcept { return m_Peak; }
+  std::size_t total_bytes() const noexcept;
+
+private:
+  struct Entry {
+    const char *name;
+    std::size_t bytes, first, last, alignment, offset = 0;
+  };
+  std::vector<Entry> m_Buffers;
+  std::size_t m_Peak = 0;
+};
+
+// Arena holding a solved plan. The planned region sits at the start of the
+// arena; BeginStep() resets the arena, keeping that region, so anything
+// taken with Allocate() lasts for one step.
+class Workspace {
+public:
+  Workspace() = default;
+
+  // Lays out `plan` plus `scratch_bytes` of per-step space. The arena only
+  // grows; a smaller plan reuses the current one.
+  void Reserve(const WorkspacePlan &plan, std::size_t scratch_bytes = 0);
+  void BeginStep();
+
+  template <class T> T *Get(WorkspacePlan::Id id) const {
+    return reinterpret_cast<T *>(m_Base + m_Offsets[id]);
+  }
+  template <class T> T *Allocate(std::size_t count = 1) {
+    return m_Arena->Allocate<T>(count, DEFAULT_ALIGNMENT);
+  }
+
+  std::size_t capacity() const noexcept {
+    return m_Arena ? m_Arena->capacity() : 0;
+  }
+  std::size_t planned_bytes() const noexcept { return m_Planned; }
+
+private:
+  std::unique_ptr<Arena> m_Arena;
+  std::byte *m_Base = nullptr;
+  std::vector<std::size_t> m_Offsets;
+  std::size_t m_Planned = 0;
+};
+} // namespace Logos::Memory
@@ -1,146 +1,513 @@
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <cstdio>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <random>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "Data/BatchPipeline.hpp"
 #include "Functions.hpp"
 #include "NeuralNetwork.hpp"
+#include "QuantizedMLP.hpp"
+#include "Serving/SocketServer.hpp"
+#include "Threading/Collectives.hpp"
 
 namespace Logos::NeuralNet {
 
-MLP_Hardcoded::MLP_Hardcoded(std::size_t in_dim, std::size_t hidden_dim,
-                             std::size_t num_classes, std::mt19937 &rng)
-    : fc1(in_dim, hidden_dim, rng), fc2(hidden_dim, num_classes, rng) {}
+Model MakeMLP(std::size_t in_dim, std::size_t hidden_dim,
+              std::size_t num_classes, std::mt19937 &rng) {
+  Model model(in_dim);
+  model.AddLinear(hidden_dim, rng).AddReLU().AddLinear(num_classes, rng);
+  model.Build();
+  return model;
+}
 
-double MLP_Hardcoded::TrainStep(const Matrix &X,
-                                const std::vector<uint8_t> &labels,
-                                double learning_rate) {
-  const auto N = X.rows(), M = X.cols();
-  if (N == 0 || M == 0)
-    throw std::logic_error("TrainStep: empty input matrix");
-  if (labels.size() != N)
-    throw std::logic_error("TrainStep: labels size mismatch");
+DataParallelTrainer::DataParallelTrainer(Model &model, std::size_t replicas)
+    : m_Model(model) {
+  if (replicas == 0)
+    replicas = Threading::ThreadPool::Global().size();
+
+  for (std::size_t k = 1; k < replicas; k++)
+    m_Replicas.push_back(model.Replica());
 
-  fc1.Forward(X, A1);
-  relu.Forward(A1, H1);
-  fc2.Forward(H1, logits);
+  m_ShardLoss.resize(replicas);
 
-  Matrix probs;
-  Softmax<float>(logits, probs);
-  const float loss = CrossEntropy<float>(probs, labels, dLogits);
+  m_FlatSize = model.FlatParameters().size();
+  for (std::size_t k = 0; k < replicas; k++) {
+    m_ParamPtrs.push_back(Replica(k).FlatParameters().data());
+    m_GradPtrs.push_back(Replica(k).FlatGradients().data());
+  }
+}
 
-  fc2.Backward(dLogits, dH1);
-  relu.Backward(dH1, dA1);
-  fc1.Backward(dA1, dX);
+double DataParallelTrainer::TrainStep(ConstMatrixView X, Labels labels,
+                                      double learning_rate) {
+  const auto N = X.rows(), D = X.cols(), K = replicas();
+  if (N == 0 || D == 0)
+    throw std::logic_error("DataParallelTrainer: empty input matrix");
+  if (labels.size() != N)
+    throw std::logic_error("DataParallelTrainer: labels size mismatch");
+
+  Threading::parallel_for(0, K, 1, [&](std::size_t k0, std::size_t k1) {
+    for (std::size_t k = k0; k < k1; k++) {
+      Model &model = Replica(k);
+      const std::size_t r0 = k * N / K, r1 = (k + 1) * N / K, rows = r1 - r0;
+
+      // Batches smaller than K leave some replicas without rows.
+      if (rows == 0) {
+        model.ZeroGrads();
+        m_ShardLoss[k] = 0.0;
+        continue;
+      }
 
-  fc1.GradientDescentStep(learning_rate);
-  fc2.GradientDescentStep(learning_rate);
+      // Each replica averages over its own shard; reweight so the reduced
+      // sum is the mean over the global batch. Shards are row ranges of X,
+      // so nothing is copied.
+      const float weight = static_cast<float>(rows) / static_cast<float>(N);
+      m_ShardLoss[k] = model.ComputeGradients(X.row_range(r0, rows),
+                                              labels.subspan(r0, rows)) *
+                       weight;
+      for (auto &g : model.FlatGradients())
+        g *= weight;
+    }
+  });
 
-  fc1.ZeroGrads();
-  fc2.ZeroGrads();
+  Threading::TreeReduce(m_GradPtrs, m_FlatSize);
+  m_Model.ApplyGradients(learning_rate);
+  Threading::Broadcast(m_ParamPtrs, m_FlatSize);
+  for (auto &replica : m_Replicas)
+    replica->RefreshWeights();
 
+  double loss = 0.0;
+  for (const double l : m_ShardLoss)
+    loss += l;
   return loss;
 }
 
-void MLP_Hardcoded::Forward(const Matrix &X, Matrix &out) {
-  fc1.Forward(X, A1);
-  relu.Forward(A1, H1);
-  fc2.Forward(H1, out);
-}
+HogwildTrainer::HogwildTrainer(Model &model, std::size_t workers)
+    : m_Model(model), m_Shared(model.FlatParameters()) {
+  if (workers == 0)
+    workers = Threading::ThreadPool::Global().size();
 
-double MLP_Hardcoded::Accuracy(const Matrix &X,
-                               const std::vector<uint8_t> &labels) {
-  Forward(X, logits);
-  const auto N = logits.rows();
-  if (N != labels.size() || N == 0)
-    throw std::logic_error("MLP_Hardcoded::Accuracy wrong Matrix size");
+  for (std::size_t k = 0; k < workers; k++) {
+    auto w = std::make_unique<Worker>();
+    w->replica = model.Replica();
+    m_Workers.push_back(std::move(w));
+  }
+  m_Stats.resize(workers);
+}
 
-  std::uint32_t cnt = 0;
-  for (std::size_t i = 0; i < N; i++) {
-    std::size_t pred = ArgmaxRow<float>(logits, i);
-    if (pred == labels[i])
-      cnt++;
+double HogwildTrainer::RunEpoch(const Data::ImageSet &imgs,
+                                const std::vector<uint8_t> &labels,
+                                const std::vector<std::size_t> &order,
+                                std::size_t batch_size, double learning_rate) {
+  if (batch_size == 0 || order.empty())
+    throw std::logic_error("HogwildTrainer: empty epoch");
+
+  m_NextBatch.store(0, std::memory_order_relaxed);
+  for (auto &w : m_Workers) {
+    w->samples.store(0, std::memory_order_relaxed);
+    w->loss_sum = 0.0;
   }
 
-  return static_cast<double>(cnt) / N;
+  Threading::parallel_for(
+      0, m_Workers.size(), 1, [&](std::size_t k0, std::size_t k1) {
+        for (std::size_t k = k0; k < k1; k++)
+          RunWorker(k, imgs, labels, order, batch_size, learning_rate);
+      });
+
+  // Workers wrote the fp32 weights behind the model's 16-bit copy.
+  m_Model.RefreshWeights();
+
+  double loss = 0.0;
+  std::uint64_t steps = 0;
+  for (std::size_t k = 0; k < m_Workers.size(); k++) {
+    loss += m_Workers[k]->loss_sum;
+    steps += m_Stats[k].steps;
+  }
+  return steps == 0 ? 0.0 : loss / static_cast<double>(steps);
 }
 
-TrainModel::TrainModel()
-    : m_RNG(123), m_LearningRate(LEARNING_RATE),
-      m_TrainImgs(load_images_mat("data/train_images.mat", 60000, 28, 28)),
-      m_TrainLabels(load_labels_mat("data/train_labels.mat", 60000)),
-      m_TestImgs(load_images_mat("data/test_images.mat", 10000, 28, 28)),
-      m_TestLabels(load_labels_mat("data/test_labels.mat", 10000)),
-      m_Model(INPUT_LAYER, HIDDEN, OUTPUT_LAYER, m_RNG) {
+void HogwildTrainer::RunWorker(std::size_t k, const Data::ImageSet &imgs,
+                               const std::vector<uint8_t> &labels,
+                               const std::vector<std::size_t> &order,
+                               std::size_t batch_size, double learning_rate) {
+  Worker &w = *m_Workers[k];
+  Model &replica = *w.replica;
+  const auto local = replica.FlatParameters(),
+             grads = replica.FlatGradients();
+  const auto batches = (order.size() + batch_size - 1) / batch_size;
+  const float lr = static_cast<float>(learning_rate);
+
+  WorkerStats stats;
+  const auto start = std::chrono::steady_clock::now();
+
+  std::size_t b;
+  while ((b = m_NextBatch.fetch_add(1, std::memory_order_relaxed)) < batches) {
+    const std::size_t first = b * batch_size,
+                      rows = std::min(batch_size, order.size() - first);
+
+    const std::span<const std::size_t> idx(order.data() + first, rows);
+    imgs.Gather(idx, w.Xb);
+    w.yb.resize(rows);
+    for (std::size_t i = 0; i < rows; i++)
+      w.yb[i] = labels[idx[i]];
+
+    for (std::size_t i = 0; i < local.size(); i++)
+      local[i] =
+          std::atomic_ref<float>(m_Shared[i]).load(std::memory_order_relaxed);
+
+    replica.RefreshWeights();
+    w.loss_sum += replica.ComputeGradients(w.Xb, w.yb);
+
+    for (std::size_t i = 0; i < grads.size(); i++) {
+      std::atomic_ref<float> p(m_Shared[i]);
+      p.store(p.load(std::memory_order_relaxed) - lr * grads[i],
+              std::memory_order_relaxed);
+    }
+
+    stats.steps++;
+    stats.samples += rows;
+    w.samples.fetch_add(rows, std::memory_order_relaxed);
+  }
+
+  const std::chrono::duration<double> dt =
+      std::chrono::steady_clock::now() - start;
+  stats.seconds = dt.count();
+  m_Stats[k] = stats;
+}
 
+TrainModel::TrainModel(TrainOptions options)
+    : m_RNG(123), m_Options(options),
+      m_Model(MakeMLP(INPUT_LAYER, HIDDEN, OUTPUT_LAYER, m_RNG)),
+      m_LearningRate(options.learning_rate > 0.0 ? options.learning_rate
+                                                 : LEARNING_RATE),
+      m_TrainImgs(
+          load_images("data/train_images", 60000, 28, 28, m_TrainImgsFile)),
+      m_TestImgs(
+          load_images("data/test_images", 10000, 28, 28, m_TestImgsFile)),
+      m_TrainLabels(load_labels("data/train_labels", 60000)),
+      m_TestLabels(load_labels("data/test_labels", 10000)) {
+
+  m_Model.SetMathMode(m_Options.math);
+  m_Model.SetOptimizer(m_Options.optimizer);
+  m_Model.SetPrecision(m_Options.precision);
   m_Order.resize(m_TrainImgs.rows());
   std::iota(m_Order.begin(), m_Order.end(), 0);
 
+  if (!m_Options.load.empty()) {
+    const auto t0 = std::chrono::steady_clock::now();
+    m_Loaded = MappedCheckpoint::Open(m_Options.load);
+    m_Loaded.MapInto(m_Model);
+    const std::chrono::duration<double> dt =
+        std::chrono::steady_clock::now() - t0;
+    std::cout << "Mapped " << m_Options.load << " (epoch "
+              << m_Loaded.header().epoch << ") in " << dt.count() * 1e3
+              << " ms\n";
+  } else if (!m_Options.resume.empty()) {
+    const auto file = MappedCheckpoint::Open(m_Options.resume, true);
+    if (!file.RestoreInto(m_Model))
+      std::cerr << "Checkpoint optimizer state is for "
+                << OptimizerName(file.header().optimizer)
+                << ", starting the optimizer afresh\n";
+    const TrainingState state = file.training();
+    m_RNG = state.rng;
+    m_LearningRate = state.learning_rate;
+    m_FirstEpoch = static_cast<std::uint32_t>(state.epoch) + 1;
+    std::cout << "Resuming from " << m_Options.resume << " after epoch "
+              << state.epoch << '\n';
+  }
+
   std::cout << "Train: N=" << m_TrainImgs.rows()
-            << " | Test: N=" << m_TestImgs.rows() << '\n';
+            << " | Test: N=" << m_TestImgs.rows() << " | pixels "
+            << Data::DTypeName(m_TrainImgs.dtype()) << ", "
+            << (m_TrainImgs.size_bytes() + m_TestImgs.size_bytes()) / 1e6
+            << " MB\n";
 }
 
 void TrainModel::run() {
-  Matrix Xb;
-  std::vector<uint8_t> yb;
+  if (!m_Options.load.empty()) {
+    Evaluator evaluator(m_Model, m_TestImgs, m_TestLabels);
+    evaluator.Submit(static_cast<std::uint32_t>(m_Loaded.header().epoch));
+    evaluator.Wait();
+    const EvalReport &report = evaluator.last();
+    std::cout << "test_acc=" << report.accuracy()
+              << " test_loss=" << report.loss << '\n';
+    report_confusion(report);
+    if (m_Options.quantize)
+      report_quantized();
+    if (!m_Options.serve.empty())
+      serve();
+    return;
+  }
 
-  for (std::uint32_t ep = 1; ep <= EPOCHS; ep++) {
-    std::shuffle(m_Order.begin(), m_Order.end(), m_RNG);
+  std::unique_ptr<DataParallelTrainer> data_parallel;
+  std::unique_ptr<HogwildTrainer> hogwild;
+  if (m_Options.mode == TrainMode::DataParallel) {
+    data_parallel =
+        std::make_unique<DataParallelTrainer>(m_Model, m_Options.replicas);
+    std::cout << "Data-parallel training: " << data_parallel->replicas()
+              << " replicas, global batch " << m_Options.batch_size << '\n';
+  } else if (m_Options.mode == TrainMode::Hogwild) {
+    hogwild = std::make_unique<HogwildTrainer>(m_Model, m_Options.replicas);
+    std::cout << "Hogwild training: " << hogwild->workers()
+              << " workers, batch " << m_Options.batch_size << '\n';
+    if (m_Options.optimizer.kind != OptimizerKind::SGD)
+      std::cerr << "--optimizer is ignored by --hogwild, workers apply "
+                   "plain SGD\n";
+  }
+  if (!hogwild && m_Options.optimizer.kind != OptimizerKind::SGD)
+    std::cout << "Optimizer: " << OptimizerName(m_Options.optimizer.kind)
+              << ", lr " << m_LearningRate << '\n';
+  if (m_Options.precision != linalg::Precision::F32)
+    std::cout << "Mixed precision: "
+              << linalg::PrecisionName(m_Options.precision)
+              << " weights and saved activations, fp32 master weights\n";
+  const std::size_t batch_size = m_Options.batch_size;
+
+  // Hogwild workers gather their own batches; the other modes train from a
+  // background loader that shuffles and assembles the next batch while the
+  // current one is in flight. Every epoch's order is drawn from m_RNG,
+  // which checkpoints save, so a resumed run sees the same batches as an
+  // uninterrupted one.
+  std::unique_ptr<Data::BatchPipeline> loader;
+  if (!hogwild)
+    loader = std::make_unique<Data::BatchPipeline>(
+        m_TrainImgs, m_TrainLabels, batch_size, 0, m_Options.prefetch,
+        m_Options.augment ? Data::RandomShift(28, 28, 2)
+                          : Data::BatchPipeline::Augment{});
+
+  // Saves run in the background; training only waits for the snapshot.
+  CheckpointWriter checkpoints;
+  // So do test-set evaluations, which overlap the next epoch.
+  Evaluator evaluator(m_Model, m_TestImgs, m_TestLabels,
+                      [this](const EvalReport &r) { report_evaluation(r); });
+
+  for (std::uint32_t ep = m_FirstEpoch; ep <= EPOCHS; ep++) {
+    const auto epoch_start = std::chrono::steady_clock::now();
 
     double loss_acc = 0.0;
     std::size_t steps = 0;
 
-    for (std::size_t start = 0; start < m_Order.size(); start += BATCH_SIZE) {
-      make_batch(m_TrainImgs, m_TrainLabels, m_Order, start, BATCH_SIZE, Xb,
-                 yb);
+    if (hogwild) {
+      std::iota(m_Order.begin(), m_Order.end(), 0);
+      std::shuffle(m_Order.begin(), m_Order.end(), m_RNG);
+      loss_acc = hogwild->RunEpoch(m_TrainImgs, m_TrainLabels, m_Order,
+                                   batch_size, m_LearningRate);
+      steps = 1;
+    } else {
+      loader->BeginEpoch(m_RNG());
+      while (const auto *batch = loader->Next()) {
+        const double loss =
+            data_parallel
+                ? data_parallel->TrainStep(batch->X, batch->y, m_LearningRate)
+                : m_Model.TrainStep(batch->X, batch->y, m_LearningRate);
+        loss_acc += loss;
+        steps++;
+
+        if (steps % 500 == 0)
+          show_prediction(m_Model, m_TrainImgs, m_TrainLabels,
+                          batch->indices.front());
+      }
+    }
 
-      const double loss = m_Model.TrainStep(Xb, yb, m_LearningRate);
-      loss_acc += loss;
-      steps++;
+    const std::chrono::duration<double> epoch_time =
+        std::chrono::steady_clock::now() - epoch_start;
 
-      if (steps % 500 == 0)
-        show_prediction(m_Model, m_TrainImgs, m_TrainLabels, m_Order[start]);
+    const double mean_loss = (steps == 0) ? 0.0f : loss_acc / steps;
+
+    {
+      std::lock_guard lock(m_OutputMutex);
+      std::cout << "Epoch " << ep << " done | lr=" << m_LearningRate
+                << " mean_loss=" << mean_loss
+                << " time=" << epoch_time.count() << "s";
+      if (loader)
+        std::cout << " loader_stall=" << loader->StallSeconds() << "s";
+      std::cout << '\n';
+
+      if (hogwild) {
+        std::cout << "  samples/s per worker:";
+        for (const auto &stats : hogwild->Stats())
+          std::cout << ' '
+                    << static_cast<std::uint64_t>(stats.samples_per_second());
+        std::cout << '\n';
+      }
     }
+    evaluator.Submit(ep);
 
-    std::uint32_t correct = 0, total = 0;
-    Matrix Xt, logits;
-    std::vector<uint8_t> yt;
+    m_LearningRate *= LEARNING_RATE_DECAY;
+    if (!m_Options.checkpoint.empty())
+      checkpoints.Save(m_Options.checkpoint, m_Model,
+                       {ep, m_LearningRate, m_RNG});
+  }
 
-    for (std::size_t start = 0; start < m_TestImgs.rows();
-         start += BATCH_SIZE) {
-      const auto end = std::min(start + BATCH_SIZE, m_TestImgs.rows());
+  if (evaluator.evaluations()) {
+    evaluator.Wait();
+    report_confusion(evaluator.last());
+    std::cout << "Evaluation: " << evaluator.evaluations()
+              << " epochs scored alongside training, which blocked "
+              << evaluator.BlockedSeconds() / evaluator.evaluations() * 1e3
+              << " ms per snapshot\n";
+  }
 
-      std::vector<std::size_t> test_idx(end - start);
-      iota(test_idx.begin(), test_idx.end(), start);
+  if (checkpoints.saves()) {
+    checkpoints.Wait();
+    std::cout << "Checkpoints: " << checkpoints.saves() << " saved to "
+              << m_Options.checkpoint << ", training blocked "
+              << checkpoints.BlockedSeconds() / checkpoints.saves() * 1e3
+              << " ms per save\n";
+  }
 
-      make_batch(m_TestImgs, m_TestLabels, test_idx, 0, test_idx.size(), Xt,
-                 yt);
+  if (m_Options.quantize)
+    report_quantized();
+  if (!m_Options.serve.empty())
+    serve();
+}
 
-      m_Model.Forward(Xt, logits);
+void TrainModel::report_evaluation(const EvalReport &report) {
+  std::lock_guard lock(m_OutputMutex);
+  std::cout << "Epoch " << report.epoch << " test | test_acc="
+            << report.accuracy() << " test_loss=" << report.loss
+            << " time=" << report.seconds << "s\n";
+}
 
-      for (std::size_t i = 0; i < logits.rows(); i++) {
-        const std::size_t pred = Logos::NeuralNet::ArgmaxRow<float>(logits, i);
-        if (pred == yt[i])
-          correct++;
-        total++;
-      }
+void TrainModel::report_confusion(const EvalReport &report) {
+  std::lock_guard lock(m_OutputMutex);
+  const std::size_t C = report.classes;
+  std::printf("Confusion on the test set (rows: label, columns: predicted)\n"
+              "     ");
+  for (std::size_t p = 0; p < C; p++)
+    std::printf(" %5zu", p);
+  std::printf("  recall\n");
+  for (std::size_t l = 0; l < C; l++) {
+    std::uint32_t total = 0;
+    std::printf("  %2zu:", l);
+    for (std::size_t p = 0; p < C; p++) {
+      std::printf(" %5u", report.count(l, p));
+      total += report.count(l, p);
     }
+    std::printf("  %6.4f\n",
+                total ? static_cast<double>(report.count(l, l)) / total : 0.0);
+  }
+  std::fflush(stdout);
+}
 
-    const double test_acc =
-        (total == 0) ? 0.0f : static_cast<float>(correct) / total;
-    const double mean_loss = (steps == 0) ? 0.0f : loss_acc / steps;
+void TrainModel::report_quantized() {
+  using Clock = std::chrono::steady_clock;
+  // Best of a few runs, in seconds.
+  auto time = [](auto &&fn) {
+    double best = 1e30;
+    for (int r = 0; r < 3; r++) {
+      const auto t0 = Clock::now();
+      fn();
+      const std::chrono::duration<double> dt = Clock::now() - t0;
+      best = std::min(best, dt.count());
+    }
+    return best;
+  };
+
+  const std::size_t calib_rows =
+      std::min<std::size_t>(CALIBRATION_ROWS, m_TrainImgs.rows());
+  Matrix calib_scratch, test_scratch;
+  QuantizedMLP quantized(
+      m_Model, m_TrainImgs.Slice(m_TrainImgs.rows() - calib_rows, calib_rows,
+                                 calib_scratch));
+
+  const std::size_t N = m_TestImgs.rows();
+  const auto X = m_TestImgs.Slice(0, N, test_scratch);
+  double fp32_acc = 0.0, int8_acc = 0.0;
+  const double fp32_batch =
+      time([&] { fp32_acc = m_Model.Accuracy(X, m_TestLabels); });
+  const double int8_batch =
+      time([&] { int8_acc = quantized.Accuracy(X, m_TestLabels); });
+
+  // One row at a time, as a server answering single requests would.
+  const std::size_t single = std::min<std::size_t>(1000, N);
+  Matrix logits;
+  const double fp32_row = time([&] {
+    for (std::size_t i = 0; i < single; i++)
+      m_Model.Forward(X.row_range(i, 1), logits);
+  });
+  const double int8_row = time([&] {
+    for (std::size_t i = 0; i < single; i++)
+      quantized.Forward(X.row_range(i, 1), logits);
+  });
+
+  std::cout << "Int8 (calibrated on " << calib_rows
+            << " training images, activations 0.." << quantized.ActMax()
+            << "): test_acc=" << int8_acc
+            << " fp32=" << fp32_acc << " delta=" << int8_acc - fp32_acc
+            << '\n'
+            << "  batch " << N << ": fp32 " << fp32_batch * 1e3 << " ms, int8 "
+            << int8_batch * 1e3 << " ms (" << fp32_batch / int8_batch
+            << "x) | batch 1: fp32 " << fp32_row / single * 1e6
+            << " us, int8 " << int8_row / single * 1e6 << " us ("
+            << fp32_row / int8_row << "x)\n";
+}
 
-    std::cout << "Epoch " << ep << " done | lr=" << m_LearningRate
-              << " mean_loss=" << mean_loss << " test_acc=" << test_acc << '\n';
+void TrainModel::serve() {
+  Serving::InferenceServer engine(m_Model);
+  Serving::SocketServer front(engine, m_Options.serve);
+  std::cout << "Serving on " << front.path() << " (batch "
+            << engine.options().max_batch << ", "
+            << engine.options().max_delay.count()
+            << " us), end of input stops\n";
+  std::cin.ignore(std::numeric_limits<std::streamsize>::max());
+  front.Stop();
+
+  const auto stats = engine.stats();
+  std::cout << "Served " << stats.requests << " requests over "
+            << front.connections() << " connections, mean batch "
+            << stats.mean_batch() << '\n';
+}
 
-    m_LearningRate *= LEARNING_RATE_DECAY;
+Data::ImageSet TrainModel::load_images(const std::string &base,
+                                       std::size_t num, std::size_t rows,
+                                       std::size_t cols,
+                                       Data::MappedTensor &file) {
+  const std::string path = base + ".lgt";
+  if (!std::filesystem::exists(path)) {
+    if (m_Options.normalize)
+      std::cerr << "--normalize needs uint8 .lgt data, ignored for " << base
+                << ".mat\n";
+    return Data::ImageSet(load_images_mat(base + ".mat", num, rows, cols));
+  }
+
+  file = Data::MappedTensor::Open(path, m_Options.verify_data);
+  if (file.rows() != num || file.cols() != rows * cols)
+    throw std::runtime_error("Unexpected shape: " + path);
+
+  if (file.dtype() == Data::DType::U8) {
+    // Training-set statistics of MNIST in [0, 1] units.
+    const auto transform = m_Options.normalize
+                               ? Data::PixelTransform::Normalize(0.1307f, 0.3081f)
+                               : Data::PixelTransform{};
+    return Data::ImageSet(file.AsMatrix<std::uint8_t>(), transform);
   }
+  if (m_Options.normalize)
+    std::cerr << "--normalize needs uint8 .lgt data, ignored for " << path
+              << '\n';
+  return Data::ImageSet(file.AsMatrix<float>());
+}
+
+std::vector<uint8_t> TrainModel::load_labels(const std::string &base,
+                                             std::size_t num) {
+  const std::string path = base + ".lgt";
+  if (!std::filesystem::exists(path))
+    return load_labels_mat(base + ".mat", num);
+
+  const auto file = Data::MappedTensor::Open(path, m_Options.verify_data);
+  if (file.rows() * file.cols() != num)
+    throw std::runtime_error("Unexpected shape: " + path);
+  const auto *labels = file.data<std::uint8_t>();
+  return std::vector<std::uint8_t>(labels, labels + num);
 }
 
 Matrix TrainModel::load_images_mat(std::string path, std::size_t num,
@@ -176,43 +543,16 @@ std::vector<uint8_t> TrainModel::load_labels_mat(std::string path,
   return labels;
 }
 
-void TrainModel::make_batch(const Matrix &imgs,
-                            const std::vector<std::uint8_t> &labels,
-                            const std::vector<std::size_t> &indices,
-                            std::size_t start, std::size_t batch_size,
-                            Matrix &Xb, std::vector<std::uint8_t> &yb) {
-
-  const auto D = imgs.cols(), N = indices.size(),
-             end = std::min(start + static_cast<std::size_t>(batch_size), N),
-             B = end - start;
-
-  if (B == 0)
-    throw std::logic_error("make_batch: empty batch");
-
-  if (Xb.rows() != B || Xb.cols() != D)
-    Xb = Matrix(B, D);
-
-  yb.resize(B);
-  for (std::size_t i = 0; i < B; i++) {
-    const auto idx = indices[start + i];
-    yb[i] = labels[idx];
-
-    for (std::size_t j = 0; j < D; j++)
-      Xb(i, j) = imgs(idx, j);
-  }
-}
-
-void TrainModel::show_prediction(NeuralNetwork &model, const Matrix &imgs,
+void TrainModel::show_prediction(Model &model,
+                                 const Data::ImageSet &imgs,
                                  const std::vector<uint8_t> &labels,
                                  std::size_t idx) {
+  std::lock_guard lock(m_OutputMutex);
   std::vector<float> img = get_mnist_image(imgs, idx);
   draw_mnist_digit(img);
 
-  const auto D = imgs.cols();
-  Matrix X(1, D);
-
-  for (std::size_t j = 0; j < D; j++)
-    X(0, j) = img[j];
+  Matrix X(1, imgs.cols());
+  imgs.Row(idx, X.data());
 
   Matrix logits;
   model.Forward(X, logits);
@@ -233,13 +573,19 @@ void TrainModel::draw_mnist_digit(const std::vector<float> &data) {
   std::printf("\x1b[0m");
 }
 
-std::vector<float> TrainModel::get_mnist_image(const Matrix &imgs,
+std::vector<float> TrainModel::get_mnist_image(const Data::ImageSet &imgs,
                                                std::size_t idx) {
-  const auto D = imgs.cols();
-  std::vector<float> out(D);
-
-  for (std::size_t j = 0; j < D; j++)
-    out[j] = std::clamp(imgs(idx, j), 0.0f, 1.0f);
+  std::vector<float> out(imgs.cols());
+  imgs.Row(idx, out.data());
+
+  // Undo the normalisation of u8 sets so the digit renders the same way.
+  if (imgs.dtype() == Data::DType::U8) {
+    const auto &t = imgs.transform();
+    for (auto &v : out)
+      v = (v - t.shift) / (255.0f * t.scale);
+  }
+  for (auto &v : out)
+    v = std::clamp(v, 0.0f, 1.0f);
   return out;
 }
 
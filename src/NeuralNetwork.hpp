@@ -1,71 +1,221 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <cstdio>
+#include <memory>
+#include <mutex>
 #include <random>
+#include <span>
 #include <string>
 #include <vector>
 
-#include "Linear.hpp"
-#include "ReLU.hpp"
+#include "Checkpoint.hpp"
+#include "Data/ImageSet.hpp"
+#include "Data/TensorFile.hpp"
+#include "Evaluator.hpp"
+#include "Functions.hpp"
+#include "Sequential.hpp"
 
 namespace Logos::NeuralNet {
 using Matrix = linalg::Matrix<float>;
+using ConstMatrixView = linalg::ConstMatrixView<float>;
+using Labels = std::span<const std::uint8_t>;
+
+// The classifier the trainers below work on.
+using Model = Sequential<float>;
+
+// in -> hidden -> ReLU -> classes; Build() fuses the hidden layer and its
+// ReLU into one LinearReLU.
+Model MakeMLP(std::size_t in_dim, std::size_t hidden_dim,
+              std::size_t num_classes, std::mt19937 &rng);
+
+// Synchronous data parallelism. Each global batch is split row-wise over K
+// model replicas that run forward/backward concurrently on the thread pool.
+// Their gradients, weighted by shard size, are tree-reduced into the master
+// model, which takes one SGD step and broadcasts the new weights back. For
+// the same global batch this is the single-threaded step up to float
+// summation order.
+class DataParallelTrainer {
+public:
+  // replicas == 0 uses one replica per pool thread. Replica 0 is `model`.
+  DataParallelTrainer(Model &model, std::size_t replicas = 0);
+
+  double TrainStep(ConstMatrixView X, Labels labels, double learning_rate);
+
+  std::size_t replicas() const noexcept { return m_Replicas.size() + 1; }
+
+private:
+  Model &Replica(std::size_t k) {
+    return k == 0 ? m_Model : *m_Replicas[k - 1];
+  }
+
+  Model &m_Model;
+  std::vector<std::unique_ptr<Model>> m_Replicas;
 
-class MLP_Hardcoded {
+  std::vector<double> m_ShardLoss;
+
+  // Flat gradient and parameter arenas of each replica; all replicas share
+  // one layout, so a single reduce and broadcast cover the whole model.
+  std::vector<float *> m_GradPtrs, m_ParamPtrs;
+  std::size_t m_FlatSize = 0;
+};
+
+// Asynchronous lock-free SGD (Hogwild!). Workers pull batches from a shared
+// cursor over the epoch order and run forward/backward on a private replica
+// whose weights are refreshed from the shared model before every batch. The
+// update is written straight into the shared weights.
+//
+// Shared parameters are only touched through relaxed atomics, so there are
+// no locks and no torn floats. Concurrent updates to one weight can still
+// overwrite each other, and a replica may see a mix of old and new weights.
+// That is the accepted Hogwild trade: runs are not reproducible, but nothing
+// on the critical path synchronises.
+class HogwildTrainer {
 public:
-  MLP_Hardcoded() = default;
-  MLP_Hardcoded(std::size_t in_dim, std::size_t hidden_dim,
-                std::size_t num_classes, std::mt19937 &rng);
+  struct WorkerStats {
+    std::uint64_t samples = 0, steps = 0;
+    double seconds = 0.0;
+
+    double samples_per_second() const {
+      return seconds > 0.0 ? static_cast<double>(samples) / seconds : 0.0;
+    }
+  };
+
+  // workers == 0 uses one worker per pool thread.
+  HogwildTrainer(Model &model, std::size_t workers = 0);
 
-  double TrainStep(const Matrix &X, const std::vector<uint8_t> &labels,
-                   double learning_rate);
-  void Forward(const Matrix &X, Matrix &out);
-  double Accuracy(const Matrix &X, const std::vector<uint8_t> &labels);
+  // One pass over `order` in batches of batch_size; returns the mean loss.
+  double RunEpoch(const Data::ImageSet &imgs,
+                  const std::vector<uint8_t> &labels,
+                  const std::vector<std::size_t> &order,
+                  std::size_t batch_size, double learning_rate);
+
+  std::size_t workers() const noexcept { return m_Workers.size(); }
+
+  // Live per-worker sample counter, safe to poll during RunEpoch.
+  std::uint64_t SamplesProcessed(std::size_t worker) const noexcept {
+    return m_Workers[worker]->samples.load(std::memory_order_relaxed);
+  }
+  // Per-worker totals of the last RunEpoch.
+  const std::vector<WorkerStats> &Stats() const noexcept { return m_Stats; }
 
 private:
-  Linear<float> fc1, fc2;
-  ReLU<float> relu;
+  struct alignas(64) Worker {
+    std::unique_ptr<Model> replica;
+    Matrix Xb;
+    std::vector<uint8_t> yb;
+    std::atomic<std::uint64_t> samples{0};
+    double loss_sum = 0.0;
+  };
+
+  void RunWorker(std::size_t k, const Data::ImageSet &imgs,
+                 const std::vector<uint8_t> &labels,
+                 const std::vector<std::size_t> &order, std::size_t batch_size,
+                 double learning_rate);
+
+  Model &m_Model;
+  std::span<float> m_Shared; // m_Model's flat parameters
+  std::vector<std::unique_ptr<Worker>> m_Workers;
+  std::vector<WorkerStats> m_Stats;
+  std::atomic<std::size_t> m_NextBatch{0};
+};
 
-  Matrix A1, H1, logits, dA1, dH1, dLogits, dX;
+enum class TrainMode : std::uint8_t { Serial = 0, DataParallel, Hogwild };
+
+struct TrainOptions {
+  TrainMode mode = TrainMode::Serial;
+  std::size_t batch_size = 64; // rows per SGD step, split over replicas
+  std::size_t replicas = 0;    // replicas/workers, 0: one per pool thread
+  std::size_t prefetch = 2;    // batches in flight in the loader pipeline
+  bool augment = false;        // random +-2 pixel shifts on training batches
+  bool verify_data = false;    // CRC-check mapped .lgt datasets on load
+  bool normalize = false;      // MNIST mean/std normalisation of u8 pixels
+  // exp/log precision of the softmax cross-entropy
+  MathMode math = MathMode::Accurate;
+  // update rule of the serial and data-parallel modes; Hogwild workers
+  // always apply plain SGD
+  OptimizerOptions optimizer;
+  double learning_rate = 0.0; // initial rate, 0: TrainModel's default
+  // storage of the weights the GEMMs read and of saved activations
+  linalg::Precision precision = linalg::Precision::F32;
+  // after training, compare an int8 copy of the model (QuantizedMLP) with
+  // it on the test set
+  bool quantize = false;
+  // written after every epoch, on a background thread
+  std::string checkpoint;
+  // training continues from this checkpoint: weights, optimizer state,
+  // epoch, learning rate and RNG
+  std::string resume;
+  // evaluates the mapped weights of this checkpoint instead of training
+  std::string load;
+  // after training or --load, answers inference requests on this Unix
+  // socket (Serving::SocketServer) until stdin closes
+  std::string serve;
 };
 
 class TrainModel {
 public:
-  using NeuralNetwork = MLP_Hardcoded;
-
-  TrainModel();
+  explicit TrainModel(TrainOptions options = {});
   void run();
 
 private:
   static constexpr std::uint32_t INPUT_LAYER = 784, HIDDEN = 256,
                                  OUTPUT_LAYER = 10, BATCH_SIZE = 64,
-                                 EPOCHS = 10;
+                                 EPOCHS = 10, CALIBRATION_ROWS = 1000;
   static constexpr double LEARNING_RATE = 0.05f, LEARNING_RATE_DECAY = 0.95f;
 
-  NeuralNetwork m_Model;
+  // Declared first: m_Model draws its initial weights from it.
+  std::mt19937 m_RNG;
+  TrainOptions m_Options;
+
+  // --load: the mapped checkpoint m_Model's parameters live in.
+  MappedCheckpoint m_Loaded;
+  Model m_Model;
   double m_LearningRate;
+  std::uint32_t m_FirstEpoch = 1;
 
-  Matrix m_TrainImgs, m_TestImgs;
+  // Mapped .lgt datasets; m_TrainImgs/m_TestImgs are views into them when
+  // present.
+  Data::MappedTensor m_TrainImgsFile, m_TestImgsFile;
+  Data::ImageSet m_TrainImgs, m_TestImgs;
   std::vector<uint8_t> m_TrainLabels, m_TestLabels;
 
-  std::mt19937 m_RNG;
   std::vector<std::size_t> m_Order;
 
+  // Held while printing: evaluation reports come from another thread.
+  std::mutex m_OutputMutex;
+
+  // Load `<base>.lgt` when it exists, otherwise the raw `<base>.mat`.
+  Data::ImageSet load_images(const std::string &base, std::size_t num,
+                             std::size_t rows, std::size_t cols,
+                             Data::MappedTensor &file);
+  std::vector<std::uint8_t> load_labels(const std::string &base,
+                                        std::size_t num);
+
   Matrix load_images_mat(std::string path, std::size_t num, std::size_t rows,
                          std::size_t cols);
   std::vector<std::uint8_t> load_labels_mat(std::string path, std::size_t num);
 
-  void make_batch(const Matrix &imgs, const std::vector<std::uint8_t> &labels,
-                  const std::vector<std::size_t> &indices, std::size_t start,
-                  std::size_t batch_size, Matrix &Xb,
-                  std::vector<std::uint8_t> &yb);
+  // Evaluator callback: the test scores of one epoch. Runs on the
+  // evaluator's thread.
+  void report_evaluation(const EvalReport &report);
+  // Confusion counts with per-class recall.
+  void report_confusion(const EvalReport &report);
+
+  // Quantises the trained model, calibrated on the last CALIBRATION_ROWS
+  // training images, and reports test accuracy and latency of both.
+  void report_quantized();
+
+  // Serves m_Model on m_Options.serve until end of input.
+  void serve();
 
-  void show_prediction(NeuralNetwork &model, const Matrix &imgs,
+  void show_prediction(Model &model, const Data::ImageSet &imgs,
                        const std::vector<std::uint8_t> &labels,
                        std::size_t idx);
   void draw_mnist_digit(const std::vector<float> &data);
-  std::vector<float> get_mnist_image(const Matrix &imgs, std::size_t idx);
+  std::vector<float> get_mnist_image(const Data::ImageSet &imgs,
+                                     std::size_t idx);
 };
 
 } // namespace Logos::NeuralNet
@@ -0,0 +1,138 @@
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "Kernels/Simd.hpp"
+#include "Memory/MemoryUtility.hpp"
+#include "Optimizer.hpp"
+#include "Threading/ThreadPool.hpp"
+
+namespace Logos::NeuralNet {
+
+namespace {
+// Floats per cache line; each tensor's state slice starts on one.
+constexpr std::size_t LINE = Memory::DEFAULT_ALIGNMENT / sizeof(float);
+
+std::size_t StateSlots(OptimizerKind kind) {
+  switch (kind) {
+  case OptimizerKind::SGD:
+    return 0;
+  case OptimizerKind::Momentum:
+  case OptimizerKind::Nesterov:
+    return 1;
+  default:
+    return 2;
+  }
+}
+} // namespace
+
+Optimizer::Optimizer(std::vector<std::span<float>> params,
+                     std::vector<std::span<float>> grads,
+                     OptimizerOptions options)
+    : m_Options(options) {
+  if (params.size() != grads.size())
+    throw std::logic_error("Optimizer: parameter/gradient count mismatch");
+
+  std::size_t stride = 0;
+  for (std::size_t t = 0; t < params.size(); t++) {
+    if (params[t].size() != grads[t].size())
+      throw std::logic_error("Optimizer: parameter/gradient size mismatch");
+    m_Tensors.push_back({params[t].data(), grads[t].data(), nullptr, nullptr,
+                         params[t].size()});
+    stride += Memory::AlignUp(params[t].size(), LINE);
+  }
+
+  const std::size_t slots = StateSlots(options.kind);
+  if (slots == 0)
+    return;
+  m_State = Memory::Buffer(slots * stride * sizeof(float));
+
+  float *base = static_cast<float *>(m_State.data());
+  std::size_t offset = 0;
+  for (auto &t : m_Tensors) {
+    t.m = base + offset;
+    if (slots == 2)
+      t.v = base + stride + offset;
+    offset += Memory::AlignUp(t.n, LINE);
+  }
+  Reset();
+}
+
+void Optimizer::Reset() {
+  if (m_State.data())
+    std::memset(m_State.data(), 0, m_State.size_bytes());
+  m_Steps = 0;
+}
+
+void Optimizer::Restore(std::span<const float> state, std::uint64_t steps) {
+  if (state.size() * sizeof(float) != m_State.size_bytes())
+    throw std::logic_error("Optimizer::Restore: state size mismatch");
+  if (!state.empty())
+    std::memcpy(m_State.data(), state.data(), m_State.size_bytes());
+  m_Steps = steps;
+}
+
+void Optimizer::Step(double learning_rate) {
+  m_Steps++;
+  const auto &k = linalg::simd::Kernels();
+  const float lr = static_cast<float>(learning_rate);
+
+  // Parameter tensors are updated one after another, each split over the
+  // pool in chunks.
+  auto each = [&](auto &&update) {
+    for (const Tensor &t : m_Tensors)
+      Threading::parallel_for(0, t.n, Threading::GrainFor(1),
+                              [&](std::size_t b, std::size_t e) {
+                                update(t, b, e - b);
+                              });
+  };
+
+  if (StateSlots(m_Options.kind) < 2) {
+    linalg::simd::SgdStep s;
+    s.lr = lr;
+    s.weight_decay = m_Options.weight_decay;
+    s.momentum = m_Options.momentum;
+    s.nesterov = m_Options.kind == OptimizerKind::Nesterov;
+    each([&](const Tensor &t, std::size_t b, std::size_t n) {
+      k.sgd_step(t.w + b, t.g + b, t.m ? t.m + b : nullptr, n, s);
+    });
+    return;
+  }
+
+  // Bias corrections of the moment estimates, folded into the step size
+  // and the scale of sqrt(v).
+  const double steps = static_cast<double>(m_Steps);
+  const double c1 = 1.0 - std::pow(m_Options.beta1, steps),
+               c2 = 1.0 - std::pow(m_Options.beta2, steps);
+
+  linalg::simd::AdamStep s;
+  s.beta1 = m_Options.beta1;
+  s.beta2 = m_Options.beta2;
+  s.eps = m_Options.eps;
+  s.step = static_cast<float>(learning_rate / c1);
+  s.rsqrt_bias2 = static_cast<float>(1.0 / std::sqrt(c2));
+  if (m_Options.kind == OptimizerKind::AdamW)
+    s.shrink = static_cast<float>(1.0 - learning_rate * m_Options.weight_decay);
+  else
+    s.l2 = m_Options.weight_decay;
+  each([&](const Tensor &t, std::size_t b, std::size_t n) {
+    k.adam_step(t.w + b, t.g + b, t.m + b, t.v + b, n, s);
+  });
+}
+
+const char *OptimizerName(OptimizerKind kind) {
+  switch (kind) {
+  case OptimizerKind::SGD:
+    return "sgd";
+  case OptimizerKind::Momentum:
+    return "momentum";
+  case OptimizerKind::Nesterov:
+    return "nesterov";
+  case OptimizerKind::Adam:
+    return "adam";
+  case OptimizerKind::AdamW:
+    return "adamw";
+  }
+  return "?";
+}
+} // namespace Logos::NeuralNet
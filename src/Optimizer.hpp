@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Memory/Buffer.hpp"
+
+namespace Logos::NeuralNet {
+
+enum class OptimizerKind : std::uint8_t {
+  SGD = 0,
+  Momentum, // heavy-ball momentum
+  Nesterov,
+  Adam,
+  AdamW // Adam with weight decay decoupled from the gradient
+};
+
+struct OptimizerOptions {
+  OptimizerKind kind = OptimizerKind::SGD;
+  float momentum = 0.9f;                           // Momentum, Nesterov
+  float beta1 = 0.9f, beta2 = 0.999f, eps = 1e-8f; // Adam, AdamW
+  // Added to the gradient as weight_decay * w, except for AdamW, which
+  // shrinks the weights by learning_rate * weight_decay instead.
+  float weight_decay = 0.0f;
+};
+
+// Updates a set of parameter tensors from their gradients. Each Step is one
+// pass of a fused SIMD kernel (KernelTable::sgd_step/adam_step) per tensor
+// that applies weight decay, updates the optimizer state and the weights,
+// and zeroes the gradient, so no separate ZeroGrads pass is needed.
+//
+// Momentum and moment buffers live in one aligned allocation laid out like
+// the parameter list: per state kind, tensor t's slice follows tensor
+// t - 1's, each starting on a cache line.
+class Optimizer {
+public:
+  // params[t] and grads[t] must have the same size and stay valid for the
+  // optimizer's lifetime.
+  Optimizer(std::vector<std::span<float>> params,
+            std::vector<std::span<float>> grads, OptimizerOptions options = {});
+
+  // One update at `learning_rate`; the schedule is the caller's.
+  void Step(double learning_rate);
+
+  // Back to the first step with zeroed state, e.g. after new weights have
+  // been loaded.
+  void Reset();
+
+  const OptimizerOptions &options() const noexcept { return m_Options; }
+  std::uint64_t steps() const noexcept { return m_Steps; }
+  std::size_t StateBytes() const noexcept { return m_State.size_bytes(); }
+
+  // The whole momentum/moment allocation, padding included, e.g. for a
+  // checkpoint. Empty for SGD.
+  std::span<const float> state() const noexcept {
+    return {static_cast<const float *>(m_State.data()),
+            m_State.size_bytes() / sizeof(float)};
+  }
+  // Continues from a saved state() and step count of an optimizer of the
+  // same kind over the same tensors.
+  void Restore(std::span<const float> state, std::uint64_t steps);
+
+private:
+  struct Tensor {
+    float *w, *g;
+    float *m = nullptr, *v = nullptr; // first moment/velocity, second moment
+    std::size_t n;
+  };
+
+  OptimizerOptions m_Options;
+  std::vector<Tensor> m_Tensors;
+  Memory::Buffer m_State;
+  std::uint64_t m_Steps = 0;
+};
+
+const char *OptimizerName(OptimizerKind kind);
+} // namespace Logos::NeuralNet
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include "Memory/Buffer.hpp"
+#include "Memory/MemoryUtility.hpp"
+
+namespace Logos::NeuralNet {
+// All parameter tensors of a model in one aligned Buffer and their
+// gradients, at the same offsets, in a second one. Tensor t starts on a
+// cache line right after tensor t - 1; the padding between tensors is
+// zero and stays zero under every optimizer update, so whole-model passes
+// (optimizer step, gradient all-reduce, clearing, checkpoint I/O) can run
+// over flat_params()/flat_grads() as a single range.
+template <class T> class ParameterArena {
+public:
+  ParameterArena() = default;
+  // One zero-initialised tensor of each size.
+  explicit ParameterArena(std::span<const std::size_t> sizes) {
+    constexpr std::size_t line = Memory::DEFAULT_ALIGNMENT / sizeof(T);
+    for (const std::size_t n : sizes) {
+      m_Offsets.push_back(m_Total);
+      m_Sizes.push_back(n);
+      m_Total += Memory::AlignUp(n, line);
+    }
+    m_Params = Memory::Buffer(m_Total * sizeof(T));
+    m_Grads = Memory::Buffer(m_Total * sizeof(T));
+    if (m_Total) {
+      std::memset(m_Params.data(), 0, m_Total * sizeof(T));
+      std::memset(m_Grads.data(), 0, m_Total * sizeof(T));
+    }
+  }
+
+  std::size_t tensors() const noexcept { return m_Sizes.size(); }
+
+  std::span<T> param(std::size_t t) noexcept {
+    return {Base(m_Params) + m_Offsets[t], m_Sizes[t]};
+  }
+  std::span<T> grad(std::size_t t) noexcept {
+    return {Base(m_Grads) + m_Offsets[t], m_Sizes[t]};
+  }
+
+  // Parameters from now on live in `params`, flat_params().size() elements
+  // in this layout (e.g. a mapped checkpoint), which must outlive the
+  // arena. Nothing is copied; gradients keep their buffer.
+  void Adopt(T *params) {
+    m_Params = Memory::Buffer::Wrap(params, m_Total * sizeof(T));
+  }
+
+  // Every tensor with its padding.
+  std::span<T> flat_params() noexcept { return {Base(m_Params), m_Total}; }
+  std::span<T> flat_grads() noexcept { return {Base(m_Grads), m_Total}; }
+
+private:
+  static T *Base(Memory::Buffer &b) noexcept {
+    return static_cast<T *>(b.data());
+  }
+
+  Memory::Buffer m_Params, m_Grads;
+  std::vector<std::size_t> m_Offsets, m_Sizes;
+  std::size_t m_Total = 0;
+};
+} // namespace Logos::NeuralNet
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Functions.hpp"
+#include "Kernels.hpp"
+#include "Kernels/QGemm.hpp"
+#include "Sequential.hpp"
+
+namespace Logos::NeuralNet {
+// Int8 inference copy of a trained Sequential made of Linear layers, each
+// optionally followed by a ReLU (post-training quantisation, see
+// Kernels/QGemm.hpp). The constructor runs the float model over a
+// calibration batch, records the range of every layer's input, and
+// quantises the weights per output channel. At inference each layer is one
+// int8 GEMM whose epilogue applies the scales, the bias and the ReLU and
+// requantises straight into the next layer's input; only the last layer
+// writes float logits.
+//
+// Calibrate on data the model will see but not on the evaluation set, a
+// few hundred to a few thousand rows; ranges come from the extremes, so an
+// outlier there costs resolution everywhere.
+//
+// Activations use codes 0..act_max, by default the widest the current SIMD
+// tier's int8 GEMM takes: all 8 bits with VNNI or on the scalar tier, 7
+// where it goes through pmaddubsw. A model calibrated for 8 bits cannot run
+// on a 7-bit tier; Forward throws.
+class QuantizedMLP {
+public:
+  QuantizedMLP(Sequential<float> &model,
+               linalg::ConstMatrixView<float> calibration,
+               std::int32_t act_max = linalg::simd::Kernels().qgemm_act_max()) {
+    const auto dense = model.DenseLayers();
+    if (calibration.rows() == 0 || calibration.cols() != model.InputDim())
+      throw std::logic_error("QuantizedMLP: bad calibration set");
+    if (act_max <= 0 || act_max > linalg::simd::QGEMM_ACT_MAX)
+      throw std::logic_error("QuantizedMLP: bad activation range");
+    m_ActMax = act_max;
+
+    // Float forward over the calibration rows, one layer at a time.
+    linalg::Matrix<float> H, next;
+    linalg::ConstMatrixView<float> in = calibration;
+    for (std::size_t l = 0; l < dense.size(); l++) {
+      const auto &d = dense[l];
+      const auto [lo, hi] = Range(in);
+      Layer layer;
+      layer.weights = linalg::QuantizedWeights(d.weights);
+      layer.in = linalg::QuantParams::FromRange(lo, hi, act_max);
+      layer.relu = d.relu;
+      layer.out = d.weights.cols();
+
+      // acc * s_in s_j, with the input zero point moved into the bias.
+      const auto s = layer.weights.scale();
+      const auto sums = layer.weights.col_sums();
+      for (std::size_t j = 0; j < layer.out; j++) {
+        const float scale = layer.in.scale * s[j];
+        layer.scale.push_back(scale);
+        const auto shift = static_cast<float>(layer.in.zero * sums[j]);
+        layer.bias.push_back(d.bias[j] - scale * shift);
+      }
+      m_Layers.push_back(std::move(layer));
+
+      linalg::matmul_bias<float>(in, d.weights, d.bias, next);
+      if (d.relu)
+        for (std::size_t i = 0; i < next.size(); i++)
+          next.data()[i] = std::max(next.data()[i], 0.0f);
+      std::swap(H, next);
+      in = H;
+    }
+    m_Acts.resize(m_Layers.size());
+  }
+
+  // out = logits of X, rows x OutputDim().
+  void Forward(linalg::ConstMatrixView<float> X, linalg::Matrix<float> &out) {
+    if (X.cols() != InputDim())
+      throw std::logic_error("QuantizedMLP: input width mismatch");
+    if (m_ActMax > linalg::simd::Kernels().qgemm_act_max())
+      throw std::logic_error("QuantizedMLP: activation range too wide for "
+                             "this SIMD tier's int8 GEMM");
+    const auto N = X.rows();
+    if (out.rows() != N || out.cols() != OutputDim())
+      out = linalg::Matrix<float>(N, OutputDim());
+    for (std::size_t l = 0; l < m_Layers.size(); l++)
+      if (m_Acts[l].rows() < N) {
+        const auto K = m_Layers[l].weights.depth();
+        m_Acts[l] = linalg::Matrix<std::uint8_t>(N, K);
+        m_Acts[l].fill_zeroes();
+      }
+
+    linalg::quantize(X, m_Layers[0].in, Input(0, N));
+    for (std::size_t l = 0; l < m_Layers.size(); l++) {
+      const Layer &layer = m_Layers[l];
+      linalg::simd::QGemmEpilogue ep;
+      ep.scale = layer.scale.data();
+      ep.bias = layer.bias.data();
+      ep.relu = layer.relu;
+      if (l + 1 < m_Layers.size()) {
+        const auto &next = m_Layers[l + 1].in;
+        ep.q = m_Acts[l + 1].data();
+        ep.ldo = m_Acts[l + 1].leading_dim();
+        ep.inv_scale = 1.0f / next.scale;
+        ep.zero = next.zero;
+        ep.act_max = next.act_max;
+      } else {
+        ep.out = out.data();
+        ep.ldo = out.leading_dim();
+      }
+      linalg::qgemm(Input(l, N), layer.weights, ep);
+    }
+  }
+
+  double Accuracy(linalg::ConstMatrixView<float> X,
+                  std::span<const std::uint8_t> labels) {
+    const auto N = X.rows();
+    if (N != labels.size() || N == 0)
+      throw std::logic_error("QuantizedMLP::Accuracy wrong Matrix size");
+
+    Forward(X, m_Logits);
+    std::size_t correct = 0;
+    for (std::size_t i = 0; i < N; i++)
+      if (ArgmaxRow<float>(m_Logits, i) == labels[i])
+        correct++;
+    return static_cast<double>(correct) / N;
+  }
+
+  std::size_t InputDim() const noexcept {
+    return m_Layers.front().weights.rows();
+  }
+  std::size_t OutputDim() const noexcept { return m_Layers.back().out; }
+  std::size_t size() const noexcept { return m_Layers.size(); }
+  // Largest activation code: 255 or 127.
+  std::int32_t ActMax() const noexcept { return m_ActMax; }
+
+  // Calibrated quantisation of layer l's input.
+  const linalg::QuantParams &InputParams(std::size_t l) const {
+    return m_Layers[l].in;
+  }
+  // Packed int8 weights of all layers, padding included.
+  std::size_t WeightBytes() const noexcept {
+    std::size_t bytes = 0;
+    for (const auto &layer : m_Layers)
+      bytes += layer.weights.size_bytes();
+    return bytes;
+  }
+
+private:
+  struct Layer {
+    linalg::QuantizedWeights weights;
+    linalg::QuantParams in;
+    // Per output column: s_in * s_j, and the float bias with the input
+    // zero point folded in.
+    std::vector<float> scale, bias;
+    bool relu = false;
+    std::size_t out = 0;
+  };
+
+  // Smallest and largest value of X.
+  static std::pair<float, float> Range(linalg::ConstMatrixView<float> X) {
+    float lo = X(0, 0), hi = X(0, 0);
+    for (std::size_t i = 0; i < X.rows(); i++) {
+      const auto [a, b] = std::minmax_element(X.row(i), X.row(i) + X.cols());
+      lo = std::min(lo, *a);
+      hi = std::max(hi, *b);
+    }
+    return {lo, hi};
+  }
+
+  // The first `rows` rows of layer l's input.
+  linalg::MatrixView<std::uint8_t> Input(std::size_t l, std::size_t rows) {
+    return {m_Acts[l].data(), rows, m_Acts[l].cols(),
+            m_Acts[l].leading_dim()};
+  }
+
+  std::vector<Layer> m_Layers;
+  std::int32_t m_ActMax = 0;
+  // uint8 input of every layer, depth() wide, at least as many rows as the
+  // largest batch so far.
+  std::vector<linalg::Matrix<std::uint8_t>> m_Acts;
+  linalg::Matrix<float> m_Logits;
+};
+} // namespace Logos::NeuralNet
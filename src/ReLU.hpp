@@ -1,31 +1,71 @@
 #pragma once
 
+#include "Kernels/Simd.hpp"
 #include "Layer.hpp"
+#include "Matrix.inl"
+#include "Threading/ThreadPool.hpp"
+#include <algorithm>
+#include <cstdint>
 #include <stdexcept>
-#include <vector>
+#include <type_traits>
 
 namespace Logos::NeuralNet {
-template <class T> class ReLU : public ILayer<T> {
+template <class T> class ReLU final : public ILayer<T> {
 public:
   ReLU() = default;
 
-  void Forward(const linalg::Matrix<T> &X, linalg::Matrix<T> &H) override {
+  void Forward(linalg::ConstMatrixView<T> X, linalg::Matrix<T> &H) override {
     const auto N = X.rows(), M = X.cols();
     if (H.rows() != N || H.cols() != M)
       H = linalg::Matrix<T>(N, M);
 
-    m_Rows = N, m_Cols = M;
-    m_Mask.assign(N * M, std::uint8_t{0});
-    for (std::size_t i = 0; i < N; i++)
-      for (std::size_t j = 0; j < M; j++) {
-        const bool fl = (X(i, j) > T{0});
-        m_Mask[i * M + j] = fl;
-        H(i, j) = fl ? X(i, j) : T{0};
-      }
+    auto mask = MaskFor(N, M);
+    T *out = H.data();
+    Threading::parallel_for(
+        0, N, Threading::GrainFor(M), [&](std::size_t r0, std::size_t r1) {
+          for (std::size_t i = r0; i < r1; i++) {
+            const T *in = X.row(i);
+            std::uint8_t *bits = mask.row(i);
+            if constexpr (std::is_same_v<T, float>) {
+              linalg::simd::Kernels().relu_forward(in, out + i * M, bits, M);
+            } else {
+              std::fill(bits, bits + mask.cols(), std::uint8_t{0});
+              for (std::size_t j = 0; j < M; j++) {
+                const bool fl = (in[j] > T{0});
+                bits[j / 8] |= static_cast<std::uint8_t>(fl << (j % 8));
+                out[i * M + j] = fl ? in[j] : T{0};
+              }
+            }
+          }
+        });
   }
 
-  void Backward(const linalg::Matrix<T> &dH, linalg::Matrix<T> &dX) override {
-    if (m_Mask.empty())
+  // H = max(X, 0) without a mask. H may be X itself.
+  void Infer(linalg::ConstMatrixView<T> X,
+             linalg::MatrixView<T> H) const override {
+    const auto N = X.rows(), M = X.cols();
+    if (H.rows() != N || H.cols() != M)
+      throw std::logic_error("ReLU::Infer shape mismatch");
+
+    Threading::parallel_for(
+        0, N, Threading::GrainFor(M), [&](std::size_t r0, std::size_t r1) {
+          for (std::size_t i = r0; i < r1; i++) {
+            const T *in = X.row(i);
+            T *out = H.row(i);
+            // In place, the two-pointer loop would fail its overlap check
+            // and run scalar.
+            if (in == out)
+              for (std::size_t j = 0; j < M; j++)
+                out[j] = out[j] > T{0} ? out[j] : T{0};
+            else
+              for (std::size_t j = 0; j < M; j++)
+                out[j] = in[j] > T{0} ? in[j] : T{0};
+          }
+        });
+  }
+
+  void Backward(linalg::ConstMatrixView<T> dH, linalg::Matrix<T> &dX) override {
+    if (m_Rows == 0)
       throw std::runtime_error("ReLU::Backward called before Forward");
     if (dH.rows() != m_Rows || dH.cols() != m_Cols)
       throw std::logic_error("ReLU::Backward shape mismatch");
@@ -33,19 +73,53 @@ public:
     if (dX.rows() != m_Rows || dX.cols() != m_Cols)
       dX = linalg::Matrix<T>(m_Rows, m_Cols);
 
-    const T *up = dH.data();
+    const auto M = m_Cols;
     T *down = dX.data();
+    Threading::parallel_for(
+        0, m_Rows, Threading::GrainFor(M), [&](std::size_t r0, std::size_t r1) {
+          for (std::size_t i = r0; i < r1; i++) {
+            const T *up = dH.row(i);
+            const std::uint8_t *bits = m_Mask.data() + i * m_Mask.leading_dim();
+            if constexpr (std::is_same_v<T, float>) {
+              linalg::simd::Kernels().relu_backward(up, bits, down + i * M, M);
+            } else {
+              for (std::size_t j = 0; j < M; j++) {
+                const bool fl = (bits[j / 8] >> (j % 8)) & 1u;
+                down[i * M + j] = fl ? up[j] : T{0};
+              }
+            }
+          }
+        });
+  }
+
+  // Keep the mask of the next Forward in caller-owned storage of
+  // rows x MaskBytes(cols) bytes, e.g. a planned workspace buffer, instead
+  // of an owned allocation.
+  void BindMask(std::uint8_t *storage, std::size_t rows, std::size_t cols) {
+    m_Mask = linalg::Matrix<std::uint8_t>::Wrap(
+        storage, rows, linalg::simd::MaskBytes(cols));
+  }
 
-    const std::size_t total = m_Rows * m_Cols;
-    for (std::size_t idx = 0; idx < total; idx++)
-      down[idx] = m_Mask[idx] ? up[idx] : T{0};
+  // Stands in for Forward when another kernel computes the activation, e.g.
+  // the GEMM epilogue of LinearReLU: returns the bit-packed mask storage for
+  // a rows x cols activation, which the next Backward reads.
+  linalg::MatrixView<std::uint8_t> MaskFor(std::size_t rows,
+                                           std::size_t cols) {
+    const auto bytes = linalg::simd::MaskBytes(cols);
+    m_Rows = rows, m_Cols = cols;
+    if (m_Mask.rows() != rows || m_Mask.cols() != bytes)
+      m_Mask = linalg::Matrix<std::uint8_t>(rows, bytes);
+    return m_Mask;
   }
 
+  // Bytes held by the mask, one bit per activation.
+  std::size_t MaskBytes() const noexcept { return m_Mask.size(); }
+
   void ZeroGrads() override {}
   void GradientDescentStep(float) override {}
 
 private:
   std::size_t m_Rows = 0, m_Cols = 0;
-  std::vector<std::uint8_t> m_Mask;
+  linalg::Matrix<std::uint8_t> m_Mask;
 };
 } // namespace Logos::NeuralNet
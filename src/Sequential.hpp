@@ -0,0 +1,745 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "Functions.hpp"
+#include "Layer.hpp"
+#include "Linear.hpp"
+#include "LinearReLU.hpp"
+#include "Memory/Workspace.hpp"
+#include "Optimizer.hpp"
+#include "ParameterArena.hpp"
+#include "ReLU.hpp"
+
+namespace Logos::NeuralNet {
+// Feed-forward stack of layers, described once and then run over one
+// planned workspace.
+//
+// Each Add* call takes the width of the previous output as its input, so
+// every shape is known while the model is described. Build() then fuses
+// each Linear directly followed by a ReLU into a LinearReLU and works out,
+// for every activation, mask and gradient, the span of training-step ops
+// over which it is live. The first batch of a new maximum size lays them
+// out in a Memory::Workspace; smaller batches use a prefix of each slot, so
+// steady-state steps do not allocate.
+//
+// The built-in layers are held by value in a std::variant and reached with
+// std::visit. They are final, so Forward/Backward on them are direct calls.
+// Other layers come in through AddLayer and the virtual ILayer interface.
+//
+// Build() also moves all parameters and gradients into one ParameterArena
+// (ILayer::BindParameters), so whole-model operations - the optimizer
+// step, clearing gradients, copying weights between replicas - each run
+// as a single pass over FlatParameters()/FlatGradients().
+//
+// SetPrecision(BF16 or F16) trains in mixed precision: the arena stays the
+// fp32 master copy the optimizer updates, and a 16-bit shadow of it, one
+// conversion pass after every update, is what the layers' GEMMs read.
+// Activations kept for the backward pass are stored in 16 bits as well;
+// all products still accumulate in fp32.
+template <class T> class Sequential {
+public:
+  // Makes a fresh layer for AddLayer; called again for every replica.
+  using LayerFactory =
+      std::function<std::unique_ptr<ILayer<T>>(std::mt19937 &)>;
+  using ConstView = linalg::ConstMatrixView<T>;
+  using Labels = std::span<const std::uint8_t>;
+
+  explicit Sequential(std::size_t in_dim) : m_InDim(in_dim) {}
+
+  Sequential(Sequential &&) noexcept = default;
+  Sequential &operator=(Sequential &&) noexcept = default;
+
+  Sequential &AddLinear(std::size_t out, std::mt19937 &rng) {
+    CheckOpen();
+    m_Nodes.emplace_back(std::in_place_type<Linear<T>>, OutputDim(), out,
+                         rng);
+    m_Info.push_back({out, true, Mask::None});
+    m_Spec.push_back({Kind::Linear, out, nullptr, true});
+    return *this;
+  }
+
+  Sequential &AddReLU() {
+    CheckOpen();
+    const auto width = OutputDim();
+    m_Nodes.emplace_back(std::in_place_type<ReLU<T>>);
+    m_Info.push_back({width, false, Mask::Separate});
+    m_Spec.push_back({Kind::ReLU, width, nullptr, false});
+    return *this;
+  }
+
+  // `out` is the layer's output width. keeps_input: Backward reads the
+  // Forward input again (as Linear does), so it must stay alive until then.
+  Sequential &AddLayer(LayerFactory make, std::size_t out, std::mt19937 &rng,
+                       bool keeps_input = true) {
+    CheckOpen();
+    m_Nodes.emplace_back(make(rng));
+    m_Info.push_back({out, keeps_input, Mask::None});
+    m_Spec.push_back({Kind::Custom, out, std::move(make), keeps_input});
+    return *this;
+  }
+
+  // Ends the description. With `fuse`, Linear -> ReLU pairs become single
+  // LinearReLU layers. Called by the first step if not called before.
+  void Build(bool fuse = true) {
+    if (m_Built)
+      return;
+    if (m_Nodes.empty())
+      throw std::logic_error("Sequential::Build on an empty model");
+
+    if (fuse) {
+      std::vector<Node> nodes;
+      std::vector<NodeInfo> info;
+      for (std::size_t i = 0; i < m_Nodes.size(); i++) {
+        auto *linear = std::get_if<Linear<T>>(&m_Nodes[i]);
+        if (linear && i + 1 < m_Nodes.size() &&
+            std::holds_alternative<ReLU<T>>(m_Nodes[i + 1])) {
+          nodes.emplace_back(std::in_place_type<LinearReLU<T>>,
+                             std::move(*linear));
+          info.push_back({m_Info[i].out, true, Mask::Fused});
+          i++;
+        } else {
+          nodes.push_back(std::move(m_Nodes[i]));
+          info.push_back(m_Info[i]);
+        }
+      }
+      m_Nodes = std::move(nodes);
+      m_Info = std::move(info);
+    }
+
+    BindArena();
+    m_Fused = fuse;
+    m_Built = true;
+    BindShadow();
+  }
+
+  // Plans and reserves the workspace for batches of up to `rows` rows now
+  // rather than on the first step that needs it.
+  void Reserve(std::size_t rows) {
+    Build();
+    if (rows > m_PlannedRows)
+      Plan(rows);
+  }
+
+  double TrainStep(ConstView X, Labels labels, double learning_rate) {
+    const double loss = ComputeGradients(X, labels);
+    ApplyGradients(learning_rate);
+    return loss;
+  }
+
+  // Forward + backward of the softmax cross-entropy loss, leaving the
+  // gradients in the layers.
+  double ComputeGradients(ConstView X, Labels labels) {
+    const auto N = X.rows(), M = X.cols();
+    if (N == 0 || M == 0)
+      throw std::logic_error("TrainStep: empty input matrix");
+    if (labels.size() != N)
+      throw std::logic_error("TrainStep: labels size mismatch");
+
+    BindWorkspace(N);
+    RunForward(X, m_Out.back());
+    const float loss = SoftmaxCrossEntropy<T>(m_Out.back(), labels,
+                                              m_Grad.back(), m_MathMode);
+    RunBackward();
+    return loss;
+  }
+
+  // The optimizer step that consumes and clears the gradients.
+  void ApplyGradients(double learning_rate) {
+    optimizer().Step(learning_rate);
+    RefreshWeights();
+  }
+
+  // Storage of the weights the GEMMs read and of the activations saved for
+  // backward. F32 by default; BF16 and F16 halve both, with fp32 master
+  // weights and fp32 accumulation. Takes effect on the next step.
+  void SetPrecision(linalg::Precision precision) {
+    if (precision == m_Precision)
+      return;
+    m_Precision = precision;
+    m_PlannedRows = 0; // the saved activations change size
+    if (m_Built)
+      BindShadow();
+  }
+  linalg::Precision precision() const noexcept { return m_Precision; }
+
+  // Re-derives the 16-bit weights from the fp32 master weights in one pass.
+  // ApplyGradients and CopyParametersFrom do this; call it after writing
+  // FlatParameters() directly.
+  void RefreshWeights() {
+    if (m_Precision == linalg::Precision::F32 || !m_Built)
+      return;
+    const auto w = m_Arena.flat_params();
+    auto *dst = static_cast<std::uint16_t *>(m_Shadow.data());
+    Threading::parallel_for(0, w.size(), Threading::GrainFor(1),
+                            [&](std::size_t b, std::size_t e) {
+                              linalg::ToHalf(m_Precision, w.data() + b,
+                                             dst + b, e - b);
+                            });
+  }
+
+  // Update rule of ApplyGradients, plain SGD unless set. Starts again from
+  // fresh optimizer state.
+  void SetOptimizer(OptimizerOptions options) {
+    m_OptimizerOptions = options;
+    m_Optimizer.reset();
+  }
+  // Runs over the flat arena, one tensor for the whole model.
+  Optimizer &optimizer() {
+    if (!m_Optimizer)
+      m_Optimizer = std::make_unique<Optimizer>(
+          std::vector{FlatParameters()}, std::vector{FlatGradients()},
+          m_OptimizerOptions);
+    return *m_Optimizer;
+  }
+
+  void ZeroGrads() {
+    if (!m_Built) {
+      for (auto &node : m_Nodes)
+        Visit(node, [](auto &layer) { layer.ZeroGrads(); });
+      return;
+    }
+    const auto g = m_Arena.flat_grads();
+    std::fill(g.begin(), g.end(), T{0});
+  }
+
+  void Forward(ConstView X, linalg::Matrix<T> &out) {
+    BindWorkspace(X.rows());
+    RunForward(X, out);
+  }
+
+  // Activations of Infer, owned by the caller: the two buffers the hidden
+  // layers alternate between and the logits. They grow to the largest
+  // batch seen and are reused after that. Each thread needs its own.
+  struct InferenceScratch {
+    linalg::Matrix<T> H[2], logits;
+  };
+
+  // Inference-mode forward: out (X.rows() x OutputDim()) = the model
+  // applied to X. Unlike Forward it keeps no state for Backward, such as
+  // layer inputs or ReLU masks. All intermediates go to `scratch`, and the
+  // model itself is only read. Threads with their own scratch can
+  // therefore share one model, as long as nothing trains it meanwhile.
+  // The model must be built.
+  void Infer(ConstView X, linalg::MatrixView<T> out,
+             InferenceScratch &scratch) const {
+    if (!m_Built)
+      throw std::logic_error("Sequential::Infer before Build");
+    if (X.cols() != m_InDim)
+      throw std::logic_error("Sequential: input width mismatch");
+    const std::size_t N = X.rows(), L = m_Nodes.size();
+    if (out.rows() != N || out.cols() != OutputDim())
+      throw std::logic_error("Sequential::Infer: output shape mismatch");
+
+    std::size_t width = 0;
+    for (std::size_t i = 0; i + 1 < L; i++)
+      width = std::max(width, m_Info[i].out);
+    for (auto &h : scratch.H)
+      if (h.rows() < N || h.cols() < width)
+        h = linalg::Matrix<T>(std::max(h.rows(), N), width);
+
+    // An unfused ReLU overwrites its input in place: one pass over the
+    // activations instead of a read and a write to the other buffer.
+    ConstView in = X;
+    linalg::MatrixView<T> prev; // in, once it is a scratch buffer
+    std::size_t next = 0;
+    for (std::size_t i = 0; i < L; i++) {
+      linalg::MatrixView<T> dst = out;
+      if (i + 1 < L && prev.data() &&
+          std::holds_alternative<ReLU<T>>(m_Nodes[i])) {
+        dst = prev;
+      } else if (i + 1 < L) {
+        auto &h = scratch.H[next];
+        next ^= 1;
+        dst = {h.data(), N, m_Info[i].out, h.leading_dim()};
+      }
+      Visit(m_Nodes[i], [&](const auto &layer) { layer.Infer(in, dst); });
+      in = prev = dst;
+    }
+  }
+
+  // Infer into scratch.logits; the view is valid until its next use.
+  ConstView Infer(ConstView X, InferenceScratch &scratch) const {
+    auto &Y = scratch.logits;
+    if (Y.rows() != X.rows() || Y.cols() != OutputDim())
+      Y = linalg::Matrix<T>(X.rows(), OutputDim());
+    Infer(X, Y, scratch);
+    return Y;
+  }
+
+  // Fraction of rows whose largest logit is at their label, by Infer.
+  double Accuracy(ConstView X, Labels labels,
+                  InferenceScratch &scratch) const {
+    const auto N = X.rows();
+    if (N != labels.size() || N == 0)
+      throw std::logic_error("Sequential::Accuracy wrong Matrix size");
+
+    const ConstView logits = Infer(X, scratch);
+    std::size_t correct = 0;
+    for (std::size_t i = 0; i < N; i++)
+      if (ArgmaxRow<T>(logits, i) == labels[i])
+        correct++;
+    return static_cast<double>(correct) / N;
+  }
+  double Accuracy(ConstView X, Labels labels) const {
+    InferenceScratch scratch;
+    return Accuracy(X, labels, scratch);
+  }
+
+  // Every layer's parameters in order; Gradients() matches.
+  std::vector<std::span<T>> Parameters() {
+    std::vector<std::span<T>> out;
+    for (auto &node : m_Nodes)
+      for (auto p : Visit(node, [](auto &layer) { return layer.Parameters(); }))
+        out.push_back(p);
+    return out;
+  }
+  std::vector<std::span<T>> Gradients() {
+    std::vector<std::span<T>> out;
+    for (auto &node : m_Nodes)
+      for (auto g : Visit(node, [](auto &layer) { return layer.Gradients(); }))
+        out.push_back(g);
+    return out;
+  }
+
+  // All parameters, then all gradients, in the arena layout: Parameters()
+  // in order, each tensor starting on a cache line, zero padding between
+  // them. Models of the same architecture share the layout, so these can
+  // be copied, reduced or written to a file as a single range.
+  std::span<T> FlatParameters() {
+    Build();
+    return m_Arena.flat_params();
+  }
+  std::span<T> FlatGradients() {
+    Build();
+    return m_Arena.flat_grads();
+  }
+
+  void CopyParametersFrom(Sequential &other) {
+    const auto dst = Parameters(), src = other.Parameters();
+    if (dst.size() != src.size())
+      throw std::logic_error("CopyParametersFrom: shape mismatch");
+    for (std::size_t t = 0; t < dst.size(); t++)
+      if (dst[t].size() != src[t].size())
+        throw std::logic_error("CopyParametersFrom: shape mismatch");
+
+    if (m_Built && other.m_Built) {
+      const auto from = other.m_Arena.flat_params();
+      std::copy(from.begin(), from.end(), m_Arena.flat_params().begin());
+    } else {
+      for (std::size_t t = 0; t < dst.size(); t++)
+        std::copy(src[t].begin(), src[t].end(), dst[t].begin());
+    }
+    RefreshWeights();
+  }
+
+  // Makes `flat`, in the FlatParameters() layout, the model's parameter
+  // storage without copying it: the layers compute with the values already
+  // there, e.g. in a mapped checkpoint, so the cost does not grow with the
+  // model. `flat` must outlive the model. Training afterwards updates
+  // `flat` in place; optimizer state starts over.
+  void MapParameters(std::span<T> flat) {
+    Build();
+    if (flat.size() != m_Arena.flat_params().size())
+      throw std::logic_error("MapParameters: size mismatch");
+    m_Arena.Adopt(flat.data());
+
+    std::vector<std::span<T>> params;
+    for (std::size_t t = 0; t < m_Arena.tensors(); t++)
+      params.push_back(m_Arena.param(t));
+    std::size_t t = 0;
+    for (auto &node : m_Nodes)
+      Visit(node, [&](auto &layer) {
+        const std::size_t n = layer.Parameters().size();
+        layer.ReferenceParameters(std::span(params).subspan(t, n));
+        t += n;
+      });
+
+    const auto p = Parameters();
+    for (t = 0; t < params.size(); t++)
+      if (p[t].data() != params[t].data())
+        throw std::logic_error(
+            "Sequential: layer cannot reference external parameters");
+    m_Optimizer.reset();
+    BindShadow();
+  }
+
+  // Same architecture, parameters and math mode, with its own layers and
+  // workspace: a data-parallel or Hogwild worker.
+  std::unique_ptr<Sequential> Replica() {
+    // The RNG only feeds the initialisation overwritten below.
+    std::mt19937 rng(0);
+    auto replica = std::make_unique<Sequential>(m_InDim);
+    for (const auto &s : m_Spec) {
+      if (s.kind == Kind::Linear)
+        replica->AddLinear(s.out, rng);
+      else if (s.kind == Kind::ReLU)
+        replica->AddReLU();
+      else
+        replica->AddLayer(s.make, s.out, rng, s.keeps_input);
+    }
+    if (m_Built)
+      replica->Build(m_Fused);
+    replica->SetPrecision(m_Precision);
+    replica->CopyParametersFrom(*this);
+    replica->SetMathMode(m_MathMode);
+    replica->SetOptimizer(m_OptimizerOptions);
+    return replica;
+  }
+
+  std::size_t InputDim() const noexcept { return m_InDim; }
+  std::size_t OutputDim() const noexcept {
+    return m_Info.empty() ? m_InDim : m_Info.back().out;
+  }
+  // Layers after fusion once built.
+  std::size_t size() const noexcept { return m_Nodes.size(); }
+
+  // e.g. "784 -> LinearReLU 256 -> Linear 10"
+  std::string Summary() const {
+    std::string s = std::to_string(m_InDim);
+    for (std::size_t i = 0; i < m_Nodes.size(); i++)
+      s += std::string(" -> ") + KindName(i) + " " +
+           std::to_string(m_Info[i].out);
+    return s;
+  }
+
+  // The model as a chain of dense layers, for inference engines that take
+  // over its weights (QuantizedMLP): every Linear, in order, with whether
+  // a ReLU follows it. Throws if the model has any other kind of layer.
+  struct DenseLayer {
+    linalg::ConstMatrixView<T> weights;
+    std::span<const T> bias;
+    bool relu;
+  };
+  std::vector<DenseLayer> DenseLayers() {
+    Build();
+    std::vector<DenseLayer> out;
+    for (auto &node : m_Nodes) {
+      if (auto *linear = std::get_if<Linear<T>>(&node)) {
+        out.push_back({{linear->Weights().data(), linear->InputDim(),
+                        linear->OutputDim(), linear->OutputDim()},
+                       linear->Bias(),
+                       false});
+      } else if (auto *fused = std::get_if<LinearReLU<T>>(&node)) {
+        out.push_back({{fused->Weights().data(), fused->InputDim(),
+                        fused->OutputDim(), fused->OutputDim()},
+                       fused->Bias(),
+                       true});
+      } else if (std::holds_alternative<ReLU<T>>(node) && !out.empty() &&
+                 !out.back().relu) {
+        out.back().relu = true;
+      } else {
+        throw std::logic_error("Sequential: not a chain of dense layers");
+      }
+    }
+    return out;
+  }
+
+  // exp/log precision of the softmax cross-entropy in ComputeGradients.
+  void SetMathMode(MathMode mode) noexcept { m_MathMode = mode; }
+  MathMode math_mode() const noexcept { return m_MathMode; }
+
+  // Activation/gradient buffer plan for the largest batch seen so far.
+  const Memory::WorkspacePlan &WorkspaceLayout() const noexcept {
+    return m_Plan;
+  }
+
+private:
+  using Node = std::variant<Linear<T>, ReLU<T>, LinearReLU<T>,
+                            std::unique_ptr<ILayer<T>>>;
+
+  // Separate: a ReLU layer, whose Backward reads the mask while writing its
+  // output gradient. Fused: a LinearReLU, which is done with the mask before
+  // the Linear part writes its output gradient.
+  enum class Mask : std::uint8_t { None = 0, Separate, Fused };
+  enum class Kind : std::uint8_t { Linear = 0, ReLU, Custom };
+
+  struct NodeInfo {
+    std::size_t out;
+    bool keeps_input;
+    Mask mask;
+  };
+  struct SpecEntry {
+    Kind kind;
+    std::size_t out;
+    LayerFactory make;
+    bool keeps_input;
+  };
+
+  // Calls fn with the layer as its concrete type, or as ILayer<T> for
+  // layers added through AddLayer.
+  template <class Fn> static decltype(auto) Visit(Node &node, Fn &&fn) {
+    return std::visit(
+        [&](auto &layer) -> decltype(auto) {
+          using L = std::decay_t<decltype(layer)>;
+          if constexpr (std::is_same_v<L, std::unique_ptr<ILayer<T>>>)
+            return fn(*layer);
+          else
+            return fn(layer);
+        },
+        node);
+  }
+  template <class Fn> static decltype(auto) Visit(const Node &node, Fn &&fn) {
+    return std::visit(
+        [&](const auto &layer) -> decltype(auto) {
+          using L = std::decay_t<decltype(layer)>;
+          if constexpr (std::is_same_v<L, std::unique_ptr<ILayer<T>>>)
+            return fn(std::as_const(*layer));
+          else
+            return fn(layer);
+        },
+        node);
+  }
+
+  // Gives every layer its slice of a new arena sized from Parameters().
+  void BindArena() {
+    const auto before = Parameters();
+    std::vector<std::size_t> sizes;
+    for (const auto p : before)
+      sizes.push_back(p.size());
+    m_Arena = ParameterArena<T>(sizes);
+
+    std::vector<std::span<T>> params, grads;
+    for (std::size_t t = 0; t < sizes.size(); t++) {
+      params.push_back(m_Arena.param(t));
+      grads.push_back(m_Arena.grad(t));
+    }
+    std::size_t t = 0;
+    for (auto &node : m_Nodes)
+      Visit(node, [&](auto &layer) {
+        const std::size_t n = layer.Parameters().size();
+        layer.BindParameters(std::span(params).subspan(t, n),
+                             std::span(grads).subspan(t, n));
+        t += n;
+      });
+
+    // A custom layer with parameters that does not override
+    // BindParameters would silently train outside the arena.
+    const auto p = Parameters(), g = Gradients();
+    for (t = 0; t < sizes.size(); t++)
+      if (p[t].data() != params[t].data() || g[t].data() != grads[t].data())
+        throw std::logic_error(
+            "Sequential: layer parameters not bound to the arena");
+  }
+
+  // Gives every layer its slice of a 16-bit copy of the arena, laid out the
+  // same way, or takes the copies away again for F32.
+  void BindShadow() {
+    const auto params = Parameters();
+    const std::size_t count = params.size();
+    std::vector<std::span<std::uint16_t>> weights;
+    if (m_Precision == linalg::Precision::F32) {
+      m_Shadow = Memory::Buffer();
+    } else {
+      const auto flat = m_Arena.flat_params();
+      m_Shadow = Memory::Buffer(flat.size() * sizeof(std::uint16_t));
+      auto *base = static_cast<std::uint16_t *>(m_Shadow.data());
+      for (std::size_t t = 0; t < count; t++)
+        weights.push_back({base + (params[t].data() - flat.data()),
+                           params[t].size()});
+    }
+
+    std::size_t t = 0;
+    for (auto &node : m_Nodes)
+      Visit(node, [&](auto &layer) {
+        const std::size_t n = layer.Parameters().size();
+        layer.BindStorage(m_Precision, weights.empty()
+                                           ? std::span(weights)
+                                           : std::span(weights).subspan(t, n));
+        t += n;
+      });
+    RefreshWeights();
+  }
+
+  // Layer i saves its input for Backward in 16 bits. The input of layer 0
+  // is the caller's batch, which outlives the step anyway.
+  bool SavesInput16(std::size_t i) {
+    return m_Precision != linalg::Precision::F32 && i > 0 &&
+           (std::holds_alternative<Linear<T>>(m_Nodes[i]) ||
+            std::holds_alternative<LinearReLU<T>>(m_Nodes[i]));
+  }
+
+  const char *KindName(std::size_t i) const {
+    switch (m_Nodes[i].index()) {
+    case 0:
+      return "Linear";
+    case 1:
+      return "ReLU";
+    case 2:
+      return "LinearReLU";
+    default:
+      return "Layer";
+    }
+  }
+
+  void CheckOpen() const {
+    if (m_Built)
+      throw std::logic_error("Sequential: layer added after Build");
+  }
+
+  std::size_t InDim(std::size_t i) const {
+    return i == 0 ? m_InDim : m_Info[i - 1].out;
+  }
+
+  void Plan(std::size_t rows) {
+    // Step indices of a training step with L layers:
+    //   i                  Forward of layer i
+    //   L                  softmax cross-entropy
+    //   Bm(i), B(i)        Backward of layer i, as two steps: a LinearReLU
+    //                      applies its mask in Bm(i) and runs the Linear
+    //                      part in B(i)
+    // with Bm(i) = L + 1 + 2 (L - 1 - i) and B(i) = Bm(i) + 1. A buffer lives
+    // from the op that writes it to the last op reading it. The masked
+    // gradient of a LinearReLU overwrites its incoming gradient in place.
+    const std::size_t L = m_Nodes.size(), loss = L;
+    auto Bm = [&](std::size_t i) { return L + 1 + 2 * (L - 1 - i); };
+    auto B = [&](std::size_t i) { return Bm(i) + 1; };
+
+    m_Names.clear();
+    m_Names.reserve(4 * L + 1);
+    for (std::size_t i = 0; i < L; i++) {
+      const std::string layer = std::to_string(i) + " " + KindName(i);
+      m_Names.push_back(layer + " out");
+      m_Names.push_back(layer + " mask");
+      m_Names.push_back(layer + " dout");
+      m_Names.push_back(layer + " in16");
+    }
+    m_Names.push_back("dX");
+
+    m_Plan = Memory::WorkspacePlan();
+    m_Slots.assign(L, {});
+    for (std::size_t i = 0; i < L; i++) {
+      const auto &info = m_Info[i];
+      Slots &s = m_Slots[i];
+
+      // A layer that saves its input in 16 bits only reads the full
+      // precision one during its Forward.
+      const bool kept = i + 1 < L && m_Info[i + 1].keeps_input &&
+                        !SavesInput16(i + 1);
+      const std::size_t out_last =
+          (i + 1 == L) ? loss : (kept ? B(i + 1) : i + 1);
+      s.out = m_Plan.Add(m_Names[4 * i].c_str(), rows * info.out * sizeof(T),
+                         i, out_last);
+      if (info.mask != Mask::None)
+        s.mask = m_Plan.Add(m_Names[4 * i + 1].c_str(),
+                            rows * linalg::simd::MaskBytes(info.out), i,
+                            info.mask == Mask::Fused ? Bm(i) : B(i));
+      s.grad = m_Plan.Add(m_Names[4 * i + 2].c_str(),
+                          rows * info.out * sizeof(T),
+                          (i + 1 == L) ? loss : B(i + 1), B(i));
+      if (SavesInput16(i))
+        s.in16 = m_Plan.Add(m_Names[4 * i + 3].c_str(),
+                            rows * InDim(i) * sizeof(std::uint16_t), i, B(i));
+    }
+    m_dXSlot = m_Plan.Add(m_Names.back().c_str(), rows * m_InDim * sizeof(T),
+                          B(0), B(0));
+    m_Plan.Solve();
+
+    m_Workspace.Reserve(m_Plan);
+    m_Out.resize(L);
+    m_Grad.resize(L);
+    m_PlannedRows = rows;
+  }
+
+  // Points the activation, mask and gradient matrices at their slots for a
+  // batch of `rows`.
+  void BindWorkspace(std::size_t rows) {
+    Build();
+    if (rows > m_PlannedRows)
+      Plan(rows);
+    m_Workspace.BeginStep();
+
+    auto bind = [&](linalg::Matrix<T> &m, Memory::WorkspacePlan::Id id,
+                    std::size_t cols) {
+      T *p = m_Workspace.Get<T>(id);
+      if (m.data() != p || m.rows() != rows)
+        m = linalg::Matrix<T>::Wrap(p, rows, cols, cols,
+                                    Memory::DEFAULT_ALIGNMENT);
+    };
+
+    for (std::size_t i = 0; i < m_Nodes.size(); i++) {
+      const auto width = m_Info[i].out;
+      const Slots &s = m_Slots[i];
+      bind(m_Out[i], s.out, width);
+      bind(m_Grad[i], s.grad, width);
+
+      std::uint16_t *in16 =
+          SavesInput16(i) ? m_Workspace.Get<std::uint16_t>(s.in16) : nullptr;
+      if (auto *relu = std::get_if<ReLU<T>>(&m_Nodes[i])) {
+        relu->BindMask(m_Workspace.Get<std::uint8_t>(s.mask), rows, width);
+      } else if (auto *fused = std::get_if<LinearReLU<T>>(&m_Nodes[i])) {
+        fused->BindMask(m_Workspace.Get<std::uint8_t>(s.mask), rows);
+        fused->BindGradScratch(m_Workspace.Get<T>(s.grad), rows);
+        fused->BindInputStorage(in16, rows);
+      } else if (auto *linear = std::get_if<Linear<T>>(&m_Nodes[i])) {
+        linear->BindInputStorage(in16, rows);
+      }
+    }
+    bind(m_dX, m_dXSlot, m_InDim);
+  }
+
+  void RunForward(ConstView X, linalg::Matrix<T> &out) {
+    if (X.cols() != m_InDim)
+      throw std::logic_error("Sequential: input width mismatch");
+
+    ConstView in = X;
+    const std::size_t L = m_Nodes.size();
+    for (std::size_t i = 0; i < L; i++) {
+      linalg::Matrix<T> &dst = (i + 1 == L) ? out : m_Out[i];
+      Visit(m_Nodes[i], [&](auto &layer) { layer.Forward(in, dst); });
+      in = dst;
+    }
+  }
+
+  // Backward from the loss gradient in m_Grad.back().
+  void RunBackward() {
+    for (std::size_t i = m_Nodes.size(); i-- > 0;) {
+      linalg::Matrix<T> &dst = (i == 0) ? m_dX : m_Grad[i - 1];
+      Visit(m_Nodes[i], [&](auto &layer) { layer.Backward(m_Grad[i], dst); });
+    }
+  }
+
+  std::size_t m_InDim;
+  std::vector<Node> m_Nodes;
+  std::vector<NodeInfo> m_Info;
+  std::vector<SpecEntry> m_Spec;
+  bool m_Built = false, m_Fused = false;
+  MathMode m_MathMode = MathMode::Accurate;
+
+  // Storage of every layer's parameters and gradients, from Build(), and
+  // the 16-bit copy of the parameters the layers read in mixed precision.
+  ParameterArena<T> m_Arena;
+  linalg::Precision m_Precision = linalg::Precision::F32;
+  Memory::Buffer m_Shadow;
+
+  // Created by the first ApplyGradients, once the model is built.
+  OptimizerOptions m_OptimizerOptions;
+  std::unique_ptr<Optimizer> m_Optimizer;
+
+  struct Slots {
+    Memory::WorkspacePlan::Id out = 0, mask = 0, grad = 0, in16 = 0;
+  };
+  Memory::WorkspacePlan m_Plan;
+  Memory::Workspace m_Workspace;
+  std::vector<std::string> m_Names;
+  std::vector<Slots> m_Slots;
+  Memory::WorkspacePlan::Id m_dXSlot = 0;
+  std::size_t m_PlannedRows = 0;
+
+  // Non-owning views into m_Workspace: the output of layer i and the
+  // gradient with respect to it, and the gradient of the input.
+  std::vector<linalg::Matrix<T>> m_Out, m_Grad;
+  linalg::Matrix<T> m_dX;
+};
+} // namespace Logos::NeuralNet
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "Serving/InferenceServer.hpp"
+
+namespace Logos::Serving {
+
+InferenceServer::InferenceServer(const NeuralNet::Sequential<float> &model,
+                                 ServerOptions options)
+    : m_Model(model), m_Options(options) {
+  if (m_Options.max_batch == 0 || m_Options.workers == 0)
+    throw std::logic_error("InferenceServer: empty batch or no workers");
+
+  const std::size_t rows = m_Options.max_batch;
+  for (std::size_t w = 0; w < m_Options.workers; w++) {
+    auto ws = std::make_unique<Workspace>();
+    ws->X = linalg::Matrix<float>(rows, InputDim());
+    ws->X.fill_zeroes();
+    ws->Y = linalg::Matrix<float>(rows, OutputDim());
+    // A full batch grows the scratch to its final size.
+    m_Model.Infer(ws->X, ws->Y, ws->scratch);
+    m_Workspaces.push_back(std::move(ws));
+  }
+  for (std::size_t w = 0; w < m_Options.workers; w++)
+    m_Workers.emplace_back([this, w] { WorkerMain(w); });
+}
+
+InferenceServer::~InferenceServer() {
+  {
+    std::lock_guard lock(m_Mutex);
+    m_Stop = true;
+  }
+  m_Arrived.notify_all();
+  for (auto &t : m_Workers)
+    t.join();
+}
+
+std::future<std::vector<float>>
+InferenceServer::Submit(std::span<const float> x) {
+  if (x.size() != InputDim())
+    throw std::logic_error("InferenceServer: input width mismatch");
+
+  Request r;
+  r.x.assign(x.begin(), x.end());
+  r.arrival = std::chrono::steady_clock::now();
+  auto result = r.result.get_future();
+
+  std::size_t queued;
+  {
+    std::lock_guard lock(m_Mutex);
+    if (m_Stop)
+      throw std::logic_error("InferenceServer: submit after shutdown");
+    m_Queue.push_back(std::move(r));
+    queued = m_Queue.size();
+  }
+  // The first request starts a batch; a full batch releases the worker
+  // waiting out its deadline.
+  if (queued == 1)
+    m_Arrived.notify_one();
+  else if (queued == m_Options.max_batch)
+    m_Arrived.notify_all();
+  return result;
+}
+
+void InferenceServer::WorkerMain(std::size_t w) {
+  Workspace &ws = *m_Workspaces[w];
+  const std::size_t max_batch = m_Options.max_batch;
+  std::vector<Request> batch;
+  batch.reserve(max_batch);
+
+  for (;;) {
+    bool more;
+    {
+      std::unique_lock lock(m_Mutex);
+      m_Arrived.wait(lock, [&] { return m_Stop || !m_Queue.empty(); });
+      if (m_Queue.empty())
+        return; // stopped and drained
+
+      const auto deadline = m_Queue.front().arrival + m_Options.max_delay;
+      m_Arrived.wait_until(lock, deadline, [&] {
+        return m_Stop || m_Queue.size() >= max_batch;
+      });
+      // Another worker may have taken the requests meanwhile.
+      const std::size_t n = std::min(max_batch, m_Queue.size());
+      for (std::size_t i = 0; i < n; i++) {
+        batch.push_back(std::move(m_Queue.front()));
+        m_Queue.pop_front();
+      }
+      more = !m_Queue.empty();
+    }
+    if (more)
+      m_Arrived.notify_one();
+    if (batch.empty())
+      continue;
+
+    Run(ws, batch);
+    batch.clear();
+  }
+}
+
+void InferenceServer::Run(Workspace &ws, std::vector<Request> &batch) {
+  const std::size_t N = batch.size();
+  // The first N rows of a workspace matrix.
+  auto rows = [&](linalg::Matrix<float> &m, std::size_t cols) {
+    return linalg::MatrixView<float>(m.data(), N, cols, m.leading_dim());
+  };
+  const auto X = rows(ws.X, InputDim());
+  for (std::size_t i = 0; i < N; i++)
+    std::copy(batch[i].x.begin(), batch[i].x.end(), X.row(i));
+  try {
+    m_Model.Infer(X, rows(ws.Y, OutputDim()), ws.scratch);
+  } catch (...) {
+    for (auto &r : batch)
+      r.result.set_exception(std::current_exception());
+    return;
+  }
+
+  const auto Y = rows(ws.Y, OutputDim());
+  for (std::size_t i = 0; i < N; i++)
+    batch[i].result.set_value(
+        std::vector<float>(Y.row(i), Y.row(i) + Y.cols()));
+  m_Requests.fetch_add(N, std::memory_order_relaxed);
+  m_Batches.fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace Logos::Serving
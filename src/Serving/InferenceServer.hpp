@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "Matrix.inl"
+#include "Sequential.hpp"
+
+namespace Logos::Serving {
+
+struct ServerOptions {
+  // Rows of one batched forward.
+  std::size_t max_batch = 64;
+  // How long the oldest queued request may wait for others to join its
+  // batch. A full batch goes out at once.
+  std::chrono::microseconds max_delay{200};
+  // Threads running batches; each has its own activation buffers.
+  std::size_t workers = 1;
+};
+
+// In-process inference with dynamic micro-batching. Submit() queues one
+// input row and returns a future for its logits. Worker threads take the
+// queue in batches: a batch closes when it holds max_batch requests or its
+// oldest request has waited max_delay, and runs as one forward, whose GEMM
+// amortises the weight traffic over every row in it.
+//
+// The model is frozen: workers run Sequential::Infer, which only reads it,
+// so they all share one copy of the weights. It must not be trained or
+// destroyed while the server runs. Each worker owns its input and output
+// rows and its InferenceScratch, sized for max_batch rows up front, so
+// steady-state batches do not allocate activations.
+class InferenceServer {
+public:
+  struct Stats {
+    std::uint64_t requests = 0, batches = 0;
+
+    double mean_batch() const {
+      return batches ? static_cast<double>(requests) / batches : 0.0;
+    }
+  };
+
+  explicit InferenceServer(const NeuralNet::Sequential<float> &model,
+                           ServerOptions options = {});
+  // Runs what is queued, then stops the workers.
+  ~InferenceServer();
+
+  InferenceServer(const InferenceServer &) = delete;
+  InferenceServer &operator=(const InferenceServer &) = delete;
+
+  // x holds InputDim() values; the future receives OutputDim() logits.
+  std::future<std::vector<float>> Submit(std::span<const float> x);
+
+  std::size_t InputDim() const noexcept { return m_Model.InputDim(); }
+  std::size_t OutputDim() const noexcept { return m_Model.OutputDim(); }
+  const ServerOptions &options() const noexcept { return m_Options; }
+  Stats stats() const noexcept {
+    return {m_Requests.load(std::memory_order_relaxed),
+            m_Batches.load(std::memory_order_relaxed)};
+  }
+
+private:
+  struct Request {
+    std::vector<float> x;
+    std::promise<std::vector<float>> result;
+    std::chrono::steady_clock::time_point arrival;
+  };
+  struct Workspace {
+    linalg::Matrix<float> X, Y;
+    NeuralNet::Sequential<float>::InferenceScratch scratch;
+  };
+
+  void WorkerMain(std::size_t w);
+  // One forward over the batch, then every promise fulfilled.
+  void Run(Workspace &ws, std::vector<Request> &batch);
+
+  const NeuralNet::Sequential<float> &m_Model;
+  ServerOptions m_Options;
+
+  std::mutex m_Mutex;
+  std::condition_variable m_Arrived;
+  std::deque<Request> m_Queue; // guarded by m_Mutex
+  bool m_Stop = false;         // guarded by m_Mutex
+
+  std::atomic<std::uint64_t> m_Requests{0}, m_Batches{0};
+  std::vector<std::unique_ptr<Workspace>> m_Workspaces;
+  std::vector<std::thread> m_Workers;
+};
+} // namespace Logos::Serving
@@ -0,0 +1,169 @@
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "Serving/SocketServer.hpp"
+
+namespace Logos::Serving {
+
+#if !defined(_WIN32)
+namespace {
+
+sockaddr_un Address(const std::string &path) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path))
+    throw std::runtime_error("Socket path too long: " + path);
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  return addr;
+}
+
+// Whole-buffer send/receive; false once the peer has gone.
+bool SendAll(int fd, const void *data, std::size_t bytes) {
+  const auto *p = static_cast<const char *>(data);
+  while (bytes) {
+    const ssize_t n = ::send(fd, p, bytes, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+    p += n;
+    bytes -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+bool ReceiveAll(int fd, void *data, std::size_t bytes) {
+  auto *p = static_cast<char *>(data);
+  while (bytes) {
+    const ssize_t n = ::recv(fd, p, bytes, 0);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+    p += n;
+    bytes -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+} // namespace
+
+SocketServer::SocketServer(InferenceServer &engine, std::string path)
+    : m_Engine(engine), m_Path(std::move(path)) {
+  const sockaddr_un addr = Address(m_Path);
+  m_Listen = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (m_Listen < 0)
+    throw std::runtime_error("socket failed");
+
+  ::unlink(m_Path.c_str());
+  if (::bind(m_Listen, reinterpret_cast<const sockaddr *>(&addr),
+             sizeof(addr)) != 0 ||
+      ::listen(m_Listen, SOMAXCONN) != 0) {
+    ::close(m_Listen);
+    throw std::runtime_error("Cannot listen on " + m_Path + ": " +
+                             std::strerror(errno));
+  }
+  m_Acceptor = std::thread([this] { AcceptMain(); });
+}
+
+SocketServer::~SocketServer() { Stop(); }
+
+void SocketServer::Stop() {
+  if (m_Stop.exchange(true))
+    return;
+
+  // Wakes accept() and every blocked recv(); the threads then exit.
+  ::shutdown(m_Listen, SHUT_RDWR);
+  m_Acceptor.join();
+  ::close(m_Listen);
+  std::unique_lock lock(m_Mutex);
+  for (const int fd : m_Fds)
+    ::shutdown(fd, SHUT_RDWR);
+  m_Closed.wait(lock, [&] { return m_Fds.empty(); });
+  ::unlink(m_Path.c_str());
+}
+
+void SocketServer::AcceptMain() {
+  while (!m_Stop.load()) {
+    const int fd = ::accept(m_Listen, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      return;
+    }
+    std::lock_guard lock(m_Mutex);
+    if (m_Stop.load()) {
+      ::close(fd);
+      return;
+    }
+    m_Fds.push_back(fd);
+    std::thread([this, fd] { Serve(fd); }).detach();
+    m_Accepted.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void SocketServer::Serve(int fd) {
+  std::vector<float> x(m_Engine.InputDim());
+  const std::size_t reply = m_Engine.OutputDim() * sizeof(float);
+  try {
+    while (ReceiveAll(fd, x.data(), x.size() * sizeof(float))) {
+      const std::vector<float> logits = m_Engine.Submit(x).get();
+      if (!SendAll(fd, logits.data(), reply))
+        break;
+    }
+  } catch (...) {
+    // A failed request ends its connection; the client sees it closed.
+  }
+
+  std::lock_guard lock(m_Mutex);
+  std::erase(m_Fds, fd);
+  ::close(fd);
+  m_Closed.notify_all();
+}
+
+SocketClient::SocketClient(const std::string &path) {
+  const sockaddr_un addr = Address(path);
+  m_Fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (m_Fd < 0 || ::connect(m_Fd, reinterpret_cast<const sockaddr *>(&addr),
+                            sizeof(addr)) != 0) {
+    if (m_Fd >= 0)
+      ::close(m_Fd);
+    throw std::runtime_error("Cannot connect to " + path);
+  }
+}
+
+SocketClient::~SocketClient() {
+  if (m_Fd >= 0)
+    ::close(m_Fd);
+}
+
+void SocketClient::Infer(std::span<const float> x, std::span<float> logits) {
+  if (!SendAll(m_Fd, x.data(), x.size_bytes()) ||
+      !ReceiveAll(m_Fd, logits.data(), logits.size_bytes()))
+    throw std::runtime_error("SocketClient: connection closed");
+}
+
+#else
+SocketServer::SocketServer(InferenceServer &engine, std::string path)
+    : m_Engine(engine), m_Path(std::move(path)) {
+  throw std::runtime_error("SocketServer needs Unix domain sockets");
+}
+SocketServer::~SocketServer() = default;
+void SocketServer::Stop() {}
+void SocketServer::AcceptMain() {}
+void SocketServer::Serve(int) {}
+
+SocketClient::SocketClient(const std::string &) {
+  throw std::runtime_error("SocketClient needs Unix domain sockets");
+}
+SocketClient::~SocketClient() = default;
+void SocketClient::Infer(std::span<const float>, std::span<float>) {}
+#endif
+} // namespace Logos::Serving
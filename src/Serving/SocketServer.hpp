@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Serving/InferenceServer.hpp"
+
+namespace Logos::Serving {
+
+// Local front end of an InferenceServer on a Unix stream socket (POSIX
+// only). The protocol is raw float32 in host byte order: a client writes
+// InputDim() values per request and reads OutputDim() logits per reply, in
+// order. Each connection has one request in flight at a time and its own
+// thread, so concurrent clients are what the server batches together.
+class SocketServer {
+public:
+  // Listens at `path`, replacing a stale socket file there.
+  SocketServer(InferenceServer &engine, std::string path);
+  ~SocketServer();
+
+  SocketServer(const SocketServer &) = delete;
+  SocketServer &operator=(const SocketServer &) = delete;
+
+  // Closes the socket and every connection and removes the socket file.
+  void Stop();
+
+  const std::string &path() const noexcept { return m_Path; }
+  std::size_t connections() const noexcept {
+    return m_Accepted.load(std::memory_order_relaxed);
+  }
+
+private:
+  void AcceptMain();
+  void Serve(int fd);
+
+  InferenceServer &m_Engine;
+  std::string m_Path;
+  int m_Listen = -1;
+  std::atomic<bool> m_Stop{false};
+  std::atomic<std::size_t> m_Accepted{0};
+  std::thread m_Acceptor;
+
+  // Open connections, each served by a detached thread that removes its
+  // descriptor on exit. Guarded by m_Mutex.
+  std::mutex m_Mutex;
+  std::condition_variable m_Closed;
+  std::vector<int> m_Fds;
+};
+
+// Blocking client of a SocketServer.
+class SocketClient {
+public:
+  explicit SocketClient(const std::string &path);
+  ~SocketClient();
+
+  SocketClient(const SocketClient &) = delete;
+  SocketClient &operator=(const SocketClient &) = delete;
+
+  // Sends x and waits for its logits.
+  void Infer(std::span<const float> x, std::span<float> logits);
+
+private:
+  int m_Fd = -1;
+};
+} // namespace Logos::Serving
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "Functions.hpp"
+#include "Kernels/FixedLinear.hpp"
+#include "Linear.hpp"
+#include "Sequential.hpp"
+
+namespace Logos::NeuralNet {
+// Inference-only In -> Hidden (ReLU) -> Classes MLP with its shape in the
+// type. Both layers run through linalg::fixed_linear, so every loop bound
+// and register tile is a compile-time constant. Use it to serve a fixed
+// model trained through the dynamic path: CopyParametersFrom takes the
+// weights of a Sequential with the same shape, e.g. MakeMLP(In, Hidden,
+// Classes).
+//
+// Meant for small batches, where the general GEMM's packing and shape
+// dispatch cost as much as the arithmetic. From a few dozen rows on, the
+// general GEMM catches up (StaticMLPBench).
+template <std::size_t In, std::size_t Hidden, std::size_t Classes>
+class StaticMLP {
+public:
+  static constexpr std::size_t INPUT = In, HIDDEN = Hidden, CLASSES = Classes;
+
+  StaticMLP()
+      : m_W1(In, Hidden), m_W2(Hidden, Classes), m_b1(Hidden), m_b2(Classes) {
+  }
+
+  // Initialised like MakeMLP(In, Hidden, Classes, rng) from the same rng.
+  explicit StaticMLP(std::mt19937 &rng) : StaticMLP() {
+    Linear<float> fc1(In, Hidden, rng), fc2(Hidden, Classes, rng);
+    CopyParameters({fc1.Weights(), fc1.Bias(), fc2.Weights(), fc2.Bias()});
+  }
+
+  // Takes the parameters of a Sequential In -> Hidden -> ReLU -> Classes.
+  void CopyParametersFrom(Sequential<float> &model) {
+    if (model.InputDim() != In || model.OutputDim() != Classes)
+      throw std::logic_error("StaticMLP: model shape mismatch");
+    CopyParameters(model.Parameters());
+  }
+
+  // out = logits of X, rows x Classes.
+  void Forward(linalg::ConstMatrixView<float> X, linalg::Matrix<float> &out) {
+    if (X.cols() != In)
+      throw std::logic_error("StaticMLP: input width mismatch");
+    const auto N = X.rows();
+    if (out.rows() != N || out.cols() != Classes)
+      out = linalg::Matrix<float>(N, Classes);
+    if (m_H.rows() < N)
+      m_H = linalg::Matrix<float>(N, Hidden);
+
+    linalg::fixed_linear<In, Hidden, true>(X.data(), X.leading_dim(), N,
+                                           m_W1.data(), m_b1.data(),
+                                           m_H.data(), Hidden);
+    linalg::fixed_linear<Hidden, Classes>(m_H.data(), Hidden, N, m_W2.data(),
+                                          m_b2.data(), out.data(),
+                                          out.leading_dim());
+  }
+
+  double Accuracy(linalg::ConstMatrixView<float> X,
+                  std::span<const std::uint8_t> labels) {
+    const auto N = X.rows();
+    if (N != labels.size() || N == 0)
+      throw std::logic_error("StaticMLP::Accuracy wrong Matrix size");
+
+    Forward(X, m_Logits);
+    std::size_t correct = 0;
+    for (std::size_t i = 0; i < N; i++)
+      if (ArgmaxRow<float>(m_Logits, i) == labels[i])
+        correct++;
+    return static_cast<double>(correct) / N;
+  }
+
+private:
+  void CopyParameters(const std::vector<std::span<float>> &src) {
+    const std::vector<std::span<float>> dst = {
+        {m_W1.data(), m_W1.size()}, m_b1, {m_W2.data(), m_W2.size()}, m_b2};
+    if (src.size() != dst.size())
+      throw std::logic_error("StaticMLP: model shape mismatch");
+    for (std::size_t t = 0; t < dst.size(); t++) {
+      if (src[t].size() != dst[t].size())
+        throw std::logic_error("StaticMLP: model shape mismatch");
+      std::copy(src[t].begin(), src[t].end(), dst[t].begin());
+    }
+  }
+
+  linalg::Matrix<float> m_W1, m_W2;
+  std::vector<float> m_b1, m_b2;
+
+  // Hidden activations, at least as many rows as the last batch.
+  linalg::Matrix<float> m_H, m_Logits;
+};
+} // namespace Logos::NeuralNet
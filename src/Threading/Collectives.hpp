@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <span>
+
+#include "Kernels/Simd.hpp"
+#include "Threading/ThreadPool.hpp"
+
+namespace Logos::Threading {
+
+// Collectives over K equally sized float buffers, one per replica. The
+// element range is cut into slices that run on the global pool; each slice
+// walks the whole tree, so every level stays in cache and the summation
+// order only depends on K.
+
+// buffers[0] += buffers[1] + ... + buffers[K - 1], combined pairwise as a
+// binary tree (0 += 1, 2 += 3, ... then 0 += 2, ...).
+inline void TreeReduce(std::span<float *const> buffers, std::size_t n) {
+  const std::size_t K = buffers.size();
+  if (K < 2 || n == 0)
+    return;
+
+  const auto &k = linalg::simd::Kernels();
+  parallel_for(0, n, GrainFor(K), [&](std::size_t b, std::size_t e) {
+    for (std::size_t stride = 1; stride < K; stride *= 2)
+      for (std::size_t i = 0; i + stride < K; i += 2 * stride)
+        k.axpy(1.0f, buffers[i + stride] + b, buffers[i] + b, e - b);
+  });
+}
+
+// buffers[1..K-1] = buffers[0]
+inline void Broadcast(std::span<float *const> buffers, std::size_t n) {
+  const std::size_t K = buffers.size();
+  if (K < 2 || n == 0)
+    return;
+
+  parallel_for(0, n, GrainFor(K), [&](std::size_t b, std::size_t e) {
+    for (std::size_t i = 1; i < K; i++)
+      std::memcpy(buffers[i] + b, buffers[0] + b, (e - b) * sizeof(float));
+  });
+}
+
+// Tree reduction followed by a broadcast: every buffer ends up holding the
+// sum.
+inline void AllReduce(std::span<float *const> buffers, std::size_t n) {
+  TreeReduce(buffers, n);
+  Broadcast(buffers, n);
+}
+} // namespace Logos::Threading
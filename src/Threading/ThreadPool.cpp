@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "ThreadPool.hpp"
+
+namespace Logos::Threading {
+
+struct ThreadPool::Loop {
+  RangeFn fn;
+  const void *ctx;
+  std::size_t grain;
+  std::atomic<std::size_t> remaining;
+};
+
+namespace {
+thread_local bool t_InParallelRegion = false;
+
+void PinCurrentThread(std::size_t cpu) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu % CPU_SETSIZE, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)cpu;
+#endif
+}
+
+std::size_t EnvSize(const char *name, std::size_t fallback) {
+  const char *env = std::getenv(name);
+  if (!env)
+    return fallback;
+  try {
+    return std::stoul(env);
+  } catch (...) {
+    return fallback;
+  }
+}
+
+std::unique_ptr<ThreadPool> &GlobalSlot() {
+  static std::unique_ptr<ThreadPool> pool;
+  return pool;
+}
+
+// Published copy of GlobalSlot() so the hot path is one load; the first
+// callers of Global() may race, so creation happens under the mutex.
+std::atomic<ThreadPool *> s_Global{nullptr};
+std::mutex s_GlobalMutex;
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t num_threads, bool pin_threads) {
+  if (num_threads == 0)
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  const std::size_t workers = num_threads - 1;
+  m_Queues.reserve(EXTERNAL_QUEUES + workers);
+  for (std::size_t i = 0; i < EXTERNAL_QUEUES + workers; i++)
+    m_Queues.push_back(std::make_unique<Queue>());
+
+  m_Workers.reserve(workers);
+  for (std::size_t i = 0; i < workers; i++)
+    m_Workers.emplace_back([this, i, pin_threads] {
+      if (pin_threads)
+        PinCurrentThread(i + 1);
+      WorkerMain(i);
+    });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(m_SleepMutex);
+    m_Stop.store(true);
+  }
+  m_WakeUp.notify_all();
+  for (auto &t : m_Workers)
+    t.join();
+}
+
+ThreadPool &ThreadPool::Global() {
+  if (auto *pool = s_Global.load(std::memory_order_acquire))
+    return *pool;
+
+  std::lock_guard lock(s_GlobalMutex);
+  auto &pool = GlobalSlot();
+  if (!pool) {
+    pool = std::make_unique<ThreadPool>(EnvSize("LOGOS_NUM_THREADS", 0),
+                                        EnvSize("LOGOS_PIN_THREADS", 0) != 0);
+    s_Global.store(pool.get(), std::memory_order_release);
+  }
+  return *pool;
+}
+
+void ThreadPool::ResetGlobal(std::size_t num_threads, bool pin_threads) {
+  std::lock_guard lock(s_GlobalMutex);
+  auto &pool = GlobalSlot();
+  s_Global.store(nullptr, std::memory_order_release);
+  pool.reset();
+  pool = std::make_unique<ThreadPool>(num_threads, pin_threads);
+  s_Global.store(pool.get(), std::memory_order_release);
+}
+
+bool ThreadPool::InParallelRegion() noexcept { return t_InParallelRegion; }
+
+void ThreadPool::Queue::push_back(const Task &task) {
+  if (count == ring.size()) {
+    std::vector<Task> grown(ring.size() * 2);
+    for (std::size_t i = 0; i < count; i++)
+      grown[i] = ring[(head + i) & (ring.size() - 1)];
+    ring.swap(grown);
+    head = 0;
+  }
+  ring[(head + count) & (ring.size() - 1)] = task;
+  count++;
+}
+
+void ThreadPool::ParallelFor(std::size_t begin, std::size_t end,
+                             std::size_t grain, RangeFn fn, const void *ctx) {
+  if (end <= begin)
+    return;
+  if (t_InParallelRegion) {
+    fn(ctx, begin, end);
+    return;
+  }
+
+  std::size_t queue;
+  if (!ClaimExternalQueue(queue)) {
+    t_InParallelRegion = true;
+    fn(ctx, begin, end);
+    t_InParallelRegion = false;
+    return;
+  }
+
+  Loop loop{fn, ctx, grain == 0 ? 1 : grain, end - begin};
+
+  // The caller starts on the whole range itself; the halves it splits off
+  // go to its queue for the workers to steal. Its queue only ever holds
+  // this loop's tasks, and it steals back nothing else.
+  t_InParallelRegion = true;
+  Execute({&loop, begin, end}, queue);
+
+  Task task;
+  while (loop.remaining.load(std::memory_order_acquire) != 0) {
+    if (TryPop(queue, task) || TrySteal(queue, task, &loop))
+      Execute(task, queue);
+    else
+      std::this_thread::yield();
+  }
+  t_InParallelRegion = false;
+  m_Queues[queue]->claimed.store(false, std::memory_order_release);
+}
+
+bool ThreadPool::ClaimExternalQueue(std::size_t &queue) noexcept {
+  for (queue = 0; queue < EXTERNAL_QUEUES; queue++) {
+    auto &claimed = m_Queues[queue]->claimed;
+    if (!claimed.load(std::memory_order_relaxed) &&
+        !claimed.exchange(true, std::memory_order_acquire))
+      return true;
+  }
+  return false;
+}
+
+void ThreadPool::Execute(Task task, std::size_t queue) {
+  Loop &loop = *task.loop;
+  while (task.end - task.begin > loop.grain) {
+    const std::size_t mid = task.begin + (task.end - task.begin) / 2;
+    Push(queue, {task.loop, mid, task.end});
+    task.end = mid;
+  }
+
+  loop.fn(loop.ctx, task.begin, task.end);
+  loop.remaining.fetch_sub(task.end - task.begin, std::memory_order_acq_rel);
+}
+
+void ThreadPool::Push(std::size_t queue, const Task &task) {
+  {
+    std::lock_guard lock(m_Queues[queue]->mutex);
+    m_Queues[queue]->push_back(task);
+  }
+  m_Queued.fetch_add(1, std::memory_order_release);
+  // A worker between its predicate check and wait() holds m_SleepMutex;
+  // taking it here means the notify cannot fall into that gap.
+  { std::lock_guard lock(m_SleepMutex); }
+  m_WakeUp.notify_one();
+}
+
+// Owners take the most recently split (smallest, cache-warm) half.
+bool ThreadPool::TryPop(std::size_t queue, Task &task) {
+  auto &q = *m_Queues[queue];
+  std::lock_guard lock(q.mutex);
+  if (q.empty())
+    return false;
+  task = q.pop_back();
+  m_Queued.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+// Thieves take the oldest (largest) half from the front of another queue.
+bool ThreadPool::TrySteal(std::size_t thief, Task &task, const Loop *only) {
+  const std::size_t n = m_Queues.size();
+  for (std::size_t k = 1; k <= n; k++) {
+    auto &q = *m_Queues[(thief + k) % n];
+    std::lock_guard lock(q.mutex);
+    if (q.empty() || (only && q.ring[q.head].loop != only))
+      continue;
+    task = q.pop_front();
+    m_Queued.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::WorkerMain(std::size_t index) {
+  const std::size_t queue = EXTERNAL_QUEUES + index;
+  t_InParallelRegion = true;
+
+  Task task;
+  while (true) {
+    if (TryPop(queue, task) || TrySteal(queue, task)) {
+      Execute(task, queue);
+      continue;
+    }
+
+    std::unique_lock lock(m_SleepMutex);
+    m_WakeUp.wait(lock, [this] {
+      return m_Stop.load() || m_Queued.load(std::memory_order_acquire) != 0;
+    });
+    if (m_Stop.load())
+      return;
+  }
+}
+} // namespace Logos::Threading
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Logos::Threading {
+
+// Work-stealing pool. ParallelFor hands out one range, which is split
+// recursively in halves: a thread keeps working on the lower half and pushes
+// the upper half onto its own deque, where idle threads steal it from the
+// opposite end. The calling thread works alongside the pool until the loop is
+// done, so a pool of N threads has N - 1 workers.
+//
+// Several threads may run loops at once, e.g. training and a background
+// evaluation. Each caller splits into a queue of its own and, while it
+// waits, only runs tasks of its own loop, so one caller never ends up
+// executing another's work. Callers beyond EXTERNAL_QUEUES at a time run
+// their loops alone on their own thread.
+class ThreadPool {
+public:
+  // Range body: called with [begin, end) chunks of at most `grain` items.
+  using RangeFn = void (*)(const void *ctx, std::size_t begin, std::size_t end);
+
+  // num_threads == 0 picks std::thread::hardware_concurrency(). With
+  // pin_threads, worker i is bound to CPU i + 1 (the caller keeps CPU 0).
+  explicit ThreadPool(std::size_t num_threads = 0, bool pin_threads = false);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  static constexpr std::size_t EXTERNAL_QUEUES = 8;
+
+  // Threads taking part in a ParallelFor, including the caller.
+  std::size_t size() const noexcept { return m_Workers.size() + 1; }
+
+  // Blocks until fn has covered [begin, end). fn must not throw. Calls made
+  // from inside a pool task run inline on that thread, so nested loops never
+  // oversubscribe.
+  void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                   RangeFn fn, const void *ctx);
+
+  // Process-wide pool used by the kernels. Sized from LOGOS_NUM_THREADS
+  // (default: all hardware threads); LOGOS_PIN_THREADS=1 enables pinning.
+  // Created on first use; safe to call from any thread.
+  static ThreadPool &Global();
+  // Replace the global pool. Not safe while another thread is using it,
+  // including calling Global(): references it returned are destroyed.
+  static void ResetGlobal(std::size_t num_threads, bool pin_threads = false);
+
+  // True on pool workers and while the calling thread runs a loop body.
+  static bool InParallelRegion() noexcept;
+
+private:
+  struct Loop;
+  struct Task {
+    Loop *loop;
+    std::size_t begin, end;
+  };
+  // Double-ended ring of tasks. Capacity doubles when full and is never
+  // given back, so a warmed-up pool pushes and steals without allocating
+  // (std::deque frees and reallocates blocks as the front advances).
+  struct Queue {
+    std::mutex mutex;
+    std::vector<Task> ring = std::vector<Task>(64);
+    std::size_t head = 0, count = 0;
+    // External queues only: held by a thread inside ParallelFor.
+    std::atomic<bool> claimed{false};
+
+    bool empty() const noexcept { return count == 0; }
+    void push_back(const Task &task);
+    Task pop_back() noexcept {
+      count--;
+      return ring[(head + count) & (ring.size() - 1)];
+    }
+    Task pop_front() noexcept {
+      const Task task = ring[head];
+      head = (head + 1) & (ring.size() - 1);
+      count--;
+      return task;
+    }
+  };
+
+  void WorkerMain(std::size_t index);
+  void Execute(Task task, std::size_t queue);
+  bool TryPop(std::size_t queue, Task &task);
+  // With `only`, takes nothing but tasks of that loop.
+  bool TrySteal(std::size_t thief, Task &task, const Loop *only = nullptr);
+  bool ClaimExternalQueue(std::size_t &queue) noexcept;
+  void Push(std::size_t queue, const Task &task);
+
+  // m_Queues[0, EXTERNAL_QUEUES) are claimed by external callers for the
+  // duration of a loop, m_Queues[EXTERNAL_QUEUES + i] belongs to worker i.
+  std::vector<std::unique_ptr<Queue>> m_Queues;
+  std::vector<std::thread> m_Workers;
+
+  std::mutex m_SleepMutex;
+  std::condition_variable m_WakeUp;
+  std::atomic<std::size_t> m_Queued{0};
+  std::atomic<bool> m_Stop{false};
+};
+
+// Grain so that each chunk carries roughly `min_work` units of work when one
+// item costs `work_per_item`. Tiny problems end up as one chunk and never
+// leave the calling thread.
+inline std::size_t GrainFor(std::size_t work_per_item,
+                            std::size_t min_work = std::size_t{1} << 15) {
+  if (work_per_item == 0)
+    work_per_item = 1;
+  return (min_work + work_per_item - 1) / work_per_item;
+}
+
+// parallel_for(begin, end, grain, [&](std::size_t b, std::size_t e) {...})
+// on the global pool. Runs inline when the range fits in a single chunk.
+template <class Fn>
+inline void parallel_for(std::size_t begin, std::size_t end, std::size_t grain,
+                         const Fn &fn) {
+  if (grain == 0)
+    grain = 1;
+  if (end <= begin)
+    return;
+  if (end - begin <= grain || ThreadPool::InParallelRegion()) {
+    fn(begin, end);
+    return;
+  }
+
+  auto &pool = ThreadPool::Global();
+  if (pool.size() == 1) {
+    fn(begin, end);
+    return;
+  }
+
+  pool.ParallelFor(
+      begin, end, grain,
+      [](const void *ctx, std::size_t b, std::size_t e) {
+        (*static_cast<const Fn *>(ctx))(b, e);
+      },
+      &fn);
+}
+} // namespace Logos::Threading
@@ -1,6 +1,83 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+
 #include "NeuralNetwork.hpp"
 
-int main() {
-  Logos::NeuralNet::TrainModel model;
+int main(int argc, char **argv) {
+  using namespace Logos::NeuralNet;
+
+  TrainOptions options;
+  for (int i = 1; i < argc; i++) {
+    const std::string_view arg = argv[i];
+    if (arg == "--data-parallel")
+      options.mode = TrainMode::DataParallel;
+    else if (arg == "--hogwild")
+      options.mode = TrainMode::Hogwild;
+    else if (arg.starts_with("--batch="))
+      options.batch_size = std::stoul(std::string(arg.substr(8)));
+    else if (arg.starts_with("--replicas="))
+      options.replicas = std::stoul(std::string(arg.substr(11)));
+    else if (arg.starts_with("--prefetch="))
+      options.prefetch = std::stoul(std::string(arg.substr(11)));
+    else if (arg == "--augment")
+      options.augment = true;
+    else if (arg == "--verify-data")
+      options.verify_data = true;
+    else if (arg == "--normalize")
+      options.normalize = true;
+    else if (arg == "--math=exact")
+      options.math = MathMode::Exact;
+    else if (arg == "--math=accurate")
+      options.math = MathMode::Accurate;
+    else if (arg == "--math=fast")
+      options.math = MathMode::Fast;
+    else if (arg == "--optimizer=sgd")
+      options.optimizer.kind = OptimizerKind::SGD;
+    else if (arg == "--optimizer=momentum")
+      options.optimizer.kind = OptimizerKind::Momentum;
+    else if (arg == "--optimizer=nesterov")
+      options.optimizer.kind = OptimizerKind::Nesterov;
+    else if (arg == "--optimizer=adam")
+      options.optimizer.kind = OptimizerKind::Adam;
+    else if (arg == "--optimizer=adamw")
+      options.optimizer.kind = OptimizerKind::AdamW;
+    else if (arg.starts_with("--lr="))
+      options.learning_rate = std::stod(std::string(arg.substr(5)));
+    else if (arg.starts_with("--momentum="))
+      options.optimizer.momentum = std::stof(std::string(arg.substr(11)));
+    else if (arg.starts_with("--weight-decay="))
+      options.optimizer.weight_decay = std::stof(std::string(arg.substr(15)));
+    else if (arg == "--precision=f32")
+      options.precision = Logos::linalg::Precision::F32;
+    else if (arg == "--precision=bf16")
+      options.precision = Logos::linalg::Precision::BF16;
+    else if (arg == "--precision=f16")
+      options.precision = Logos::linalg::Precision::F16;
+    else if (arg == "--quantize")
+      options.quantize = true;
+    else if (arg.starts_with("--checkpoint="))
+      options.checkpoint = arg.substr(13);
+    else if (arg.starts_with("--resume="))
+      options.resume = arg.substr(9);
+    else if (arg.starts_with("--load="))
+      options.load = arg.substr(7);
+    else if (arg.starts_with("--serve="))
+      options.serve = arg.substr(8);
+    else {
+      std::cerr << "usage: Logos [--data-parallel | --hogwild] [--batch=N] "
+                   "[--replicas=K] [--prefetch=D] [--augment] "
+                   "[--verify-data] [--normalize] "
+                   "[--math=exact|accurate|fast] "
+                   "[--optimizer=sgd|momentum|nesterov|adam|adamw] "
+                   "[--lr=X] [--momentum=X] [--weight-decay=X] "
+                   "[--precision=f32|bf16|f16] [--quantize] "
+                   "[--checkpoint=PATH] [--resume=PATH | --load=PATH] "
+                   "[--serve=SOCKET]\n";
+      return 1;
+    }
+  }
+
+  TrainModel model(options);
   model.run();
 }
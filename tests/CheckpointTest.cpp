@@ -0,0 +1,69 @@
+// Checkpoint files: a header whose section bounds wrap around 64 bits must
+// be rejected on open, not mapped past the end of the file.
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Checkpoint.hpp"
+#include "TestCommon.hpp"
+
+namespace NN = Logos::NeuralNet;
+
+namespace {
+std::vector<char> read_file(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), {}};
+}
+
+void write_file(const std::string &path, const std::vector<char> &bytes) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+bool opens(const std::string &path) {
+  try {
+    NN::MappedCheckpoint::Open(path);
+    return true;
+  } catch (const std::runtime_error &) {
+    return false;
+  }
+}
+} // namespace
+
+int main() {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "CheckpointTest.lgc").string();
+
+  std::mt19937 rng(22);
+  NN::Sequential<float> model(8);
+  model.AddLinear(4, rng).AddReLU().AddLinear(3, rng).Build();
+  NN::SaveCheckpoint(path, model, NN::TrainingState{});
+  LOGOS_CHECK(opens(path));
+  const auto good = read_file(path);
+
+  // offset + bytes wraps to a small number that passes a naive check.
+  NN::CheckpointHeader h;
+  std::memcpy(&h, good.data(), sizeof(h));
+  h.rng.bytes = UINT64_MAX - h.rng.offset + 2;
+  auto bad = good;
+  std::memcpy(bad.data(), &h, sizeof(h));
+  write_file(path, bad);
+  LOGOS_CHECK(!opens(path));
+
+  // An offset past the end, with no bytes.
+  std::memcpy(&h, good.data(), sizeof(h));
+  h.state.offset = (good.size() / h.alignment + 1) * h.alignment;
+  h.state.bytes = 0;
+  std::memcpy(bad.data(), &h, sizeof(h));
+  write_file(path, bad);
+  LOGOS_CHECK(!opens(path));
+
+  std::filesystem::remove(path);
+}
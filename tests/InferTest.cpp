@@ -0,0 +1,55 @@
+// Sequential::Infer against Forward on fused, unfused and bf16 models: the
+// logits must be identical, whichever buffers Infer reuses (an unfused
+// ReLU runs in place) and however the batch size changes between calls on
+// one scratch.
+
+#include <random>
+
+#include "Sequential.hpp"
+#include "TestCommon.hpp"
+
+namespace NN = Logos::NeuralNet;
+namespace linalg = Logos::linalg;
+
+namespace {
+constexpr std::size_t INPUT = 64, HIDDEN = 48, CLASSES = 10, ROWS = 200;
+
+NN::Sequential<float> build(bool fuse, linalg::Precision precision,
+                            bool relu_last) {
+  std::mt19937 rng(24);
+  NN::Sequential<float> model(INPUT);
+  model.AddLinear(HIDDEN, rng).AddReLU().AddLinear(HIDDEN / 2, rng).AddReLU();
+  model.AddLinear(CLASSES, rng);
+  if (relu_last)
+    model.AddReLU();
+  model.Build(fuse);
+  model.SetPrecision(precision);
+  return model;
+}
+} // namespace
+
+int main() {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> ud(-1.0f, 1.0f);
+  linalg::Matrix<float> X(ROWS, INPUT), forward;
+  for (std::size_t i = 0; i < X.size(); i++)
+    X.data()[i] = ud(rng);
+  const linalg::ConstMatrixView<float> all(X);
+
+  for (const bool fuse : {true, false})
+    for (const auto precision :
+         {linalg::Precision::F32, linalg::Precision::BF16})
+      for (const bool relu_last : {false, true}) {
+        auto model = build(fuse, precision, relu_last);
+        NN::Sequential<float>::InferenceScratch scratch;
+        for (const std::size_t rows : {ROWS, std::size_t{1}, std::size_t{37}}) {
+          const auto x = all.row_range(0, rows);
+          model.Forward(x, forward);
+          const auto logits = model.Infer(x, scratch);
+          LOGOS_CHECK(logits.rows() == rows && logits.cols() == CLASSES);
+          for (std::size_t i = 0; i < rows; i++)
+            for (std::size_t j = 0; j < CLASSES; j++)
+              LOGOS_CHECK(logits(i, j) == forward(i, j));
+        }
+      }
+}
@@ -0,0 +1,75 @@
+// SoftmaxCrossEntropy over many more rows than one loss block, on several
+// pool threads and from two callers at once: the loss must match a serial
+// double-precision reference and not depend on the thread count.
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Functions.hpp"
+#include "TestCommon.hpp"
+#include "Threading/ThreadPool.hpp"
+
+namespace NN = Logos::NeuralNet;
+namespace linalg = Logos::linalg;
+
+namespace {
+constexpr std::size_t N = 20000, M = 10;
+
+double reference(const linalg::Matrix<float> &logits,
+                 const std::vector<std::uint8_t> &labels) {
+  double sum = 0.0;
+  for (std::size_t i = 0; i < N; i++) {
+    const float *x = logits.data() + i * M;
+    double maxv = x[0], z = 0.0;
+    for (std::size_t j = 1; j < M; j++)
+      maxv = std::max<double>(maxv, x[j]);
+    for (std::size_t j = 0; j < M; j++)
+      z += std::exp(x[j] - maxv);
+    sum += maxv + std::log(z) - x[labels[i]];
+  }
+  return sum / N;
+}
+
+float loss(const linalg::Matrix<float> &logits,
+           const std::vector<std::uint8_t> &labels) {
+  linalg::Matrix<float> grad;
+  return NN::SoftmaxCrossEntropy<float>(logits, labels, grad);
+}
+} // namespace
+
+int main() {
+  // Several blocks, so several threads write their partial sums.
+  LOGOS_CHECK(N > 4 * Logos::Threading::GrainFor(M));
+
+  std::mt19937 rng(10);
+  std::normal_distribution<float> nd(0.0f, 3.0f);
+  linalg::Matrix<float> logits(N, M);
+  for (std::size_t i = 0; i < logits.size(); i++)
+    logits.data()[i] = nd(rng);
+  std::vector<std::uint8_t> labels(N);
+  for (auto &y : labels)
+    y = static_cast<std::uint8_t>(rng() % M);
+  const double expected = reference(logits, labels);
+
+  Logos::Threading::ThreadPool::ResetGlobal(1);
+  const float serial = loss(logits, labels);
+  LOGOS_CHECK_NEAR(serial, expected, 1e-4);
+
+  Logos::Threading::ThreadPool::ResetGlobal(4);
+  for (int r = 0; r < 20; r++)
+    LOGOS_CHECK(loss(logits, labels) == serial);
+
+  // Two external callers sharing the pool.
+  float a = 0.0f, b = 0.0f;
+  std::thread other([&] {
+    for (int r = 0; r < 20; r++)
+      a = loss(logits, labels);
+  });
+  for (int r = 0; r < 20; r++)
+    b = loss(logits, labels);
+  other.join();
+  LOGOS_CHECK(a == serial && b == serial);
+}
@@ -0,0 +1,81 @@
+// Int8 inference on every SIMD tier the CPU has. A model calibrated for
+// 0..127 must give identical logits on all of them; one calibrated for
+// 0..255 identical logits on every tier whose int8 GEMM takes the full
+// range, and be refused by the others. The wider range must not be less
+// accurate against fp32.
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "NeuralNetwork.hpp"
+#include "QuantizedMLP.hpp"
+#include "TestCommon.hpp"
+
+namespace NN = Logos::NeuralNet;
+namespace simd = Logos::linalg::simd;
+using Logos::linalg::Matrix;
+
+namespace {
+constexpr std::size_t IN = 784, HIDDEN = 256, CLASSES = 10, ROWS = 512;
+
+bool same(const Matrix<float> &a, const Matrix<float> &b) {
+  for (std::size_t i = 0; i < a.size(); i++)
+    if (a.data()[i] != b.data()[i])
+      return false;
+  return a.size() == b.size();
+}
+
+double rms_error(const Matrix<float> &a, const Matrix<float> &b) {
+  double sum = 0.0;
+  for (std::size_t i = 0; i < a.size(); i++) {
+    const double d = a.data()[i] - b.data()[i];
+    sum += d * d;
+  }
+  return std::sqrt(sum / a.size());
+}
+
+void fill(Matrix<float> &m, std::mt19937 &rng) {
+  std::uniform_real_distribution<float> pixel(0.0f, 1.0f);
+  for (std::size_t i = 0; i < m.size(); i++)
+    m.data()[i] = pixel(rng);
+}
+} // namespace
+
+int main() {
+  std::mt19937 rng(21);
+  auto model = NN::MakeMLP(IN, HIDDEN, CLASSES, rng);
+  Matrix<float> calibration(ROWS, IN), X(ROWS, IN), fp32;
+  fill(calibration, rng);
+  fill(X, rng);
+  model.Forward(X, fp32);
+
+  simd::ForceTier(simd::Tier::Scalar);
+  LOGOS_CHECK(simd::Kernels().qgemm_act_max() == simd::QGEMM_ACT_MAX);
+  NN::QuantizedMLP wide(model, calibration, simd::QGEMM_ACT_MAX),
+      narrow(model, calibration, simd::QGEMM_ACT_MAX_MADD);
+  Matrix<float> wide_ref, narrow_ref, out;
+  wide.Forward(X, wide_ref);
+  narrow.Forward(X, narrow_ref);
+  LOGOS_CHECK(rms_error(wide_ref, fp32) <= rms_error(narrow_ref, fp32));
+
+  for (int t = 0; t <= static_cast<int>(simd::DetectedTier()); t++) {
+    simd::ForceTier(static_cast<simd::Tier>(t));
+    narrow.Forward(X, out);
+    LOGOS_CHECK(same(out, narrow_ref));
+
+    if (simd::Kernels().qgemm_act_max() == simd::QGEMM_ACT_MAX) {
+      wide.Forward(X, out);
+      LOGOS_CHECK(same(out, wide_ref));
+    } else {
+      bool refused = false;
+      try {
+        wide.Forward(X, out);
+      } catch (const std::logic_error &) {
+        refused = true;
+      }
+      LOGOS_CHECK(refused);
+    }
+  }
+  simd::ForceTier(simd::DetectedTier());
+}
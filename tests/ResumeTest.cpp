@@ -0,0 +1,97 @@
+// Training interrupted after a checkpoint and resumed from it must end with
+// the weights of an uninterrupted run. The loop is TrainModel::run's: a
+// BatchPipeline with augmentation whose epochs are seeded from the trainer
+// RNG, Adam, a decaying learning rate and a checkpoint after every epoch.
+
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Checkpoint.hpp"
+#include "Data/BatchPipeline.hpp"
+#include "TestCommon.hpp"
+
+namespace Data = Logos::Data;
+namespace NN = Logos::NeuralNet;
+namespace linalg = Logos::linalg;
+
+namespace {
+constexpr std::size_t SIDE = 8, ROWS = 500, CLASSES = 4, BATCH = 32,
+                      EPOCHS = 4, INTERRUPT_AFTER = 2;
+
+struct Trainer {
+  std::mt19937 rng{123};
+  NN::Sequential<float> model{SIDE * SIDE};
+  double lr = 0.01;
+  std::uint64_t first_epoch = 1;
+
+  Trainer() {
+    model.AddLinear(16, rng).AddReLU().AddLinear(CLASSES, rng).Build();
+    model.SetOptimizer({.kind = NN::OptimizerKind::Adam});
+  }
+
+  void Resume(const std::string &path) {
+    const auto file = NN::MappedCheckpoint::Open(path, true);
+    LOGOS_CHECK(file.RestoreInto(model));
+    const NN::TrainingState state = file.training();
+    rng = state.rng;
+    lr = state.learning_rate;
+    first_epoch = state.epoch + 1;
+  }
+
+  // Trains epochs first_epoch..last, checkpointing each to `path`.
+  void Run(const Data::ImageSet &images,
+           const std::vector<std::uint8_t> &labels, std::uint64_t last,
+           const std::string &path) {
+    Data::BatchPipeline loader(images, labels, BATCH, 0, 2,
+                               Data::RandomShift(SIDE, SIDE, 1));
+    for (std::uint64_t ep = first_epoch; ep <= last; ep++) {
+      loader.BeginEpoch(rng());
+      while (const auto *batch = loader.Next())
+        model.TrainStep(batch->X, batch->y, lr);
+      lr *= 0.9;
+      NN::SaveCheckpoint(path, model, {ep, lr, rng});
+    }
+  }
+};
+} // namespace
+
+int main() {
+  std::mt19937 rng(22);
+  std::uniform_real_distribution<float> pixel(0.0f, 1.0f);
+  linalg::Matrix<float> pixels(ROWS, SIDE * SIDE);
+  for (std::size_t i = 0; i < pixels.size(); i++)
+    pixels.data()[i] = pixel(rng);
+  const auto images = Data::ImageSet::View(pixels);
+  std::vector<std::uint8_t> labels(ROWS);
+  for (auto &l : labels)
+    l = static_cast<std::uint8_t>(rng() % CLASSES);
+
+  const auto dir = std::filesystem::temp_directory_path();
+  const std::string whole = (dir / "ResumeTest.whole.lgc").string(),
+                    split = (dir / "ResumeTest.split.lgc").string();
+
+  Trainer uninterrupted;
+  uninterrupted.Run(images, labels, EPOCHS, whole);
+
+  {
+    Trainer interrupted;
+    interrupted.Run(images, labels, INTERRUPT_AFTER, split);
+  }
+  Trainer resumed;
+  resumed.Resume(split);
+  LOGOS_CHECK(resumed.first_epoch == INTERRUPT_AFTER + 1);
+  resumed.Run(images, labels, EPOCHS, split);
+
+  const auto a = uninterrupted.model.FlatParameters();
+  const auto b = resumed.model.FlatParameters();
+  LOGOS_CHECK(a.size() == b.size());
+  for (std::size_t i = 0; i < a.size(); i++)
+    LOGOS_CHECK(a[i] == b[i]);
+  LOGOS_CHECK(uninterrupted.lr == resumed.lr);
+
+  std::filesystem::remove(whole);
+  std::filesystem::remove(split);
+}
@@ -0,0 +1,77 @@
+// Tensor files: a header whose shape size or data end wraps around 64 bits
+// must be rejected on open, not served as rows past the end of the mapping.
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Data/TensorFile.hpp"
+#include "TestCommon.hpp"
+
+namespace Data = Logos::Data;
+
+namespace {
+std::vector<char> read_file(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), {}};
+}
+
+void write_file(const std::string &path, const std::vector<char> &bytes) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+bool opens(const std::string &path) {
+  try {
+    Data::MappedTensor::Open(path);
+    return true;
+  } catch (const std::runtime_error &) {
+    return false;
+  }
+}
+
+// Rewrites the header of `good` through `patch` and tries to open it.
+template <class Patch>
+bool opens_patched(const std::string &path, const std::vector<char> &good,
+                   Patch &&patch) {
+  Data::TensorHeader h;
+  std::memcpy(&h, good.data(), sizeof(h));
+  patch(h);
+  auto bad = good;
+  std::memcpy(bad.data(), &h, sizeof(h));
+  write_file(path, bad);
+  return opens(path);
+}
+} // namespace
+
+int main() {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "TensorFileTest.lgt").string();
+
+  const std::vector<float> values = {1, 2, 3, 4, 5, 6};
+  Data::WriteTensor(path, Data::DType::F32, 2, 3, values.data());
+  LOGOS_CHECK(opens(path));
+  const auto good = read_file(path);
+
+  // rows * cols * 4 wraps to 0, matching an empty data section.
+  LOGOS_CHECK(!opens_patched(path, good, [](Data::TensorHeader &h) {
+    h.rows = std::uint64_t{1} << 62;
+    h.cols = 1;
+    h.data_bytes = 0;
+  }));
+
+  // A consistent shape whose end, data_offset + data_bytes, wraps to 8.
+  LOGOS_CHECK(!opens_patched(path, good, [](Data::TensorHeader &h) {
+    h.dtype = Data::DType::U8;
+    h.rows = UINT64_MAX - h.data_offset + 9;
+    h.cols = 1;
+    h.data_bytes = h.rows;
+  }));
+
+  std::filesystem::remove(path);
+}
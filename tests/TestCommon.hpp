@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// Each file in tests/ is an executable that CTest runs; a failed check
+// prints where and exits non-zero.
+#define LOGOS_CHECK(cond)                                                      \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__,    \
+                   #cond);                                                     \
+      std::exit(1);                                                            \
+    }                                                                          \
+  } while (0)
+
+#define LOGOS_CHECK_NEAR(a, b, tol)                                            \
+  do {                                                                         \
+    const double logos_a = (a), logos_b = (b);                                 \
+    if (!(std::abs(logos_a - logos_b) <= (tol))) {                             \
+      std::fprintf(stderr, "%s:%d: %s = %.9g, %s = %.9g, tolerance %g\n",      \
+                   __FILE__, __LINE__, #a, logos_a, #b, logos_b,               \
+                   static_cast<double>(tol));                                  \
+      std::exit(1);                                                            \
+    }                                                                          \
+  } while (0)
@@ -0,0 +1,49 @@
+// Several threads making their first parallel_for call at the same moment:
+// they must all get the one global pool, created once, and every loop must
+// cover its range exactly once.
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "TestCommon.hpp"
+#include "Threading/ThreadPool.hpp"
+
+namespace Threading = Logos::Threading;
+
+namespace {
+constexpr std::size_t CALLERS = 8, ITEMS = 1024, GRAIN = 16;
+} // namespace
+
+int main() {
+  // No ResetGlobal: the pool must be created by the racing calls below.
+  std::vector<Threading::ThreadPool *> seen(CALLERS);
+  std::vector<std::uint8_t> covered(CALLERS);
+  std::atomic<std::size_t> ready{0};
+  std::vector<std::thread> threads;
+  for (std::size_t c = 0; c < CALLERS; c++)
+    threads.emplace_back([&, c] {
+      ready++;
+      while (ready.load() < CALLERS)
+        std::this_thread::yield();
+
+      std::vector<std::atomic<std::uint8_t>> hits(ITEMS);
+      Threading::parallel_for(0, ITEMS, GRAIN,
+                              [&](std::size_t b, std::size_t e) {
+                                for (std::size_t i = b; i < e; i++)
+                                  hits[i]++;
+                              });
+      seen[c] = &Threading::ThreadPool::Global();
+      covered[c] = 1;
+      for (const auto &h : hits)
+        covered[c] = covered[c] && h.load() == 1;
+    });
+  for (auto &t : threads)
+    t.join();
+
+  for (std::size_t c = 0; c < CALLERS; c++) {
+    LOGOS_CHECK(covered[c]);
+    LOGOS_CHECK(seen[c] == seen[0]);
+  }
+}
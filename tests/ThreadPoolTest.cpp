@@ -0,0 +1,91 @@
+// Several external threads running loops on one pool at once: every loop
+// must cover its range exactly once, and no caller may run a chunk of
+// another caller's loop while it waits for its own (it would stall its own
+// work behind someone else's, e.g. training behind a test-set shard).
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TestCommon.hpp"
+#include "Threading/ThreadPool.hpp"
+
+namespace Threading = Logos::Threading;
+
+namespace {
+constexpr std::size_t ITEMS = 4096, GRAIN = 16, ROUNDS = 50;
+
+// Spins long enough per item for loops on different callers to overlap.
+std::uint64_t work(std::size_t i) {
+  std::uint64_t h = i + 1;
+  for (int k = 0; k < 200; k++)
+    h = h * 6364136223846793005ull + 1442695040888963407ull;
+  return h;
+}
+
+struct Caller {
+  std::thread::id id;
+  std::vector<std::thread::id> ran_on; // thread of every chunk, all rounds
+  bool covered = true;
+};
+
+// `callers` threads each run ROUNDS loops of ITEMS items at the same time.
+std::vector<Caller> run(std::size_t callers) {
+  std::vector<Caller> result(callers);
+  std::atomic<std::size_t> ready{0};
+  std::vector<std::thread> threads;
+  for (std::size_t c = 0; c < callers; c++)
+    threads.emplace_back([&, c] {
+      Caller &me = result[c];
+      me.id = std::this_thread::get_id();
+      ready++;
+      while (ready.load() < callers)
+        std::this_thread::yield();
+
+      std::vector<std::uint8_t> hits(ITEMS);
+      std::vector<std::uint64_t> out(ITEMS);
+      std::mutex mutex;
+      for (std::size_t r = 0; r < ROUNDS; r++) {
+        std::fill(hits.begin(), hits.end(), 0);
+        Threading::parallel_for(0, ITEMS, GRAIN,
+                                [&](std::size_t b, std::size_t e) {
+                                  for (std::size_t i = b; i < e; i++) {
+                                    out[i] = work(i);
+                                    hits[i]++;
+                                  }
+                                  std::lock_guard lock(mutex);
+                                  me.ran_on.push_back(
+                                      std::this_thread::get_id());
+                                });
+        for (std::size_t i = 0; i < ITEMS; i++)
+          me.covered = me.covered && hits[i] == 1 && out[i] == work(i);
+      }
+    });
+  for (auto &t : threads)
+    t.join();
+  return result;
+}
+
+void check(const std::vector<Caller> &callers) {
+  for (const Caller &c : callers) {
+    LOGOS_CHECK(c.covered);
+    for (const Caller &other : callers)
+      if (&other != &c)
+        for (const auto id : c.ran_on)
+          LOGOS_CHECK(id != other.id);
+  }
+}
+} // namespace
+
+int main() {
+  Threading::ThreadPool::ResetGlobal(4);
+  LOGOS_CHECK(Threading::ThreadPool::Global().size() == 4);
+
+  check(run(2));
+  check(run(4));
+  // More callers than the pool has external queues: the rest run alone.
+  check(run(Threading::ThreadPool::EXTERNAL_QUEUES + 3));
+}